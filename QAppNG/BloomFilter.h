@@ -0,0 +1,135 @@
+/** ===================================================================================================================
+* @file    BloomFilter HEADER FILE
+*
+* @brief   blocked Bloom filter: all the bits of a key are in one 64 bytes block (one cache line per lookup).
+*
+*          Built once (insert) and then only read (mayContain), so it can be shared by many reader threads.
+*          mayContain false: the key was never inserted; true: it may have been inserted (about 1% of false
+*          positives with 10 bits per key).
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-047   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_BLOOM_FILTER_H
+#define QAPPNG_BLOOM_FILTER_H
+
+// Include STL
+#include <vector>
+#include <functional>
+
+// other Includes
+#include <QAppNG/core.h>
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    template < typename KEY_CLASS, typename HASH = std::hash<KEY_CLASS> >
+    class BloomFilter
+    {
+    public:
+        static const size_t WORDS_PER_BLOCK = 8;
+        static const size_t BITS_PER_BLOCK  = WORDS_PER_BLOCK * 64;
+
+        // bits positions are taken 9 at a time from a 64 bits hash
+        static const size_t MAX_NUMBER_OF_HASHES = 7;
+
+        BloomFilter() : m_number_of_blocks( 0 ), m_number_of_hashes( 0 ) {}
+
+        //______________________________________________________________________________________________________
+        // room for number_of_keys keys, bits_per_key 0: no key may be inserted (mayContain always true)
+        void init( size_t number_of_keys, size_t bits_per_key )
+        {
+            m_bits.clear();
+            m_number_of_blocks = 0;
+            m_number_of_hashes = 0;
+
+            if ( !bits_per_key ) return;
+
+            m_number_of_blocks = ( number_of_keys * bits_per_key + BITS_PER_BLOCK - 1 ) / BITS_PER_BLOCK;
+            if ( !m_number_of_blocks ) m_number_of_blocks = 1;
+
+            // optimal number of hashes: bits_per_key * ln(2)
+            m_number_of_hashes = ( bits_per_key * 69 + 50 ) / 100;
+            if ( m_number_of_hashes < 1 ) m_number_of_hashes = 1;
+            if ( m_number_of_hashes > MAX_NUMBER_OF_HASHES ) m_number_of_hashes = MAX_NUMBER_OF_HASHES;
+
+            m_bits.assign( m_number_of_blocks * WORDS_PER_BLOCK, 0 );
+        }
+
+        //______________________________________________________________________________________________________
+        void insert( const KEY_CLASS& key )
+        {
+            if ( !m_number_of_blocks ) return;
+
+            UInt64 hash = mixHash( m_hash( key ) );
+            UInt64* block = &m_bits[ getBlock( hash ) * WORDS_PER_BLOCK ];
+            UInt64 bits = mixHash( hash );
+
+            for ( size_t i = 0; i < m_number_of_hashes; i++, bits >>= 9 )
+            {
+                block[ ( bits & 511 ) >> 6 ] |= UInt64(1) << ( bits & 63 );
+            }
+        }
+
+        //______________________________________________________________________________________________________
+        bool mayContain( const KEY_CLASS& key ) const
+        {
+            if ( !m_number_of_blocks ) return true;
+
+            UInt64 hash = mixHash( m_hash( key ) );
+            const UInt64* block = &m_bits[ getBlock( hash ) * WORDS_PER_BLOCK ];
+            UInt64 bits = mixHash( hash );
+
+            for ( size_t i = 0; i < m_number_of_hashes; i++, bits >>= 9 )
+            {
+                if ( !( block[ ( bits & 511 ) >> 6 ] & ( UInt64(1) << ( bits & 63 ) ) ) ) return false;
+            }
+
+            return true;
+        }
+
+        bool isEnabled() const { return m_number_of_blocks != 0; }
+        size_t getSizeInBytes() const { return m_bits.size() * sizeof(UInt64); }
+
+    private:
+        // spread weak hashes (e.g. std::hash of integers is the identity)
+        static inline UInt64 mixHash( UInt64 hash )
+        {
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        inline size_t getBlock( UInt64 hash ) const
+        {
+            return size_t( ( ( hash >> 32 ) * m_number_of_blocks ) >> 32 );
+        }
+
+        HASH                m_hash;
+        std::vector<UInt64> m_bits;
+        size_t              m_number_of_blocks;
+        size_t              m_number_of_hashes;
+    };
+
+    template < typename KEY_CLASS, typename HASH >
+    const size_t BloomFilter<KEY_CLASS, HASH>::WORDS_PER_BLOCK;
+
+    template < typename KEY_CLASS, typename HASH >
+    const size_t BloomFilter<KEY_CLASS, HASH>::BITS_PER_BLOCK;
+
+    template < typename KEY_CLASS, typename HASH >
+    const size_t BloomFilter<KEY_CLASS, HASH>::MAX_NUMBER_OF_HASHES;
+}
+
+// --------------------------------------------------------------------------------------------------------
+#endif
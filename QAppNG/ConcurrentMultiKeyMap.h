@@ -0,0 +1,809 @@
+#pragma once
+/** ===================================================================================================================
+  * @file    ConcurrentMultiKeyMap HEADER FILE
+  *
+  * @brief   thread safe multi key map with the same interface of MultiKeyMapEvo: a context can be looked up by
+  *          any key from any thread (e.g. identity correlation outside of the worker owning the context).
+  *
+  *              class MyValue : public MultiKeyMap::ConcurrentValue<UInt32, UInt64>
+  *              {
+  *              ...
+  *              };
+  *
+  *              MultiKeyMap::ConcurrentMultiKeyMap<MyValue, UInt32, UInt64> my_map;
+  *
+  *              my_map.insertElementByKey<0>( tlli, val, current_time_sec );    // any thread
+  *              my_map.setKey<1>( tlli_rai, val );                             // any thread
+  *              my_map.getElementByKey<1>( tlli_rai, val );                    // any thread, lock free
+  *
+  *          - each index is split in shards (by key hash), a shard is an open addressing table protected by a
+  *            sequence lock: readers never lock, they retry if a writer changed the shard meanwhile. Tables and
+  *            element holders are freed through an EpochDomain, so a reader never touches freed memory;
+  *          - writers lock the stripe of the elements they change (the element keys are guarded by it) and then
+  *            the shard of the key. setKey of a key owned by another element locks both elements and moves the
+  *            key with a single entry update: readers see the key either in the old or in the new element, never
+  *            in both or in none;
+  *          - as in MultiKeyMapEvo each index keeps up to MAX_KEYS_PER_INDEX keys for an element.
+  *
+  *          The user data of the elements is not protected by the map.
+  *
+  *          Keys must be trivially copyable (checked at compile time): readers compare table keys that a writer
+  *          may be changing and drop the result if the shard sequence moved.
+  *          Each thread using the map, readers included, enters an EpochDomain read section, which registers it
+  *          in ThreadCounter: at most ThreadCounter::MAX_NUMBER_OF_THREADS (128) threads of the process can use
+  *          it, the first one over the limit gets the ThreadCounter exception.
+  *
+  * @copyright
+  *
+  * @history
+  * REF#        Who                                                              When          What
+  * #user-040   QAppNG Team                                                      Oct-2026      Original Development
+  *
+  * @endhistory
+  * ===================================================================================================================
+  */
+
+// include
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <type_traits>
+
+#include <QAppNG/core.h>
+#include <QAppNG/EpochDomain.h>
+#include <QAppNG/MultiKeyMapEvo.h>
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+namespace MultiKeyMap
+{
+    // --------------------------------------------------------------------------------------------------------------------
+
+    // forward declarations
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    class ConcurrentMultiKeyMap;
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief one index of ConcurrentMultiKeyMap: key -> HOLDER*, lock free find, writers lock the shard
+    */
+    template <typename KEY_CLASS, typename HOLDER>
+    class ConcurrentIndex
+    {
+        static_assert( IsMemcpyKey<KEY_CLASS>::value, "ConcurrentMultiKeyMap keys are read by seqlock readers while written: KEY_CLASSES must be trivially copyable" );
+
+    public:
+        ConcurrentIndex() : m_epoch_domain( NULL ), m_shard_mask( 0 ) {}
+
+        // number_of_shards must be a power of two
+        void init( EpochDomain& epoch_domain, size_t number_of_shards )
+        {
+            m_epoch_domain = &epoch_domain;
+            m_shard_mask   = number_of_shards - 1;
+
+            m_shards.resize( number_of_shards );
+            for ( size_t i = 0; i < m_shards.size(); ++i ) m_shards[i].reset( new Shard() );
+        }
+
+        ~ConcurrentIndex()
+        {
+            for ( size_t i = 0; i < m_shards.size(); ++i ) delete m_shards[i]->table.load();
+        }
+
+        //______________________________________________________________________________________________________
+        // lock free, to be called inside an EpochDomain read section
+        HOLDER* find( const KEY_CLASS& key ) const
+        {
+            UInt64 hash = getHash( key );
+            const Shard& shard = getShard( hash );
+
+            for ( ; ; )
+            {
+                UInt64 sequence = shard.sequence.load( std::memory_order_acquire );
+
+                // writer inside
+                if ( sequence & 1 ) continue;
+
+                HOLDER* holder = findInTable( shard.table.load( std::memory_order_acquire ), hash, key );
+
+                // entries read in between are valid only if no writer came
+                std::atomic_thread_fence( std::memory_order_acquire );
+                if ( shard.sequence.load( std::memory_order_relaxed ) == sequence ) return holder;
+            }
+        }
+
+        //______________________________________________________________________________________________________
+        // set key to holder only if it is owned by expected_holder (NULL: key not in index)
+        bool replace( const KEY_CLASS& key, HOLDER* expected_holder, HOLDER* holder )
+        {
+            UInt64 hash = getHash( key );
+            Shard& shard = getShard( hash );
+
+            std::lock_guard<std::mutex> lock( shard.mutex );
+
+            Table* table = shard.table.load( std::memory_order_relaxed );
+            Entry* entry = findEntry( table, hash, key );
+
+            if ( ( entry ? entry->holder.load( std::memory_order_relaxed ) : NULL ) != expected_holder ) return false;
+
+            if ( entry )
+            {
+                // key moved from an element to another one with a single store
+                beginWrite( shard );
+                entry->holder.store( holder, std::memory_order_relaxed );
+                endWrite( shard );
+                return true;
+            }
+
+            if ( !table || ( shard.size + 1 ) * 4 > ( table->mask + 1 ) * 3 ) table = grow( shard );
+
+            beginWrite( shard );
+            insertInTable( table, hash, key, holder );
+            endWrite( shard );
+
+            ++shard.size;
+            return true;
+        }
+
+        //______________________________________________________________________________________________________
+        // erase key only if it is owned by holder
+        bool erase( const KEY_CLASS& key, HOLDER* holder )
+        {
+            UInt64 hash = getHash( key );
+            Shard& shard = getShard( hash );
+
+            std::lock_guard<std::mutex> lock( shard.mutex );
+
+            Table* table = shard.table.load( std::memory_order_relaxed );
+            Entry* entry = findEntry( table, hash, key );
+
+            if ( !entry || entry->holder.load( std::memory_order_relaxed ) != holder ) return false;
+
+            beginWrite( shard );
+
+            // backward shift (see FlatIndex)
+            size_t hole = entry - &table->entries[0];
+            for ( size_t next = ( hole + 1 ) & table->mask; table->entries[next].holder.load( std::memory_order_relaxed ); next = ( next + 1 ) & table->mask )
+            {
+                size_t home = size_t( getHash( table->entries[next].key ) ) & table->mask;
+
+                if ( ( ( next - home ) & table->mask ) >= ( ( next - hole ) & table->mask ) )
+                {
+                    table->entries[hole].key = table->entries[next].key;
+                    table->entries[hole].holder.store( table->entries[next].holder.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+                    hole = next;
+                }
+            }
+
+            table->entries[hole].key = KEY_CLASS();
+            table->entries[hole].holder.store( NULL, std::memory_order_relaxed );
+
+            endWrite( shard );
+
+            --shard.size;
+            return true;
+        }
+
+        //______________________________________________________________________________________________________
+        // number of keys (exact only without concurrent writers)
+        size_t size() const
+        {
+            size_t number_of_keys = 0;
+            for ( size_t i = 0; i < m_shards.size(); ++i ) number_of_keys += m_shards[i]->size;
+            return number_of_keys;
+        }
+
+        static inline UInt64 getHash( const KEY_CLASS& key )
+        {
+            return FlatIndex<KEY_CLASS>::mixHash( std::hash<KEY_CLASS>()( key ) );
+        }
+
+    private:
+        struct Entry
+        {
+            Entry() : key(), holder( NULL ) {}
+
+            KEY_CLASS               key;
+            std::atomic<HOLDER*>    holder;
+        };
+
+        struct Table
+        {
+            explicit Table( size_t capacity ) : mask( capacity - 1 ), entries( capacity ) {}
+
+            size_t              mask;
+            std::vector<Entry>  entries;
+        };
+
+        struct Shard
+        {
+            Shard() : sequence( 0 ), table( NULL ), size( 0 ) {}
+
+            std::atomic<UInt64> sequence;
+            std::atomic<Table*> table;
+            size_t              size;
+            std::mutex          mutex;
+            UInt8               padding[64];
+        };
+
+        // shard from the high bits, position in table from the low bits
+        inline Shard& getShard( UInt64 hash ) const { return *m_shards[ size_t( hash >> 40 ) & m_shard_mask ]; }
+
+        static HOLDER* findInTable( const Table* table, UInt64 hash, const KEY_CLASS& key )
+        {
+            if ( !table ) return NULL;
+
+            // bounded probing: the table may be changed by a writer while it is read
+            // (keys are trivially copyable: a torn key only gives a result that find drops)
+            size_t position = size_t( hash ) & table->mask;
+            for ( size_t probe = 0; probe <= table->mask; ++probe, position = ( position + 1 ) & table->mask )
+            {
+                HOLDER* holder = table->entries[position].holder.load( std::memory_order_relaxed );
+
+                if ( !holder )                              return NULL;
+                if ( table->entries[position].key == key )  return holder;
+            }
+
+            return NULL;
+        }
+
+        // shard mutex locked
+        static Entry* findEntry( Table* table, UInt64 hash, const KEY_CLASS& key )
+        {
+            if ( !table ) return NULL;
+
+            for ( size_t position = size_t( hash ) & table->mask; ; position = ( position + 1 ) & table->mask )
+            {
+                Entry& entry = table->entries[position];
+
+                if ( !entry.holder.load( std::memory_order_relaxed ) ) return NULL;
+                if ( entry.key == key )                                return &entry;
+            }
+        }
+
+        static void insertInTable( Table* table, UInt64 hash, const KEY_CLASS& key, HOLDER* holder )
+        {
+            size_t position = size_t( hash ) & table->mask;
+            while ( table->entries[position].holder.load( std::memory_order_relaxed ) ) position = ( position + 1 ) & table->mask;
+
+            table->entries[position].key = key;
+            table->entries[position].holder.store( holder, std::memory_order_relaxed );
+        }
+
+        // new table published to readers, the old one is freed when no reader uses it anymore
+        Table* grow( Shard& shard )
+        {
+            Table* old_table = shard.table.load( std::memory_order_relaxed );
+            Table* new_table = new Table( old_table ? ( old_table->mask + 1 ) * 2 : 16 );
+
+            if ( old_table )
+            {
+                for ( size_t i = 0; i <= old_table->mask; ++i )
+                {
+                    HOLDER* holder = old_table->entries[i].holder.load( std::memory_order_relaxed );
+                    if ( holder ) insertInTable( new_table, getHash( old_table->entries[i].key ), old_table->entries[i].key, holder );
+                }
+            }
+
+            beginWrite( shard );
+            shard.table.store( new_table, std::memory_order_release );
+            endWrite( shard );
+
+            if ( old_table ) m_epoch_domain->retire( [old_table]() { delete old_table; } );
+
+            return new_table;
+        }
+
+        static inline void beginWrite( Shard& shard )
+        {
+            shard.sequence.store( shard.sequence.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+        }
+
+        static inline void endWrite( Shard& shard )
+        {
+            shard.sequence.store( shard.sequence.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+        }
+
+        ConcurrentIndex( const ConcurrentIndex& ) = delete;
+        ConcurrentIndex& operator=( const ConcurrentIndex& ) = delete;
+
+        EpochDomain*                            m_epoch_domain;
+        std::vector< std::unique_ptr<Shard> >   m_shards;
+        size_t                                  m_shard_mask;
+    };
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    template <typename... KEY_CLASSES>
+    class ConcurrentValue
+    {
+        template <typename VALUE_CLASS, typename... MAP_KEY_CLASSES>
+        friend class ConcurrentMultiKeyMap;
+
+    public:
+        // keys kept for each index (the oldest is removed when one more is set)
+        static const size_t MAX_KEYS_PER_INDEX = 4;
+
+        // CTOR
+        ConcurrentValue() : m_number_of_keys( 0 ), m_holder( NULL ), m_last_activity_time_sec( 0 ), m_last_activity_time_nsec( 0 )
+        {
+            // stripe of the element in its map
+            static std::atomic<UInt64> unique_id_counter( 0 );
+            m_unique_id = unique_id_counter++;
+        }
+
+        // DTOR
+        virtual ~ConcurrentValue() {}
+
+        UInt64 getUniqueId() const { return m_unique_id; }
+
+        void touch( const UInt32& sec, const UInt32& nsec ) { m_last_activity_time_sec = sec; m_last_activity_time_nsec = nsec; };
+        UInt32 getLastActivityTimeSec() const { return m_last_activity_time_sec; }
+        UInt32 getLastActivityTimeNSec() const { return m_last_activity_time_nsec; }
+
+    private:
+        // guarded by the stripe lock of the element
+        std::tuple< KeySlots<KEY_CLASSES, MAX_KEYS_PER_INDEX>... > m_keys;
+        size_t m_number_of_keys;
+        void* m_holder;
+
+        UInt64 m_unique_id;
+        std::atomic<UInt32> m_last_activity_time_sec;
+        std::atomic<UInt32> m_last_activity_time_nsec;
+    };
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    class ConcurrentMultiKeyMap
+    {
+    public:
+        typedef ConcurrentValue<KEY_CLASSES...> ValueBase;
+
+        static const size_t NUMBER_OF_INDEXES = sizeof...(KEY_CLASSES);
+        static const size_t NUMBER_OF_STRIPES = 256;
+
+        // retired holders/tables deleted in batches
+        static const size_t RECLAIM_BATCH = 64;
+
+        // key type of an index
+        template < size_t KEY_NUMBER >
+        struct Key
+        {
+            typedef typename std::tuple_element< KEY_NUMBER, std::tuple<KEY_CLASSES...> >::type Type;
+        };
+
+        // CTOR: number_of_shards (for each index) is rounded up to a power of two
+        explicit ConcurrentMultiKeyMap( size_t number_of_shards = 64 ) : m_size( 0 )
+        {
+            static_assert( std::is_base_of< ValueBase, VALUE_CLASS >::value, "ConcurrentMultiKeyMap values must derive from ConcurrentValue<KEY_CLASSES...>" );
+
+            initIndexes<0>( getPowerOfTwo( number_of_shards ) );
+        }
+
+        // DTOR: no other thread may use the map anymore
+        virtual ~ConcurrentMultiKeyMap()
+        {
+            for ( size_t i = 0; i < NUMBER_OF_STRIPES; ++i )
+            {
+                for ( Holder* holder = m_stripes[i].head; holder; )
+                {
+                    Holder* next = holder->next;
+                    holder->value->m_holder = NULL;
+                    delete holder;
+                    holder = next;
+                }
+            }
+        }
+
+        // insert element
+        template < size_t KEY_NUMBER >
+        void insertElementByKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val
+                               , const UInt32& current_time_sec = 0, const UInt32& current_time_nsec = 0 )
+        {
+            // activity time first: a concurrent purge must not see the old one
+            val->touch( current_time_sec, current_time_nsec );
+
+            setKey<KEY_NUMBER>( key, val );
+        }
+
+        // get element by KEY (lock free)
+        template < size_t KEY_NUMBER >
+        bool getElementByKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& element_value )
+        {
+            EpochDomain::ReadGuard read_guard( m_epoch_domain );
+
+            Holder* holder = std::get<KEY_NUMBER>( m_indexes ).find( key );
+            if ( !holder ) return false;
+
+            element_value = holder->value;
+            return true;
+        }
+
+        // set KEY to element: a key used by another element is moved to this one
+        template < size_t KEY_NUMBER >
+        void setKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val )
+        {
+            {
+                EpochDomain::ReadGuard read_guard( m_epoch_domain );
+
+                for ( ; ; )
+                {
+                    Holder* owner = std::get<KEY_NUMBER>( m_indexes ).find( key );
+
+                    std::mutex& val_mutex   = getStripe( *val ).mutex;
+                    std::mutex& owner_mutex = owner ? getStripe( *owner->value ).mutex : val_mutex;
+
+                    std::unique_lock<std::mutex> val_lock( val_mutex, std::defer_lock );
+                    std::unique_lock<std::mutex> owner_lock( owner_mutex, std::defer_lock );
+
+                    if ( &owner_mutex == &val_mutex ) val_lock.lock();
+                    else                              std::lock( val_lock, owner_lock );
+
+                    // owner changed before locking: retry
+                    if ( setKeyLocked<KEY_NUMBER>( key, val, owner ) ) break;
+                }
+            }
+
+            m_epoch_domain.collect( RECLAIM_BATCH );
+        }
+
+        // check KEY for element
+        template < size_t KEY_NUMBER >
+        bool hasKey( std::shared_ptr<VALUE_CLASS>& val )
+        {
+            std::lock_guard<std::mutex> lock( getStripe( *val ).mutex );
+            return std::get<KEY_NUMBER>( val->ValueBase::m_keys ).number_of_keys > 0;
+        }
+
+        // check specific KEY for element
+        template < size_t KEY_NUMBER >
+        bool hasKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val )
+        {
+            std::lock_guard<std::mutex> lock( getStripe( *val ).mutex );
+            return std::get<KEY_NUMBER>( val->ValueBase::m_keys ).has( key );
+        }
+
+        template < size_t KEY_NUMBER >
+        bool getKey( typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val, size_t key_index )
+        {
+            std::lock_guard<std::mutex> lock( getStripe( *val ).mutex );
+            const KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val->ValueBase::m_keys );
+
+            if ( key_index >= key_slots.number_of_keys ) return false;
+
+            key = key_slots.keys[key_index];
+            return true;
+        }
+
+        template < size_t KEY_NUMBER >
+        void getKeys( std::vector< typename Key<KEY_NUMBER>::Type >& key_vector, std::shared_ptr<VALUE_CLASS>& val )
+        {
+            std::lock_guard<std::mutex> lock( getStripe( *val ).mutex );
+            const KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val->ValueBase::m_keys );
+
+            key_vector.assign( key_slots.keys, key_slots.keys + key_slots.number_of_keys );
+        }
+
+        // rem KEY from element
+        template < size_t KEY_NUMBER >
+        void remKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val )
+        {
+            {
+                std::lock_guard<std::mutex> lock( getStripe( *val ).mutex );
+
+                Holder* holder = static_cast<Holder*>( val->m_holder );
+                if ( !holder || !std::get<KEY_NUMBER>( val->ValueBase::m_keys ).remove( key ) ) return;
+
+                std::get<KEY_NUMBER>( m_indexes ).erase( key, holder );
+                --val->m_number_of_keys;
+
+                // check if element has no keys and eventually delete it
+                if ( !val->m_number_of_keys ) release( *val );
+            }
+
+            m_epoch_domain.collect( RECLAIM_BATCH );
+        }
+
+        // rem all KEYs of a given index from element
+        template < size_t KEY_NUMBER >
+        void remKeys( std::shared_ptr<VALUE_CLASS>& val )
+        {
+            {
+                std::lock_guard<std::mutex> lock( getStripe( *val ).mutex );
+
+                if ( !val->m_holder ) return;
+
+                remKeysLocked<KEY_NUMBER>( *val );
+                if ( !val->m_number_of_keys ) release( *val );
+            }
+
+            m_epoch_domain.collect( RECLAIM_BATCH );
+        }
+
+        // rem all KEYs of all indexes: the element leaves the map
+        void eraseElement( std::shared_ptr<VALUE_CLASS>& val )
+        {
+            {
+                std::lock_guard<std::mutex> lock( getStripe( *val ).mutex );
+
+                if ( !val->m_holder ) return;
+
+                remAllKeysLocked<0>( *val );
+                release( *val );
+            }
+
+            m_epoch_domain.collect( RECLAIM_BATCH );
+        }
+
+        // update last_activity_time_sec of given element
+        void touch( std::shared_ptr<VALUE_CLASS>& val, const UInt32& current_time_sec )
+        {
+            val->m_last_activity_time_sec = current_time_sec;
+        }
+
+        // erase elements if inactivity time greater than given value (all indexes), one stripe locked at a time
+        size_t purge( const UInt32& current_time_sec, const UInt32& max_inactivity_time_sec )
+        {
+            size_t number_of_purged_elements(0);
+
+            for ( size_t i = 0; i < NUMBER_OF_STRIPES; ++i )
+            {
+                std::lock_guard<std::mutex> lock( m_stripes[i].mutex );
+
+                for ( Holder* holder = m_stripes[i].head; holder; )
+                {
+                    ValueBase& val = *holder->value;
+                    holder = holder->next;
+
+                    UInt32 last_activity_time_sec = val.m_last_activity_time_sec;
+
+                    if (  last_activity_time_sec
+                       && current_time_sec > last_activity_time_sec
+                       && current_time_sec - last_activity_time_sec > max_inactivity_time_sec )
+                    {
+                        remAllKeysLocked<0>( val );
+                        release( val );
+                        ++number_of_purged_elements;
+                    }
+                }
+            }
+
+            m_epoch_domain.collect();
+
+            return number_of_purged_elements;
+        }
+
+        // number of elements (values with at least one key)
+        size_t size() const { return m_size.load( std::memory_order_relaxed ); }
+
+        // no concurrent writers: each key of each element points to the element, each index entry is a key of an element
+        bool sanityCheck()
+        {
+            EpochDomain::ReadGuard read_guard( m_epoch_domain );
+
+            size_t number_of_elements(0);
+
+            for ( size_t i = 0; i < NUMBER_OF_STRIPES; ++i )
+            {
+                for ( Holder* holder = m_stripes[i].head; holder; holder = holder->next )
+                {
+                    ++number_of_elements;
+
+                    if ( holder->value->m_holder != holder || !holder->value->m_number_of_keys || !checkKeys<0>( *holder ) ) return false;
+                }
+            }
+
+            return number_of_elements == size() && checkIndexSizes<0>();
+        }
+
+    private:
+        // element as seen by readers: it never changes until it is freed by the EpochDomain
+        struct Holder
+        {
+            explicit Holder( const std::shared_ptr<VALUE_CLASS>& element_value ) : value( element_value ), prev( NULL ), next( NULL ) {}
+
+            std::shared_ptr<VALUE_CLASS> value;
+
+            // elements of the stripe (stripe lock)
+            Holder* prev;
+            Holder* next;
+        };
+
+        struct Stripe
+        {
+            Stripe() : head( NULL ) {}
+
+            std::mutex  mutex;
+            Holder*     head;
+            UInt8       padding[64];
+        };
+
+        // declared first: the indexes retire their tables in it
+        EpochDomain m_epoch_domain;
+
+        std::tuple< ConcurrentIndex<KEY_CLASSES, Holder>... > m_indexes;
+        Stripe m_stripes[NUMBER_OF_STRIPES];
+        std::atomic<size_t> m_size;
+
+        static size_t getPowerOfTwo( size_t number )
+        {
+            size_t power_of_two = 1;
+            while ( power_of_two < number ) power_of_two <<= 1;
+            return power_of_two;
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ) >::type initIndexes( size_t number_of_shards )
+        {
+            std::get<KEY_NUMBER>( m_indexes ).init( m_epoch_domain, number_of_shards );
+            initIndexes<KEY_NUMBER + 1>( number_of_shards );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ) >::type initIndexes( size_t ) {}
+
+        inline Stripe& getStripe( const ValueBase& val ) { return m_stripes[ val.m_unique_id % NUMBER_OF_STRIPES ]; }
+
+        // stripes of val and owner locked, false if the key is not owned by owner anymore
+        template < size_t KEY_NUMBER >
+        bool setKeyLocked( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val, Holder* owner )
+        {
+            KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val->ValueBase::m_keys );
+
+            Holder* holder = static_cast<Holder*>( val->m_holder );
+
+            // element already has this key for this index: DO NOTHING
+            if ( holder && holder == owner && key_slots.has( key ) ) return true;
+
+            // new element: its holder is visible to readers only after the key is in the index
+            std::unique_ptr<Holder> new_holder;
+            if ( !holder )
+            {
+                new_holder.reset( new Holder( val ) );
+                holder = new_holder.get();
+            }
+
+            if ( !std::get<KEY_NUMBER>( m_indexes ).replace( key, owner, holder ) ) return false;
+
+            if ( new_holder )
+            {
+                link( *new_holder.release() );
+                val->m_holder = holder;
+                ++m_size;
+            }
+
+            // key used by another element: REMOVE KEY FROM OLD ELEMENT (checking if it is to be deleted)
+            if ( owner )
+            {
+                ValueBase& old_val = *owner->value;
+
+                std::get<KEY_NUMBER>( old_val.m_keys ).remove( key );
+                if ( !--old_val.m_number_of_keys ) release( old_val );
+            }
+
+            // index full for this element: the oldest key goes away
+            if ( key_slots.number_of_keys == ValueBase::MAX_KEYS_PER_INDEX )
+            {
+                std::get<KEY_NUMBER>( m_indexes ).erase( key_slots.keys[0], holder );
+                key_slots.remove( key_slots.keys[0] );
+                --val->m_number_of_keys;
+            }
+
+            // ASSIGN KEY TO ELEMENT
+            key_slots.keys[ key_slots.number_of_keys++ ] = key;
+            ++val->m_number_of_keys;
+
+            return true;
+        }
+
+        template < size_t KEY_NUMBER >
+        void remKeysLocked( ValueBase& val )
+        {
+            KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val.m_keys );
+            Holder* holder = static_cast<Holder*>( val.m_holder );
+
+            while ( key_slots.number_of_keys )
+            {
+                std::get<KEY_NUMBER>( m_indexes ).erase( key_slots.keys[ key_slots.number_of_keys - 1 ], holder );
+                key_slots.keys[ --key_slots.number_of_keys ] = typename Key<KEY_NUMBER>::Type();
+                --val.m_number_of_keys;
+            }
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ) >::type remAllKeysLocked( ValueBase& val )
+        {
+            remKeysLocked<KEY_NUMBER>( val );
+            remAllKeysLocked<KEY_NUMBER + 1>( val );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ) >::type remAllKeysLocked( ValueBase& ) {}
+
+        // stripe locked
+        void link( Holder& holder )
+        {
+            Stripe& stripe = getStripe( *holder.value );
+
+            holder.next = stripe.head;
+            if ( stripe.head ) stripe.head->prev = &holder;
+            stripe.head = &holder;
+        }
+
+        // stripe locked, element has no keys anymore: readers may still use its holder until the epoch is over
+        void release( ValueBase& val )
+        {
+            Holder* holder = static_cast<Holder*>( val.m_holder );
+            Stripe& stripe = getStripe( val );
+
+            if ( holder->prev ) holder->prev->next = holder->next;
+            else                stripe.head        = holder->next;
+            if ( holder->next ) holder->next->prev = holder->prev;
+
+            val.m_holder = NULL;
+            --m_size;
+
+            m_epoch_domain.retire( [holder]() { delete holder; } );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ), bool >::type checkKeys( Holder& holder )
+        {
+            const KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( holder.value->ValueBase::m_keys );
+
+            for ( size_t i = 0; i < key_slots.number_of_keys; i++ )
+            {
+                if ( std::get<KEY_NUMBER>( m_indexes ).find( key_slots.keys[i] ) != &holder ) return false;
+            }
+
+            return checkKeys<KEY_NUMBER + 1>( holder );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ), bool >::type checkKeys( Holder& ) { return true; }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ), bool >::type checkIndexSizes()
+        {
+            size_t number_of_keys(0);
+
+            for ( size_t i = 0; i < NUMBER_OF_STRIPES; ++i )
+            {
+                for ( Holder* holder = m_stripes[i].head; holder; holder = holder->next )
+                {
+                    number_of_keys += std::get<KEY_NUMBER>( holder->value->ValueBase::m_keys ).number_of_keys;
+                }
+            }
+
+            return number_of_keys == std::get<KEY_NUMBER>( m_indexes ).size() && checkIndexSizes<KEY_NUMBER + 1>();
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ), bool >::type checkIndexSizes() { return true; }
+    };
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    template <typename... KEY_CLASSES>
+    const size_t ConcurrentValue<KEY_CLASSES...>::MAX_KEYS_PER_INDEX;
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    const size_t ConcurrentMultiKeyMap<VALUE_CLASS, KEY_CLASSES...>::NUMBER_OF_INDEXES;
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    const size_t ConcurrentMultiKeyMap<VALUE_CLASS, KEY_CLASSES...>::NUMBER_OF_STRIPES;
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    const size_t ConcurrentMultiKeyMap<VALUE_CLASS, KEY_CLASSES...>::RECLAIM_BATCH;
+} // namespace MultiKeyMap
+} // namespace QAppNG
+
+// --------------------------------------------------------------------------------------------------------------------
+// End of file
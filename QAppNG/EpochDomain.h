@@ -0,0 +1,162 @@
+/** ===================================================================================================================
+* @file    EpochDomain HEADER FILE
+*
+* @brief   epoch based memory reclamation: readers enter/exit a read section without locks, writers retire the
+*          objects they unlinked and these are deleted only when no reader that could still see them is active.
+*
+*          Each thread uses the slot of its ThreadCounter id (so at most ThreadCounter::MAX_NUMBER_OF_THREADS).
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-040   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_EPOCH_DOMAIN_H
+#define QAPPNG_EPOCH_DOMAIN_H
+
+// Include STL
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <functional>
+
+// other Includes
+#include <QAppNG/core.h>
+#include <QAppNG/ThreadCounter.h>
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    class EpochDomain
+    {
+    public:
+        static const size_t MAX_NUMBER_OF_THREADS = ThreadCounter::MAX_NUMBER_OF_THREADS;
+
+        // RAII read section (nested sections of the same thread are allowed)
+        class ReadGuard
+        {
+        public:
+            explicit ReadGuard( EpochDomain& domain ) : m_domain( domain ) { m_domain.enter(); }
+            ~ReadGuard() { m_domain.exit(); }
+
+        private:
+            ReadGuard( const ReadGuard& ) = delete;
+            ReadGuard& operator=( const ReadGuard& ) = delete;
+
+            EpochDomain& m_domain;
+        };
+
+        EpochDomain() : m_global_epoch( 1 ), m_number_of_retired( 0 ) {}
+
+        // DTOR: no reader may be active anymore
+        ~EpochDomain()
+        {
+            for ( size_t i = 0; i < m_retired.size(); ++i ) m_retired[i].deleter();
+        }
+
+        //______________________________________________________________________________________________________
+        void enter()
+        {
+            Slot& slot = m_slots[ ThreadCounter::Instance().getThreadId() ];
+
+            // the epoch must be visible before reading any shared pointer
+            if ( !slot.depth++ ) slot.epoch.store( m_global_epoch.load() );
+        }
+
+        //______________________________________________________________________________________________________
+        void exit()
+        {
+            Slot& slot = m_slots[ ThreadCounter::Instance().getThreadId() ];
+
+            if ( !--slot.depth ) slot.epoch.store( 0, std::memory_order_release );
+        }
+
+        //______________________________________________________________________________________________________
+        // object already unlinked (not reachable by new readers), deleter is called by a later collect
+        void retire( const std::function<void()>& deleter )
+        {
+            std::lock_guard<std::mutex> lock( m_retired_mutex );
+
+            Retired retired;
+            retired.epoch   = m_global_epoch.load();
+            retired.deleter = deleter;
+            m_retired.push_back( retired );
+
+            m_number_of_retired.store( m_retired.size(), std::memory_order_relaxed );
+        }
+
+        //______________________________________________________________________________________________________
+        // delete retired objects no reader can see anymore, only if at least min_number_of_retired are waiting
+        // (do not call it inside a read section: objects retired after the section started are kept)
+        size_t collect( size_t min_number_of_retired = 1 )
+        {
+            if ( !min_number_of_retired || m_number_of_retired.load( std::memory_order_relaxed ) < min_number_of_retired ) return 0;
+
+            std::vector<Retired> to_be_deleted;
+            {
+                std::lock_guard<std::mutex> lock( m_retired_mutex );
+
+                // readers entering from now on can not see objects retired so far
+                UInt64 oldest_active_epoch = m_global_epoch.fetch_add( 1 ) + 1;
+
+                for ( size_t i = 0; i < MAX_NUMBER_OF_THREADS; ++i )
+                {
+                    UInt64 epoch = m_slots[i].epoch.load();
+                    if ( epoch && epoch < oldest_active_epoch ) oldest_active_epoch = epoch;
+                }
+
+                size_t number_of_kept = 0;
+                for ( size_t i = 0; i < m_retired.size(); ++i )
+                {
+                    if ( m_retired[i].epoch < oldest_active_epoch ) to_be_deleted.push_back( m_retired[i] );
+                    else                                            m_retired[number_of_kept++] = m_retired[i];
+                }
+                m_retired.resize( number_of_kept );
+
+                m_number_of_retired.store( m_retired.size(), std::memory_order_relaxed );
+            }
+
+            // deleters run without lock (they may destroy user objects)
+            for ( size_t i = 0; i < to_be_deleted.size(); ++i ) to_be_deleted[i].deleter();
+
+            return to_be_deleted.size();
+        }
+
+        size_t getNumberOfRetired() const { return m_number_of_retired.load( std::memory_order_relaxed ); }
+
+    private:
+        EpochDomain( const EpochDomain& ) = delete;
+        EpochDomain& operator=( const EpochDomain& ) = delete;
+
+        // written by its own thread only, read by collect
+        struct Slot
+        {
+            Slot() : epoch( 0 ), depth( 0 ) {}
+
+            std::atomic<UInt64>     epoch;
+            size_t                  depth;
+            UInt8                   padding[64];
+        };
+
+        struct Retired
+        {
+            UInt64                  epoch;
+            std::function<void()>   deleter;
+        };
+
+        std::atomic<UInt64>     m_global_epoch;
+        Slot                    m_slots[MAX_NUMBER_OF_THREADS];
+
+        std::mutex              m_retired_mutex;
+        std::vector<Retired>    m_retired;
+        std::atomic<size_t>     m_number_of_retired;
+    };
+}
+
+// --------------------------------------------------------------------------------------------------------
+#endif
@@ -46,6 +46,7 @@
 #include "TrivialCircularLockFreeQueueEvo.h"
 #include "TrivialCircularLockFreeQueueSortedEvo.h"
 #include "ThreadCounter.h"
+#include "ThreadAffinity.h"
 
 namespace QAppNG
 {
@@ -147,6 +148,10 @@ namespace QAppNG
         UInt8                          m_sorted_queue_disorder_tollerance_percent;
         UInt16                         m_thread_idle_sleep_time;
 
+        // threads placement (empty CpuSet -> thread is not pinned)
+        CpuSet                         m_extractor_thread_cpu_affinity;
+        CpuSet                         m_sorter_thread_cpu_affinity;
+
         // CTOR will init all configuration parameters to DEFAULT
         LightWeightSequencerConfiguration();
     private:
@@ -635,6 +640,9 @@ namespace QAppNG
         std::thread   m_sorter_thread;
         mutable size_t        m_extractor_thread_id;
         mutable size_t        m_sorter_thread_id;
+        std::string           m_extractor_thread_cpu_placement;
+        std::string           m_sorter_thread_cpu_placement;
+        mutable std::mutex    m_thread_cpu_placement_mutex;     // placements are written by their threads, read by status
         static  size_t        m_time_pulse_thread_id;   // id of Qvirtual Clock Thread inserting time pulse events: this is the same for all LWS istances;
         volatile bool m_stop_extractor_thread;
         volatile bool m_stop_sorter_thread;
@@ -775,6 +783,15 @@ namespace QAppNG
         {
             // set TID
             m_sorter_thread_id = ThreadCounter::Instance().getThreadId();
+
+            // set CPU affinity and store actual placement
+            setCurrentThreadCpuAffinity( m_lws_name + "_lws_sorter", m_lws_configuration.m_sorter_thread_cpu_affinity );
+            std::string sorter_thread_cpu_placement = getCurrentThreadCpuAffinity().toString();
+            {
+                std::unique_lock<std::mutex> placement_lock( m_thread_cpu_placement_mutex );
+                m_sorter_thread_cpu_placement = sorter_thread_cpu_placement;
+            }
+
             m_sorter_thread_is_running = true;
 
             while ( !m_stop_sorter_thread )
@@ -825,6 +842,14 @@ namespace QAppNG
             // set TID
             m_extractor_thread_id = ThreadCounter::Instance().getThreadId();
 
+            // set CPU affinity and store actual placement
+            setCurrentThreadCpuAffinity( m_lws_name + "_lws_extractor", m_lws_configuration.m_extractor_thread_cpu_affinity );
+            std::string extractor_thread_cpu_placement = getCurrentThreadCpuAffinity().toString();
+            {
+                std::unique_lock<std::mutex> placement_lock( m_thread_cpu_placement_mutex );
+                m_extractor_thread_cpu_placement = extractor_thread_cpu_placement;
+            }
+
             // Extractor Thread is running
             m_extractor_thread_is_running = true;
 
@@ -1383,18 +1408,25 @@ namespace QAppNG
             max_consumable_limit_string = std::to_string( lws_sequencer.m_lws_configuration.m_max_consumables_per_loop );
         }
 
+        std::string extractor_thread_cpu_placement, sorter_thread_cpu_placement;
+        {
+            std::unique_lock<std::mutex> placement_lock( lws_sequencer.m_thread_cpu_placement_mutex );
+            extractor_thread_cpu_placement = lws_sequencer.m_extractor_thread_cpu_placement;
+            sorter_thread_cpu_placement    = lws_sequencer.m_sorter_thread_cpu_placement;
+        }
+
         std::string extractor_thread_id_string("Not Any thread");
 
         if (lws_sequencer.m_extractor_thread_is_running)
         {
-            extractor_thread_id_string = std::to_string(lws_sequencer.m_extractor_thread_id);
+            extractor_thread_id_string = std::to_string(lws_sequencer.m_extractor_thread_id) + " (cpus " + extractor_thread_cpu_placement + ")";
         }
 
         std::string sorter_thread_id_string("Not Any thread");
 
         if (lws_sequencer.m_sorter_thread_is_running)
         {
-            sorter_thread_id_string = std::to_string(lws_sequencer.m_sorter_thread_id);
+            sorter_thread_id_string = std::to_string(lws_sequencer.m_sorter_thread_id) + " (cpus " + sorter_thread_cpu_placement + ")";
         }
 
         output << "-------------------------------------------------------------"   << std::endl;
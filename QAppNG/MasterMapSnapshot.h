@@ -0,0 +1,388 @@
+#ifndef Q_MASTER_MAP_SNAPSHOT_H_NG
+#define Q_MASTER_MAP_SNAPSHOT_H_NG
+
+/** ===================================================================================================================
+* @file    MasterMapSnapshot
+*
+* @brief   immutable copy of the MasterMap data published after the SYNCH/PURGE that changed it.
+*
+*          SharedMap readers look up the last published copy inside an epoch read section (no lock, no shared
+*          counter); the MasterMap publishes a new copy and the previous one is deleted when no reader uses it.
+*
+*          Long traversals (dump, bulk export) pin a copy instead: it stays valid while they use it, without
+*          holding an epoch read section that would keep all the copies retired meanwhile.
+*
+*          Optional negative lookup filter: a Bloom filter over the keys of each shard, built when the shard is
+*          copied, so most lookups of unknown keys return without probing the copy.
+*
+*          The copy is split in NUMBER_OF_SHARDS shards by key hash. A publication copies only the shards of the
+*          keys changed since the previous one (copy on write), the others are shared with the previous copy:
+*          - prepare (MasterMap write lock held) takes the changed keys and their entries, O(changed keys);
+*          - publish (no MasterMap lock) copies the shards of those keys and rebuilds their filters.
+*          SYNCH publishes at most once per publish interval (DEFAULT_PUBLISH_INTERVAL_MSEC, it bounds the SYNCHs
+*          forced by full change logs, periodic SYNCHs are farther apart): the changes not yet published stay
+*          visible to the SharedMap that did them, the next SYNCH publishes them.
+*
+*          MAP_TYPE must be copy assignable and VALUE copies must be deep: the published copy is read by all the
+*          threads with no lock, so it cannot share mutable data with the MasterMap entries.
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-044   QAppNG Team                                                      Oct-2026      Original development
+* #user-047   QAppNG Team                                                      Oct-2026      negative lookup filter (setFilterBitsPerKey)
+* #user-049   QAppNG Team                                                      Oct-2026      pinned copies for traversals (pin)
+* #user-044   QAppNG Team                                                      Oct-2026      publish interval (setPublishIntervalMsec)
+* #user-044   QAppNG Team                                                      Oct-2026      copy on write shards, publish out of MasterMap lock
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <type_traits>
+#include <QAppNG/core.h>
+#include <QAppNG/EpochDomain.h>
+#include <QAppNG/BloomFilter.h>
+
+namespace QAppNG
+{
+    template<class MAP_TYPE>
+    class MasterMapSnapshot
+    {
+        static_assert( std::is_copy_assignable<MAP_TYPE>::value, "MasterMapSnapshot: MAP_TYPE must be copy assignable (each publication copies the changed shards)" );
+
+    public:
+        typedef typename MAP_TYPE::key_type     KeyType;
+        typedef typename MAP_TYPE::mapped_type  MappedType;
+        typedef typename MAP_TYPE::hasher       HasherType;
+
+        static const size_t SHARD_BITS                      = 12;
+        static const size_t NUMBER_OF_SHARDS                = size_t(1) << SHARD_BITS;
+        static const UInt32 DEFAULT_PUBLISH_INTERVAL_MSEC   = 10;
+
+        // part of a published copy, shared by the copies published until one of its keys changes
+        struct Shard
+        {
+            MAP_TYPE                            data_map;
+            BloomFilter<KeyType, HasherType>    filter;
+        };
+
+        typedef std::shared_ptr<const Shard> ShardPtr;
+
+        // published copy
+        struct Version
+        {
+            Version() : number_of_elements( 0 ), references( 1 ) {}
+
+            // NULL if key is not in the copy (unknown keys are mostly rejected by the filter of their shard)
+            const MappedType* find( const KeyType& key ) const
+            {
+                const Shard& shard = *shards[ getShardIndex( key ) ];
+
+                if ( !shard.filter.mayContain( key ) ) return NULL;
+
+                typename MAP_TYPE::const_iterator element = shard.data_map.find( key );
+                return element != shard.data_map.end() ? &element->second : NULL;
+            }
+
+            std::vector<ShardPtr>               shards;
+            size_t                              number_of_elements;
+
+            // the publication (until retired) and the pins
+            mutable std::atomic<UInt32>         references;
+        };
+
+        typedef std::shared_ptr<const Version> VersionPtr;
+
+        // RAII read section: the published copy stays valid until the guard is destroyed
+        class ReadGuard
+        {
+        public:
+            explicit ReadGuard( MasterMapSnapshot& snapshot )
+                : m_epoch_guard( snapshot.m_epoch_domain )
+                , m_version( snapshot.m_version.load( std::memory_order_acquire ) )
+            {
+            }
+
+            const MappedType* find( const KeyType& key ) const { return m_version->find( key ); }
+
+            size_t size() const { return m_version->number_of_elements; }
+
+        private:
+            ReadGuard( const ReadGuard& ) = delete;
+            ReadGuard& operator=( const ReadGuard& ) = delete;
+
+            EpochDomain::ReadGuard  m_epoch_guard;
+            const Version*          m_version;
+        };
+
+        // changes taken by prepare (MasterMap write lock held) and published by publish (no MasterMap lock).
+        // Publications are done in the order they are prepared: the batch holds the publish mutex in between
+        class PublishBatch
+        {
+        public:
+            PublishBatch() : m_generation( 0 ), m_filter_bits_per_key( 0 ), m_copy_all_shards( false ) {}
+
+            // getGeneration of the snapshot when the batch was prepared
+            UInt64 getGeneration() const { return m_generation; }
+
+        private:
+            friend class MasterMapSnapshot;
+
+            std::unique_lock<std::mutex>                    m_publish_lock;
+            std::vector< std::pair<KeyType, MappedType> >   m_set_elements;
+            std::vector<KeyType>                            m_erased_keys;
+            UInt64                                          m_generation;
+            UInt32                                          m_filter_bits_per_key;
+            bool                                            m_copy_all_shards;
+        };
+
+        MasterMapSnapshot()
+            : m_empty_shard( new Shard() )
+            , m_version( newEmptyVersion() )
+            , m_filter_bits_per_key( 0 )
+            , m_publish_interval_msec( DEFAULT_PUBLISH_INTERVAL_MSEC )
+            , m_last_publish_time()
+            , m_publish_pending( false )
+            , m_copy_all_shards_pending( false )
+            , m_generation( 0 )
+            , m_number_of_published( 0 )
+            , m_number_of_copied_shards( 0 )
+        {
+        }
+
+        // DTOR: no reader may be active anymore (retired copies are deleted by the EpochDomain DTOR)
+        ~MasterMapSnapshot()
+        {
+            release( m_version.load() );
+        }
+
+        // shard of key in the published copies (high bits of the mixed hash: the low ones pick the bucket in the shard)
+        static size_t getShardIndex( const KeyType& key )
+        {
+            return size_t( ( UInt64( HasherType()( key ) ) * 0x9E3779B97F4A7C15ULL ) >> ( 64 - SHARD_BITS ) );
+        }
+
+        // --------------------------------------------------------------------------------------------------
+        // READER
+
+        // last published copy, valid until the returned pointer is released (also after the snapshot is deleted)
+        VersionPtr pin()
+        {
+            EpochDomain::ReadGuard epoch_guard( m_epoch_domain );
+
+            const Version* version = m_version.load( std::memory_order_acquire );
+            version->references.fetch_add( 1, std::memory_order_relaxed );
+
+            return VersionPtr( version, &MasterMapSnapshot::release );
+        }
+
+        // --------------------------------------------------------------------------------------------------
+        // WRITER (MasterMap write lock held, but publish)
+
+        // key set, updated, touched or erased in the MasterMap since the last prepare
+        void setChanged( const KeyType& key ) { m_changed_keys.push_back( key ); }
+
+        // the MasterMap changed after the last prepare (one more generation of changes to publish)
+        void setPublishPending() { m_publish_pending = true; ++m_generation; }
+        bool isPublishPending() const { return m_publish_pending; }
+
+        // changes synched so far: a publication prepared with the same generation covers all of them
+        UInt64 getGeneration() const { return m_generation; }
+
+        // true if publish_interval_msec is elapsed since the last publication (always true with interval 0)
+        bool isPublishDue() const
+        {
+            return !m_publish_interval_msec
+                || std::chrono::steady_clock::now() - m_last_publish_time >= std::chrono::milliseconds( m_publish_interval_msec );
+        }
+
+        // take the entries of the changed keys from data_map, O(changed keys). Then publish the batch (it holds the
+        // publish mutex: a new prepare waits until it is published)
+        void prepare( const MAP_TYPE& data_map, PublishBatch& batch )
+        {
+            batch.m_publish_lock = std::unique_lock<std::mutex>( m_publish_mutex );
+
+            batch.m_set_elements.clear();
+            batch.m_erased_keys.clear();
+
+            for ( typename std::vector<KeyType>::const_iterator key = m_changed_keys.begin(); key != m_changed_keys.end(); ++key )
+            {
+                typename MAP_TYPE::const_iterator element = data_map.find( *key );
+
+                if ( element != data_map.end() ) batch.m_set_elements.push_back( *element );
+                else                             batch.m_erased_keys.push_back( *key );
+            }
+
+            batch.m_generation          = m_generation;
+            batch.m_filter_bits_per_key = m_filter_bits_per_key;
+            batch.m_copy_all_shards     = m_copy_all_shards_pending;
+
+            m_changed_keys.clear();
+            m_copy_all_shards_pending = false;
+            m_publish_pending = false;
+            m_last_publish_time = std::chrono::steady_clock::now();
+        }
+
+        // no MasterMap lock: readers entering from now on see the last copy with the changes of the batch. Only the
+        // shards of the changed keys are copied (all the non empty ones after setFilterBitsPerKey)
+        void publish( PublishBatch& batch )
+        {
+            if ( !batch.m_publish_lock.owns_lock() ) return;
+
+            // publishers are serialized by the publish mutex
+            const Version* previous_version = m_version.load( std::memory_order_relaxed );
+
+            Version* version = new Version();
+            version->shards = previous_version->shards;
+            version->number_of_elements = previous_version->number_of_elements;
+
+            std::vector< std::shared_ptr<Shard> > copied_shards( NUMBER_OF_SHARDS );
+
+            if ( batch.m_copy_all_shards )
+            {
+                for ( size_t shard = 0; shard < NUMBER_OF_SHARDS; ++shard )
+                {
+                    if ( !version->shards[shard]->data_map.empty() ) copied_shards[shard].reset( new Shard( *version->shards[shard] ) );
+                }
+            }
+
+            for ( typename std::vector< std::pair<KeyType, MappedType> >::const_iterator element = batch.m_set_elements.begin(); element != batch.m_set_elements.end(); ++element )
+            {
+                Shard& shard = getCopiedShard( *version, copied_shards, getShardIndex( element->first ) );
+
+                std::pair<typename MAP_TYPE::iterator, bool> rv = shard.data_map.insert( *element );
+                if ( !rv.second ) rv.first->second = element->second;
+                else              ++version->number_of_elements;
+            }
+
+            for ( typename std::vector<KeyType>::const_iterator key = batch.m_erased_keys.begin(); key != batch.m_erased_keys.end(); ++key )
+            {
+                size_t shard = getShardIndex( *key );
+
+                // keys set and erased between two publications are not in the copy
+                if ( !copied_shards[shard] && !version->shards[shard]->data_map.count( *key ) ) continue;
+
+                version->number_of_elements -= getCopiedShard( *version, copied_shards, shard ).data_map.erase( *key );
+            }
+
+            for ( size_t shard = 0; shard < NUMBER_OF_SHARDS; ++shard )
+            {
+                if ( !copied_shards[shard] ) continue;
+
+                // filter of the copied shard (keys can not be removed from a filter)
+                copied_shards[shard]->filter.init( copied_shards[shard]->data_map.size(), batch.m_filter_bits_per_key );
+
+                for ( typename MAP_TYPE::const_iterator element = copied_shards[shard]->data_map.begin(); batch.m_filter_bits_per_key && element != copied_shards[shard]->data_map.end(); ++element )
+                {
+                    copied_shards[shard]->filter.insert( element->first );
+                }
+
+                version->shards[shard] = copied_shards[shard];
+                ++m_number_of_copied_shards;
+            }
+
+            retire( m_version.exchange( version, std::memory_order_acq_rel ) );
+
+            ++m_number_of_published;
+
+            batch.m_set_elements.clear();
+            batch.m_erased_keys.clear();
+            batch.m_publish_lock.unlock();
+        }
+
+        // readers entering from now on see an empty copy (MasterMap cleared)
+        void clear()
+        {
+            std::lock_guard<std::mutex> publish_lock( m_publish_mutex );
+
+            m_changed_keys.clear();
+            m_publish_pending = false;
+
+            retire( m_version.exchange( newEmptyVersion(), std::memory_order_acq_rel ) );
+        }
+
+        // negative lookup filter of the next published copies (0: no filter), all the shards get it at the next one
+        void setFilterBitsPerKey( UInt32 filter_bits_per_key )
+        {
+            m_filter_bits_per_key = filter_bits_per_key;
+            m_copy_all_shards_pending = true;
+            setPublishPending();
+        }
+        UInt32 getFilterBitsPerKey() const { return m_filter_bits_per_key; }
+
+        // min time between two publications done by SYNCH (0: publish after each SYNCH that changed the MasterMap)
+        void setPublishIntervalMsec( UInt32 publish_interval_msec ) { m_publish_interval_msec = publish_interval_msec; }
+        UInt32 getPublishIntervalMsec() const { return m_publish_interval_msec; }
+
+        UInt64 getNumberOfPublished() const { return m_number_of_published; }
+        UInt64 getNumberOfCopiedShards() const { return m_number_of_copied_shards; }
+
+    private:
+        MasterMapSnapshot( const MasterMapSnapshot& ) = delete;
+        MasterMapSnapshot& operator=( const MasterMapSnapshot& ) = delete;
+
+        Version* newEmptyVersion() const
+        {
+            Version* version = new Version();
+            version->shards.assign( NUMBER_OF_SHARDS, m_empty_shard );
+            return version;
+        }
+
+        // shard of version copied once by a publication
+        static Shard& getCopiedShard( Version& version, std::vector< std::shared_ptr<Shard> >& copied_shards, size_t shard )
+        {
+            if ( !copied_shards[shard] ) copied_shards[shard].reset( new Shard( *version.shards[shard] ) );
+            return *copied_shards[shard];
+        }
+
+        // the previous copy is deleted when no reader uses it (the shards still used by the last copy are kept)
+        void retire( const Version* previous_version )
+        {
+            m_epoch_domain.retire( [previous_version]() { release( previous_version ); } );
+            m_epoch_domain.collect();
+        }
+
+        // pins are taken in a read section only: once a retired copy reaches here no new pin can come
+        static void release( const Version* version )
+        {
+            if ( version->references.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) delete version;
+        }
+
+        EpochDomain                     m_epoch_domain;
+        ShardPtr                        m_empty_shard;
+        std::atomic<const Version*>     m_version;
+
+        // publishers (the copy of the changed shards is done out of the MasterMap lock)
+        std::mutex                      m_publish_mutex;
+
+        // MasterMap write lock
+        std::vector<KeyType>            m_changed_keys;
+        UInt32                          m_filter_bits_per_key;
+        UInt32                          m_publish_interval_msec;
+        std::chrono::steady_clock::time_point m_last_publish_time;
+        bool                            m_publish_pending;
+        bool                            m_copy_all_shards_pending;
+        UInt64                          m_generation;
+
+        // publish mutex
+        std::atomic<UInt64>             m_number_of_published;
+        std::atomic<UInt64>             m_number_of_copied_shards;
+    };
+
+    template<class MAP_TYPE>
+    const size_t MasterMapSnapshot<MAP_TYPE>::SHARD_BITS;
+
+    template<class MAP_TYPE>
+    const size_t MasterMapSnapshot<MAP_TYPE>::NUMBER_OF_SHARDS;
+
+    template<class MAP_TYPE>
+    const UInt32 MasterMapSnapshot<MAP_TYPE>::DEFAULT_PUBLISH_INTERVAL_MSEC;
+}
+#endif //Q_MASTER_MAP_SNAPSHOT_H_NG
@@ -399,7 +399,7 @@ namespace MultiKeyMap
         template< size_t KEY_NUMBER, typename KEY_CLASS >
         bool hasKey( std::shared_ptr<VALUE_CLASS>& val )
         {
-            return val->hasKey<KEY_NUMBER, KEY_CLASS>();
+            return val->template hasKey<KEY_NUMBER, KEY_CLASS>();
         }
 
         // check specific KEY for element
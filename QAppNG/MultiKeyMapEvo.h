@@ -0,0 +1,1163 @@
+#pragma once
+/** ===================================================================================================================
+  * @file    MultiKeyMapEvo HEADER FILE
+  *
+  * @brief   typed multi key map: index key types are template parameters, keys are stored inside the value and
+  *          indexes are open addressing flat hash tables (one probe sequence per lookup, no allocation per key).
+  *          Usage is the same of MultiKeyMap, the index number is enough to know the key type:
+  *
+  *              class MyValue : public MultiKeyMap::ValueEvo<UInt32, UInt64>
+  *              {
+  *              public:
+  *                  MyValue() : m_my_data(0) {};
+  *
+  *                  UInt32 m_my_data;
+  *              };
+  *
+  *              class MyMultiKeyMap : public MultiKeyMap::MultiKeyMapEvo<MyValue, UInt32, UInt64>
+  *              {
+  *              public:
+  *                  // insert element
+  *                  void insertElementByTlli( const UInt32& tlli, std::shared_ptr<MyValue>& val, const UInt32& current_time_sec = 0 )
+  *                      { insertElementByKey<0>( tlli, val, current_time_sec ); }
+  *
+  *                  // get element
+  *                  bool getGbContextIdByTlli( const UInt32& tlli, std::shared_ptr<MyValue>& val )        { return getElementByKey<0>( tlli, val ); }
+  *                  bool getGbContextIdByTlliRai( const UInt64& tlli_rai, std::shared_ptr<MyValue>& val ) { return getElementByKey<1>( tlli_rai, val ); }
+  *
+  *                  // set key
+  *                  void setTlliRai( const UInt64& tlli_rai, std::shared_ptr<MyValue>& val ) { setKey<1>( tlli_rai, val ); }
+  *
+  *                  // erase element (all keys of all indexes)
+  *                  void erase( std::shared_ptr<MyValue>& val ) { eraseElement( val ); }
+  *              };
+  *
+  *          Each index keeps up to ValueEvo::MAX_KEYS_PER_INDEX keys for a value: setting one more key on a full
+  *          index removes the oldest one (e.g. an old TMSI of the same subscriber).
+  *
+  *          Elements are also linked in an expiry timing wheel (one bucket per second of last activity), so purge()
+  *          only visits the seconds that expired since the previous call, and it can stop after a given number of
+  *          purged elements and go on at the next call:
+  *
+  *              // in the processing loop, at most 1000 contexts erased per call
+  *              my_map.purge( current_time_sec, max_inactivity_time_sec, 1000 );
+  *
+  *          Use MultiKeyMapEvo::touch to update the activity time: ValueEvo::touch does not move the element in
+  *          the wheel, purge() finds it later in an older bucket and just moves it (it is not erased).
+  *
+  *          A map created with use_slab_pool allocates the values of createElement (object and shared_ptr control
+  *          block together) in its own SlabPool; purges give back the empty slabs. With reserve() the value slots
+  *          and the indexes are sized once, so inserting a context does not call the system allocator:
+  *
+  *              MyMultiKeyMap my_map( true );
+  *              my_map.reserve( 1000000 );
+  *
+  *              std::shared_ptr<MyValue> val = my_map.createElement();
+  *              my_map.insertElementByTlli( tlli, val, current_time_sec );
+  *
+  *          Warm restart: saveSnapshot writes all elements with their keys and activity times in a memory mapped
+  *          file (on shutdown or from a periodic timer of the owner thread), loadSnapshot maps it, decodes the
+  *          elements and builds the indexes in parallel (one thread per index). Keys are copied as they are in
+  *          memory (trivially copyable, checked at compile time), the user data goes through an encoder/decoder:
+  *
+  *              my_map.saveSnapshot( "/var/run/gb_contexts.snap",
+  *                  []( const MyValue& val, std::vector<UInt8>& payload )
+  *                  { payload.assign( (const UInt8*)&val.m_my_data, (const UInt8*)&val.m_my_data + sizeof(UInt32) ); return true; } );
+  *
+  *              my_map.loadSnapshot( "/var/run/gb_contexts.snap",
+  *                  [&my_map]( const UInt8* payload, size_t payload_length )
+  *                  { std::shared_ptr<MyValue> val = my_map.createElement(); memcpy( &val->m_my_data, payload, sizeof(UInt32) ); return val; } );
+  *
+  * @copyright
+  *
+  * @history
+  * REF#        Who                                             When          What
+  * #user-038   QAppNG Team                                     Oct-2026      Original Development
+  * #user-039   QAppNG Team                                     Oct-2026      Expiry timing wheel, incremental purge
+  * #user-041   QAppNG Team                                     Oct-2026      Values allocated in a per map SlabPool
+  * #user-042   QAppNG Team                                     Oct-2026      Warm restart snapshots
+  *
+  * @endhistory
+  * ===================================================================================================================
+  */
+
+// include
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include <QAppNG/core.h>
+#include <QAppNG/SlabPool.h>
+#include <QAppNG/MultiKeyMapSnapshot.h>
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+namespace MultiKeyMap
+{
+    // --------------------------------------------------------------------------------------------------------------------
+
+    // forward declarations
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    class MultiKeyMapEvo;
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief open addressing hash index: key -> slot of the value in MultiKeyMapEvo.
+    *         Linear probing on a power of two table (at most 3/4 full), erase moves back the following entries
+    *         so there are no tombstones and a miss stops at the first empty entry.
+    */
+    template <typename KEY_CLASS>
+    class FlatIndex
+    {
+    public:
+        static const UInt32 EMPTY_SLOT = 0xFFFFFFFF;
+
+        FlatIndex() : m_mask( 0 ), m_size( 0 ) {}
+
+        // slot of key, EMPTY_SLOT if not found
+        inline UInt32 find( const KEY_CLASS& key ) const
+        {
+            if ( !m_size ) return EMPTY_SLOT;
+
+            for ( size_t position = getHomePosition( key ); ; position = ( position + 1 ) & m_mask )
+            {
+                const Entry& entry = m_entries[position];
+
+                if ( entry.slot == EMPTY_SLOT ) return EMPTY_SLOT;
+                if ( entry.key == key )         return entry.slot;
+            }
+        }
+
+        // insert or overwrite
+        inline void set( const KEY_CLASS& key, UInt32 slot )
+        {
+            if ( ( m_size + 1 ) * 4 > m_entries.size() * 3 ) grow();
+
+            for ( size_t position = getHomePosition( key ); ; position = ( position + 1 ) & m_mask )
+            {
+                Entry& entry = m_entries[position];
+
+                if ( entry.slot == EMPTY_SLOT )
+                {
+                    entry.key  = key;
+                    entry.slot = slot;
+                    ++m_size;
+                    return;
+                }
+
+                if ( entry.key == key )
+                {
+                    entry.slot = slot;
+                    return;
+                }
+            }
+        }
+
+        // false if key was not in the index
+        inline bool erase( const KEY_CLASS& key )
+        {
+            if ( !m_size ) return false;
+
+            size_t position = getHomePosition( key );
+            for ( ; ; position = ( position + 1 ) & m_mask )
+            {
+                if ( m_entries[position].slot == EMPTY_SLOT ) return false;
+                if ( m_entries[position].key == key )         break;
+            }
+
+            // backward shift: move back each following entry that may not be found anymore through the hole
+            size_t hole = position;
+            for ( size_t next = ( hole + 1 ) & m_mask; m_entries[next].slot != EMPTY_SLOT; next = ( next + 1 ) & m_mask )
+            {
+                size_t home = getHomePosition( m_entries[next].key );
+
+                if ( ( ( next - home ) & m_mask ) >= ( ( next - hole ) & m_mask ) )
+                {
+                    m_entries[hole] = m_entries[next];
+                    hole = next;
+                }
+            }
+
+            m_entries[hole].key  = KEY_CLASS();
+            m_entries[hole].slot = EMPTY_SLOT;
+            --m_size;
+
+            return true;
+        }
+
+        size_t size() const     { return m_size; }
+        size_t capacity() const { return m_entries.size(); }
+
+        // table large enough for number_of_keys keys (no rehash until then)
+        void reserve( size_t number_of_keys )
+        {
+            while ( number_of_keys * 4 > m_entries.size() * 3 ) grow();
+        }
+
+        void clear()
+        {
+            m_entries.clear();
+            m_mask = 0;
+            m_size = 0;
+        }
+
+        // spread the bits of std::hash (identity for integers) on the whole table
+        static inline UInt64 mixHash( UInt64 hash )
+        {
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+    private:
+        struct Entry
+        {
+            Entry() : key(), slot( EMPTY_SLOT ) {}
+
+            KEY_CLASS   key;
+            UInt32      slot;
+        };
+
+        inline size_t getHomePosition( const KEY_CLASS& key ) const
+        {
+            return size_t( mixHash( std::hash<KEY_CLASS>()( key ) ) ) & m_mask;
+        }
+
+        void grow()
+        {
+            std::vector<Entry> old_entries;
+            old_entries.swap( m_entries );
+
+            m_entries.resize( old_entries.empty() ? 16 : old_entries.size() * 2 );
+            m_mask = m_entries.size() - 1;
+            m_size = 0;
+
+            for ( size_t i = 0; i < old_entries.size(); i++ )
+            {
+                if ( old_entries[i].slot != EMPTY_SLOT ) set( old_entries[i].key, old_entries[i].slot );
+            }
+        }
+
+        std::vector<Entry>  m_entries;
+        size_t              m_mask;
+        size_t              m_size;
+    };
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief keys of a value for one index, stored inline (oldest first)
+    */
+    template <typename KEY_CLASS, size_t MAX_KEYS>
+    struct KeySlots
+    {
+        KeySlots() : number_of_keys( 0 ) {}
+
+        KEY_CLASS   keys[MAX_KEYS];
+        size_t      number_of_keys;
+
+        bool has( const KEY_CLASS& key ) const
+        {
+            for ( size_t i = 0; i < number_of_keys; i++ )
+            {
+                if ( keys[i] == key ) return true;
+            }
+            return false;
+        }
+
+        bool remove( const KEY_CLASS& key )
+        {
+            for ( size_t i = 0; i < number_of_keys; i++ )
+            {
+                if ( keys[i] == key )
+                {
+                    for ( size_t j = i + 1; j < number_of_keys; j++ ) keys[j - 1] = keys[j];
+                    keys[--number_of_keys] = KEY_CLASS();
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    template <typename... KEY_CLASSES>
+    class ValueEvo
+    {
+        template <typename VALUE_CLASS, typename... MAP_KEY_CLASSES>
+        friend class MultiKeyMapEvo;
+
+    public:
+        // keys kept for each index (the oldest is removed when one more is set)
+        static const size_t MAX_KEYS_PER_INDEX = 4;
+        static const UInt32 NOT_IN_MAP         = 0xFFFFFFFF;
+
+        // CTOR
+        ValueEvo()
+            : m_number_of_keys( 0 ), m_slot( NOT_IN_MAP )
+            , m_expiry_bucket( NOT_IN_MAP ), m_expiry_prev( NOT_IN_MAP ), m_expiry_next( NOT_IN_MAP )
+            , m_last_activity_time_sec( 0 ), m_last_activity_time_nsec( 0 ) {}
+
+        // DTOR
+        virtual ~ValueEvo() {}
+
+        // slot in the map (NOT_IN_MAP if the value has no keys)
+        UInt32 getSlot() const { return m_slot; }
+
+        void touch( const UInt32& sec, const UInt32& nsec ) { m_last_activity_time_sec = sec; m_last_activity_time_nsec = nsec; };
+        const UInt32& getLastActivityTimeSec() const { return m_last_activity_time_sec; }
+        const UInt32& getLastActivityTimeNSec() const { return m_last_activity_time_nsec; }
+
+    protected:
+        // check if for a given index at least one Key has been defined
+        template < size_t KEY_NUMBER >
+        bool hasKey() const
+        {
+            return std::get<KEY_NUMBER>( m_keys ).number_of_keys > 0;
+        }
+
+        // check if for a given index a specific Key has been defined
+        template < size_t KEY_NUMBER >
+        bool hasKey( const typename std::tuple_element< KEY_NUMBER, std::tuple<KEY_CLASSES...> >::type& key ) const
+        {
+            return std::get<KEY_NUMBER>( m_keys ).has( key );
+        }
+
+        // check if at least a Key for at least an index is still associated to current Value object
+        bool hasKeys() const
+        {
+            return m_number_of_keys > 0;
+        }
+
+    private:
+        std::tuple< KeySlots<KEY_CLASSES, MAX_KEYS_PER_INDEX>... > m_keys;
+        size_t m_number_of_keys;
+
+        UInt32 m_slot;
+
+        // expiry wheel links (slots of the previous and next element in the bucket)
+        UInt32 m_expiry_bucket;
+        UInt32 m_expiry_prev;
+        UInt32 m_expiry_next;
+
+        UInt32 m_last_activity_time_sec;
+        UInt32 m_last_activity_time_nsec;
+    };
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    class MultiKeyMapEvo
+    {
+    public:
+        typedef ValueEvo<KEY_CLASSES...> ValueBase;
+
+        static const size_t NUMBER_OF_INDEXES = sizeof...(KEY_CLASSES);
+
+        // seconds covered by the expiry wheel: with longer inactivity times purge() still works but it has to skip
+        // the elements of a bucket that are one or more turns ahead
+        static const UInt32 EXPIRY_WHEEL_SIZE = 4096;
+
+        // key type of an index
+        template < size_t KEY_NUMBER >
+        struct Key
+        {
+            typedef typename std::tuple_element< KEY_NUMBER, std::tuple<KEY_CLASSES...> >::type Type;
+        };
+
+        // empty slabs kept after a purge
+        static const size_t NUMBER_OF_KEPT_EMPTY_SLABS = 1;
+
+        // CTOR
+        explicit MultiKeyMapEvo( bool use_slab_pool = false )
+            : m_size( 0 ), m_expiry_buckets( EXPIRY_WHEEL_SIZE, ValueBase::NOT_IN_MAP ), m_expiry_cursor_sec( 0 )
+        {
+            static_assert( std::is_base_of< ValueBase, VALUE_CLASS >::value, "MultiKeyMapEvo values must derive from ValueEvo<KEY_CLASSES...>" );
+
+            if ( use_slab_pool ) m_slab_pool = std::make_shared<SlabPool>();
+        }
+
+        // new element, in the SlabPool of the map if any (it may outlive the map)
+        template < typename... ARGS >
+        std::shared_ptr<VALUE_CLASS> createElement( ARGS&&... args )
+        {
+            if ( m_slab_pool ) return std::allocate_shared<VALUE_CLASS>( SlabAllocator<VALUE_CLASS>( m_slab_pool ), std::forward<ARGS>( args )... );
+
+            return std::make_shared<VALUE_CLASS>( std::forward<ARGS>( args )... );
+        }
+
+        // size value slots and indexes for number_of_elements elements with one key for each index
+        void reserve( size_t number_of_elements )
+        {
+            m_values.reserve( number_of_elements );
+            m_free_slots.reserve( number_of_elements );
+            reserveIndexes<0>( number_of_elements );
+        }
+
+        // NULL if the map has no SlabPool
+        const std::shared_ptr<SlabPool>& getSlabPool() const { return m_slab_pool; }
+
+        // snapshot user data: the encoder appends the data of an element to payload (false: element not saved),
+        // the decoder creates an element from its payload (NULL: element not loaded), it is called by many threads
+        typedef std::function< bool( const VALUE_CLASS& val, std::vector<UInt8>& payload ) > SnapshotEncoder;
+        typedef std::function< std::shared_ptr<VALUE_CLASS>( const UInt8* payload, size_t payload_length ) > SnapshotDecoder;
+
+        // write all elements to file_name (without encoder only keys and activity times, see createElement)
+        bool saveSnapshot( const std::string& file_name, const SnapshotEncoder& encoder = SnapshotEncoder() ) const
+        {
+            static_assert( NUMBER_OF_INDEXES <= SnapshotHeader::MAX_NUMBER_OF_INDEXES, "too many indexes for a snapshot" );
+
+            SnapshotWriter writer;
+            if ( !writer.open( file_name ) || !writer.append( sizeof(SnapshotHeader) ) ) return false;
+
+            std::vector<UInt64> offsets;
+            offsets.reserve( m_size );
+
+            std::vector<UInt8> payload;
+
+            for ( size_t slot = 0; slot < m_values.size(); slot++ )
+            {
+                if ( !m_values[slot] ) continue;
+
+                const VALUE_CLASS& val = *m_values[slot];
+
+                payload.clear();
+                if ( encoder && !encoder( val, payload ) ) continue;
+
+                size_t keys_length   = getSnapshotKeysLength<0>( val );
+                size_t record_length = ( SNAPSHOT_KEYS_OFFSET + keys_length + payload.size() + 7 ) & ~size_t(7);
+
+                offsets.push_back( writer.getLength() );
+
+                UInt8* data = writer.append( record_length );
+                if ( !data ) return false;
+
+                SnapshotRecord* record = reinterpret_cast<SnapshotRecord*>( data );
+                record->record_length           = UInt32( record_length );
+                record->payload_length          = UInt32( payload.size() );
+                record->last_activity_time_sec  = val.m_last_activity_time_sec;
+                record->last_activity_time_nsec = val.m_last_activity_time_nsec;
+
+                std::memset( data + sizeof(SnapshotRecord), 0, SNAPSHOT_KEYS_OFFSET - sizeof(SnapshotRecord) );
+                writeSnapshotKeys<0>( val, data + sizeof(SnapshotRecord), data + SNAPSHOT_KEYS_OFFSET );
+
+                if ( !payload.empty() ) std::memcpy( data + SNAPSHOT_KEYS_OFFSET + keys_length, &payload[0], payload.size() );
+            }
+
+            UInt64 offsets_offset = writer.getLength();
+
+            UInt8* data = writer.append( offsets.size() * sizeof(UInt64) );
+            if ( !data ) return false;
+            if ( !offsets.empty() ) std::memcpy( data, &offsets[0], offsets.size() * sizeof(UInt64) );
+
+            // header last: a snapshot with a valid header is complete
+            SnapshotHeader* header = reinterpret_cast<SnapshotHeader*>( writer.at( 0 ) );
+            std::memset( header, 0, sizeof(SnapshotHeader) );
+
+            header->magic               = SnapshotHeader::MAGIC;
+            header->version             = SnapshotHeader::VERSION;
+            header->number_of_indexes   = UInt32( NUMBER_OF_INDEXES );
+            header->max_keys_per_index  = UInt32( ValueBase::MAX_KEYS_PER_INDEX );
+            header->expiry_cursor_sec   = m_expiry_cursor_sec;
+            header->number_of_elements  = offsets.size();
+            header->offsets_offset      = offsets_offset;
+            header->file_size           = writer.getLength();
+            setSnapshotKeySizes<0>( header->key_sizes );
+
+            return writer.commit();
+        }
+
+        // fill an empty map from file_name: false (map still empty) if the snapshot is missing, corrupted or
+        // written by a map with other key types. number_of_threads 0: one per core
+        bool loadSnapshot( const std::string& file_name, const SnapshotDecoder& decoder = SnapshotDecoder(), size_t number_of_threads = 0 )
+        {
+            static_assert( NUMBER_OF_INDEXES <= SnapshotHeader::MAX_NUMBER_OF_INDEXES, "too many indexes for a snapshot" );
+
+            if ( m_size ) return false;
+
+            SnapshotReader reader;
+            if ( !reader.open( file_name ) || reader.getSize() < sizeof(SnapshotHeader) ) return false;
+
+            const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>( reader.getData() );
+
+            UInt32 key_sizes[SnapshotHeader::MAX_NUMBER_OF_INDEXES] = { 0 };
+            setSnapshotKeySizes<0>( key_sizes );
+
+            if (  header.magic != SnapshotHeader::MAGIC
+               || header.version != SnapshotHeader::VERSION
+               || header.number_of_indexes != NUMBER_OF_INDEXES
+               || header.max_keys_per_index != ValueBase::MAX_KEYS_PER_INDEX
+               || std::memcmp( header.key_sizes, key_sizes, sizeof(key_sizes) ) != 0
+               || header.file_size != reader.getSize()
+               || header.offsets_offset < sizeof(SnapshotHeader)
+               || header.offsets_offset > header.file_size
+               || header.number_of_elements > ( header.file_size - header.offsets_offset ) / sizeof(UInt64) )
+            {
+                return false;
+            }
+
+            // DECODE elements (records split among threads)
+            size_t number_of_elements = size_t( header.number_of_elements );
+            std::vector< std::shared_ptr<VALUE_CLASS> > values( number_of_elements );
+
+            if ( !number_of_threads ) number_of_threads = std::thread::hardware_concurrency();
+            if ( number_of_threads > number_of_elements / SNAPSHOT_MIN_ELEMENTS_PER_THREAD ) number_of_threads = number_of_elements / SNAPSHOT_MIN_ELEMENTS_PER_THREAD;
+            if ( !number_of_threads ) number_of_threads = 1;
+
+            std::atomic<bool> valid( true );
+            std::vector<std::thread> threads;
+
+            for ( size_t i = 0; i < number_of_threads; i++ )
+            {
+                size_t begin = number_of_elements * i / number_of_threads;
+                size_t end   = number_of_elements * ( i + 1 ) / number_of_threads;
+
+                threads.push_back( std::thread( [this, &reader, &header, &decoder, &values, &valid, begin, end]()
+                {
+                    if ( !decodeSnapshotRecords( reader.getData(), header, decoder, values, begin, end ) ) valid = false;
+                } ) );
+            }
+
+            for ( size_t i = 0; i < threads.size(); i++ ) threads[i].join();
+
+            if ( !valid ) return false;
+
+            // SLOTS in snapshot order
+            m_values.reserve( number_of_elements );
+
+            for ( size_t i = 0; i < number_of_elements; i++ )
+            {
+                if ( !values[i] || !values[i]->m_number_of_keys || values[i]->m_slot != ValueBase::NOT_IN_MAP ) continue;
+
+                values[i]->m_slot = UInt32( m_values.size() );
+                m_values.push_back( values[i] );
+            }
+
+            m_size = m_values.size();
+
+            // INDEXES: each one is built by its own thread
+            threads.clear();
+            buildSnapshotIndexes<0>( threads );
+            for ( size_t i = 0; i < threads.size(); i++ ) threads[i].join();
+
+            // EXPIRY wheel
+            m_expiry_cursor_sec = header.expiry_cursor_sec;
+            for ( size_t slot = 0; slot < m_values.size(); slot++ ) fileExpiry( *m_values[slot] );
+
+            return true;
+        }
+
+        // DTOR
+        virtual ~MultiKeyMapEvo() {}
+
+        // insert element
+        template < size_t KEY_NUMBER >
+        void insertElementByKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val
+                               , const UInt32& current_time_sec = 0, const UInt32& current_time_nsec = 0 )
+        {
+            // add value object key to index (the element is stored if not in map yet)
+            setKey<KEY_NUMBER>( key, val );
+
+            // init last activity time
+            val->m_last_activity_time_sec  = current_time_sec;
+            val->m_last_activity_time_nsec = current_time_nsec;
+
+            fileExpiry( *val );
+        }
+
+        // get element by KEY
+        template < size_t KEY_NUMBER >
+        bool getElementByKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& element_value ) const
+        {
+            UInt32 slot = std::get<KEY_NUMBER>( m_indexes ).find( key );
+
+            if ( slot == FlatIndex< typename Key<KEY_NUMBER>::Type >::EMPTY_SLOT ) return false;
+
+            element_value = m_values[slot];
+            return true;
+        }
+
+        // set KEY to element: a key used by another element is moved to this one
+        template < size_t KEY_NUMBER >
+        void setKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val )
+        {
+            typedef typename Key<KEY_NUMBER>::Type KEY_CLASS;
+
+            FlatIndex<KEY_CLASS>& index = std::get<KEY_NUMBER>( m_indexes );
+            KeySlots<KEY_CLASS, ValueBase::MAX_KEYS_PER_INDEX>& key_slots = std::get<KEY_NUMBER>( val->ValueBase::m_keys );
+
+            if ( val->m_slot == ValueBase::NOT_IN_MAP ) store( val );
+
+            // element already has this key for this index: DO NOTHING
+            if ( key_slots.has( key ) ) return;
+
+            // key used by another element: REMOVE KEY FROM OLD ELEMENT (checking if it is to be deleted)
+            UInt32 old_slot = index.find( key );
+            if ( old_slot != FlatIndex<KEY_CLASS>::EMPTY_SLOT )
+            {
+                std::shared_ptr<VALUE_CLASS> old_val( m_values[old_slot] );
+                remKey<KEY_NUMBER>( key, old_val );
+            }
+
+            // index full for this element: the oldest key goes away
+            if ( key_slots.number_of_keys == ValueBase::MAX_KEYS_PER_INDEX )
+            {
+                index.erase( key_slots.keys[0] );
+                key_slots.remove( key_slots.keys[0] );
+                --val->m_number_of_keys;
+            }
+
+            // ASSIGN KEY TO ELEMENT
+            key_slots.keys[ key_slots.number_of_keys++ ] = key;
+            ++val->m_number_of_keys;
+            index.set( key, val->m_slot );
+        }
+
+        // check KEY for element
+        template < size_t KEY_NUMBER >
+        bool hasKey( std::shared_ptr<VALUE_CLASS>& val ) const
+        {
+            return val->template hasKey<KEY_NUMBER>();
+        }
+
+        // check specific KEY for element
+        template < size_t KEY_NUMBER >
+        bool hasKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val ) const
+        {
+            return val->template hasKey<KEY_NUMBER>( key );
+        }
+
+        template < size_t KEY_NUMBER >
+        bool getKey( typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val, size_t key_index ) const
+        {
+            const KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val->ValueBase::m_keys );
+
+            if ( key_index >= key_slots.number_of_keys ) return false;
+
+            key = key_slots.keys[key_index];
+            return true;
+        }
+
+        template < size_t KEY_NUMBER >
+        void getKeys( std::vector< typename Key<KEY_NUMBER>::Type >& key_vector, std::shared_ptr<VALUE_CLASS>& val ) const
+        {
+            const KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val->ValueBase::m_keys );
+
+            key_vector.assign( key_slots.keys, key_slots.keys + key_slots.number_of_keys );
+        }
+
+        // rem KEY from element
+        template < size_t KEY_NUMBER >
+        void remKey( const typename Key<KEY_NUMBER>::Type& key, std::shared_ptr<VALUE_CLASS>& val )
+        {
+            if ( val->m_slot == ValueBase::NOT_IN_MAP ) return;
+
+            // remove key from element and from index
+            if ( !std::get<KEY_NUMBER>( val->ValueBase::m_keys ).remove( key ) ) return;
+
+            --val->m_number_of_keys;
+            std::get<KEY_NUMBER>( m_indexes ).erase( key );
+
+            // check if element has no keys and eventually delete it
+            if ( !val->hasKeys() ) release( val );
+        }
+
+        // rem all KEYs of a given index from element
+        template < size_t KEY_NUMBER >
+        void remKeys( std::shared_ptr<VALUE_CLASS>& val )
+        {
+            if ( val->m_slot == ValueBase::NOT_IN_MAP ) return;
+
+            KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val->ValueBase::m_keys );
+
+            while ( key_slots.number_of_keys )
+            {
+                std::get<KEY_NUMBER>( m_indexes ).erase( key_slots.keys[ key_slots.number_of_keys - 1 ] );
+                key_slots.keys[ --key_slots.number_of_keys ] = typename Key<KEY_NUMBER>::Type();
+                --val->m_number_of_keys;
+            }
+
+            // check if element has no keys and eventually delete it
+            if ( !val->hasKeys() ) release( val );
+        }
+
+        // rem all KEYs of all indexes: the element leaves the map
+        void eraseElement( std::shared_ptr<VALUE_CLASS>& val )
+        {
+            remAllKeys<0>( val );
+        }
+
+        // update last_activity_time_sec of given element
+        void touch( std::shared_ptr<VALUE_CLASS>& val, const UInt32& current_time_sec )
+        {
+            val->m_last_activity_time_sec = current_time_sec;
+
+            if ( val->m_slot != ValueBase::NOT_IN_MAP ) fileExpiry( *val );
+        }
+
+        // purge given index if inactivity time greater than given value (it scans all elements, see purge)
+        template < size_t KEY_NUMBER >
+        size_t purgeIndexingMap( const UInt32& current_time_sec, const UInt32& max_inactivity_time_sec )
+        {
+            size_t number_of_purged_elements(0);
+
+            for ( size_t slot = 0; slot < m_values.size(); slot++ )
+            {
+                if ( m_values[slot] && isExpired( *m_values[slot], current_time_sec, max_inactivity_time_sec )
+                    && m_values[slot]->template hasKey<KEY_NUMBER>() )
+                {
+                    std::shared_ptr<VALUE_CLASS> val( m_values[slot] );
+                    remKeys<KEY_NUMBER>( val );
+                    ++number_of_purged_elements;
+                }
+            }
+
+            releaseEmptySlabs( number_of_purged_elements );
+
+            return number_of_purged_elements;
+        }
+
+        // erase elements if inactivity time greater than given value (all indexes), walking the expiry wheel from
+        // the last purged second: max_purged_elements != 0 stops the purge after that many erased elements, the
+        // next call goes on from the same bucket
+        size_t purge( const UInt32& current_time_sec, const UInt32& max_inactivity_time_sec, size_t max_purged_elements = 0 )
+        {
+            size_t number_of_purged_elements(0);
+
+            if ( current_time_sec <= max_inactivity_time_sec ) return 0;
+
+            // elements with last activity up to this second are expired
+            UInt32 last_expired_sec = current_time_sec - max_inactivity_time_sec - 1;
+            if ( last_expired_sec < m_expiry_cursor_sec ) return 0;
+
+            // a full turn visits all buckets
+            UInt64 number_of_buckets = UInt64( last_expired_sec - m_expiry_cursor_sec ) + 1;
+            if ( number_of_buckets > EXPIRY_WHEEL_SIZE ) number_of_buckets = EXPIRY_WHEEL_SIZE;
+
+            for ( UInt64 i = 0; i < number_of_buckets; i++ )
+            {
+                UInt32 bucket = UInt32( ( m_expiry_cursor_sec + i ) & ( EXPIRY_WHEEL_SIZE - 1 ) );
+
+                for ( UInt32 slot = m_expiry_buckets[bucket]; slot != ValueBase::NOT_IN_MAP; )
+                {
+                    if ( max_purged_elements && number_of_purged_elements >= max_purged_elements )
+                    {
+                        // budget over: go on from this bucket
+                        m_expiry_cursor_sec = UInt32( m_expiry_cursor_sec + i );
+                        releaseEmptySlabs( number_of_purged_elements );
+                        return number_of_purged_elements;
+                    }
+
+                    std::shared_ptr<VALUE_CLASS> val( m_values[slot] );
+                    slot = val->m_expiry_next;
+
+                    if ( val->m_last_activity_time_sec <= last_expired_sec )
+                    {
+                        eraseElement( val );
+                        ++number_of_purged_elements;
+                    }
+                    else if ( getExpiryBucket( val->m_last_activity_time_sec ) != bucket )
+                    {
+                        // touched without MultiKeyMapEvo::touch
+                        fileExpiry( *val );
+                    }
+                }
+            }
+
+            m_expiry_cursor_sec = last_expired_sec + 1;
+            releaseEmptySlabs( number_of_purged_elements );
+
+            return number_of_purged_elements;
+        }
+
+        // number of elements (values with at least one key)
+        size_t size() const { return m_size; }
+
+        // call function( std::shared_ptr<VALUE_CLASS>& ) for each element, it must not change the map
+        template < typename FUNCTION >
+        void forEachElement( FUNCTION function )
+        {
+            for ( size_t slot = 0; slot < m_values.size(); slot++ )
+            {
+                if ( m_values[slot] ) function( m_values[slot] );
+            }
+        }
+
+        // each key of each element is in its index and points to the element, each index entry is a key of an element
+        bool sanityCheck() const
+        {
+            size_t number_of_elements(0);
+
+            for ( size_t slot = 0; slot < m_values.size(); slot++ )
+            {
+                if ( !m_values[slot] ) continue;
+
+                ++number_of_elements;
+
+                if ( m_values[slot]->m_slot != slot || !m_values[slot]->hasKeys() || !checkKeys<0>( *m_values[slot] ) ) return false;
+            }
+
+            return number_of_elements == m_size && checkIndexSizes<0>( 0 ) && checkExpiry();
+        }
+
+    private:
+        // values by slot (NULL: free slot)
+        std::vector< std::shared_ptr<VALUE_CLASS> > m_values;
+        std::vector< UInt32 > m_free_slots;
+        size_t m_size;
+
+        // one flat index for each key type
+        std::tuple< FlatIndex<KEY_CLASSES>... > m_indexes;
+
+        // expiry wheel: first element slot of each bucket, second of the next bucket to purge
+        std::vector< UInt32 > m_expiry_buckets;
+        UInt32 m_expiry_cursor_sec;
+
+        // values of createElement (optional)
+        std::shared_ptr<SlabPool> m_slab_pool;
+
+        // SNAPSHOT helpers
+        static const size_t SNAPSHOT_KEYS_OFFSET = ( sizeof(SnapshotRecord) + sizeof...(KEY_CLASSES) + 7 ) & ~size_t(7);
+        static const size_t SNAPSHOT_MIN_ELEMENTS_PER_THREAD = 4096;
+
+        // records [begin, end) to values, false if a record is out of the file
+        bool decodeSnapshotRecords( const UInt8* file_data, const SnapshotHeader& header, const SnapshotDecoder& decoder
+                                  , std::vector< std::shared_ptr<VALUE_CLASS> >& values, size_t begin, size_t end )
+        {
+            const UInt64* offsets = reinterpret_cast<const UInt64*>( file_data + header.offsets_offset );
+
+            // offsets are read from the file: bounds are checked by subtraction, a sum could wrap
+            if ( header.offsets_offset < SNAPSHOT_KEYS_OFFSET ) return false;
+
+            for ( size_t i = begin; i < end; i++ )
+            {
+                UInt64 offset = offsets[i];
+                if ( offset < sizeof(SnapshotHeader) || offset > header.offsets_offset - SNAPSHOT_KEYS_OFFSET ) return false;
+
+                const UInt8* data = file_data + offset;
+                const SnapshotRecord& record = *reinterpret_cast<const SnapshotRecord*>( data );
+
+                if ( record.record_length > header.offsets_offset - offset ) return false;
+
+                // number of keys of each index
+                const UInt8* number_of_keys = data + sizeof(SnapshotRecord);
+                size_t keys_length = 0;
+                if ( !getSnapshotRecordKeysLength<0>( number_of_keys, keys_length ) ) return false;
+
+                if ( SNAPSHOT_KEYS_OFFSET + keys_length + UInt64( record.payload_length ) > record.record_length ) return false;
+
+                const UInt8* payload = data + SNAPSHOT_KEYS_OFFSET + keys_length;
+
+                std::shared_ptr<VALUE_CLASS> val( decoder ? decoder( payload, record.payload_length ) : createElement() );
+                if ( !val ) continue;
+
+                readSnapshotKeys<0>( *val, number_of_keys, data + SNAPSHOT_KEYS_OFFSET );
+
+                val->m_last_activity_time_sec  = record.last_activity_time_sec;
+                val->m_last_activity_time_nsec = record.last_activity_time_nsec;
+
+                values[i] = val;
+            }
+
+            return true;
+        }
+
+        // purged values not held elsewhere are back in their slabs
+        void releaseEmptySlabs( size_t number_of_purged_elements )
+        {
+            if ( m_slab_pool && number_of_purged_elements ) m_slab_pool->releaseEmptySlabs( NUMBER_OF_KEPT_EMPTY_SLABS );
+        }
+
+        void store( std::shared_ptr<VALUE_CLASS>& val )
+        {
+            if ( m_free_slots.empty() )
+            {
+                val->m_slot = UInt32( m_values.size() );
+                m_values.push_back( val );
+            }
+            else
+            {
+                val->m_slot = m_free_slots.back();
+                m_free_slots.pop_back();
+                m_values[val->m_slot] = val;
+            }
+
+            ++m_size;
+
+            fileExpiry( *val );
+        }
+
+        void release( std::shared_ptr<VALUE_CLASS>& val )
+        {
+            // val may be the stored pointer itself: keep the element alive until the end
+            std::shared_ptr<VALUE_CLASS> released_val;
+
+            unlinkExpiry( *val );
+            released_val.swap( m_values[val->m_slot] );
+
+            m_free_slots.push_back( released_val->m_slot );
+            released_val->m_slot = ValueBase::NOT_IN_MAP;
+
+            --m_size;
+        }
+
+        // seconds behind the cursor are in the cursor bucket (purged at the next call)
+        inline UInt32 getExpiryBucket( const UInt32& last_activity_time_sec ) const
+        {
+            UInt32 second = last_activity_time_sec < m_expiry_cursor_sec ? m_expiry_cursor_sec : last_activity_time_sec;
+            return second & ( EXPIRY_WHEEL_SIZE - 1 );
+        }
+
+        // (re)link element in the bucket of its last activity, elements never touched (time 0) do not expire
+        void fileExpiry( ValueBase& val )
+        {
+            UInt32 bucket = val.m_last_activity_time_sec ? getExpiryBucket( val.m_last_activity_time_sec ) : ValueBase::NOT_IN_MAP;
+
+            if ( bucket == val.m_expiry_bucket ) return;
+
+            unlinkExpiry( val );
+
+            if ( bucket == ValueBase::NOT_IN_MAP ) return;
+
+            val.m_expiry_bucket = bucket;
+            val.m_expiry_prev   = ValueBase::NOT_IN_MAP;
+            val.m_expiry_next   = m_expiry_buckets[bucket];
+
+            if ( val.m_expiry_next != ValueBase::NOT_IN_MAP ) m_values[val.m_expiry_next]->m_expiry_prev = val.m_slot;
+            m_expiry_buckets[bucket] = val.m_slot;
+        }
+
+        void unlinkExpiry( ValueBase& val )
+        {
+            if ( val.m_expiry_bucket == ValueBase::NOT_IN_MAP ) return;
+
+            if ( val.m_expiry_prev != ValueBase::NOT_IN_MAP ) m_values[val.m_expiry_prev]->m_expiry_next = val.m_expiry_next;
+            else                                              m_expiry_buckets[val.m_expiry_bucket]  = val.m_expiry_next;
+
+            if ( val.m_expiry_next != ValueBase::NOT_IN_MAP ) m_values[val.m_expiry_next]->m_expiry_prev = val.m_expiry_prev;
+
+            val.m_expiry_bucket = ValueBase::NOT_IN_MAP;
+            val.m_expiry_prev   = ValueBase::NOT_IN_MAP;
+            val.m_expiry_next   = ValueBase::NOT_IN_MAP;
+        }
+
+        // each element in a bucket list points back to the bucket and to the previous element
+        bool checkExpiry() const
+        {
+            size_t number_of_linked_elements(0);
+
+            for ( UInt32 bucket = 0; bucket < EXPIRY_WHEEL_SIZE; bucket++ )
+            {
+                UInt32 prev = ValueBase::NOT_IN_MAP;
+
+                for ( UInt32 slot = m_expiry_buckets[bucket]; slot != ValueBase::NOT_IN_MAP; slot = m_values[slot]->m_expiry_next )
+                {
+                    if ( slot >= m_values.size() || !m_values[slot] ) return false;
+
+                    const ValueBase& val = *m_values[slot];
+                    if ( val.m_expiry_bucket != bucket || val.m_expiry_prev != prev ) return false;
+
+                    prev = slot;
+                    ++number_of_linked_elements;
+                }
+            }
+
+            return number_of_linked_elements <= m_size;
+        }
+
+        static bool isExpired( const VALUE_CLASS& val, const UInt32& current_time_sec, const UInt32& max_inactivity_time_sec )
+        {
+            return val.m_last_activity_time_sec
+                && current_time_sec > val.m_last_activity_time_sec
+                && current_time_sec - val.m_last_activity_time_sec > max_inactivity_time_sec;
+        }
+
+        // ALL INDEXES helpers (recursion on KEY_NUMBER)
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ), size_t >::type getSnapshotKeysLength( const VALUE_CLASS& val ) const
+        {
+            return std::get<KEY_NUMBER>( val.ValueBase::m_keys ).number_of_keys * sizeof( typename Key<KEY_NUMBER>::Type ) + getSnapshotKeysLength<KEY_NUMBER + 1>( val );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ), size_t >::type getSnapshotKeysLength( const VALUE_CLASS& ) const { return 0; }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ) >::type writeSnapshotKeys( const VALUE_CLASS& val, UInt8* number_of_keys, UInt8* keys ) const
+        {
+            static_assert( IsMemcpyKey< typename Key<KEY_NUMBER>::Type >::value, "snapshot keys are copied with memcpy: KEY_CLASSES must be trivially copyable" );
+
+            const KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val.ValueBase::m_keys );
+            size_t keys_length = key_slots.number_of_keys * sizeof( typename Key<KEY_NUMBER>::Type );
+
+            number_of_keys[KEY_NUMBER] = UInt8( key_slots.number_of_keys );
+            if ( keys_length ) std::memcpy( keys, key_slots.keys, keys_length );
+
+            writeSnapshotKeys<KEY_NUMBER + 1>( val, number_of_keys, keys + keys_length );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ) >::type writeSnapshotKeys( const VALUE_CLASS&, UInt8*, UInt8* ) const {}
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ), bool >::type getSnapshotRecordKeysLength( const UInt8* number_of_keys, size_t& keys_length ) const
+        {
+            if ( number_of_keys[KEY_NUMBER] > ValueBase::MAX_KEYS_PER_INDEX ) return false;
+
+            keys_length += number_of_keys[KEY_NUMBER] * sizeof( typename Key<KEY_NUMBER>::Type );
+            return getSnapshotRecordKeysLength<KEY_NUMBER + 1>( number_of_keys, keys_length );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ), bool >::type getSnapshotRecordKeysLength( const UInt8*, size_t& ) const { return true; }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ) >::type readSnapshotKeys( VALUE_CLASS& val, const UInt8* number_of_keys, const UInt8* keys )
+        {
+            static_assert( IsMemcpyKey< typename Key<KEY_NUMBER>::Type >::value, "snapshot keys are copied with memcpy: KEY_CLASSES must be trivially copyable" );
+
+            KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val.ValueBase::m_keys );
+            size_t keys_length = number_of_keys[KEY_NUMBER] * sizeof( typename Key<KEY_NUMBER>::Type );
+
+            key_slots.number_of_keys = number_of_keys[KEY_NUMBER];
+            if ( keys_length ) std::memcpy( key_slots.keys, keys, keys_length );
+            val.m_number_of_keys += key_slots.number_of_keys;
+
+            readSnapshotKeys<KEY_NUMBER + 1>( val, number_of_keys, keys + keys_length );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ) >::type readSnapshotKeys( VALUE_CLASS&, const UInt8*, const UInt8* ) {}
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ) >::type setSnapshotKeySizes( UInt32* key_sizes ) const
+        {
+            key_sizes[KEY_NUMBER] = UInt32( sizeof( typename Key<KEY_NUMBER>::Type ) );
+            setSnapshotKeySizes<KEY_NUMBER + 1>( key_sizes );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ) >::type setSnapshotKeySizes( UInt32* ) const {}
+
+        // a thread for each index, all slots are assigned
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ) >::type buildSnapshotIndexes( std::vector<std::thread>& threads )
+        {
+            threads.push_back( std::thread( [this]()
+            {
+                FlatIndex< typename Key<KEY_NUMBER>::Type >& index = std::get<KEY_NUMBER>( m_indexes );
+
+                // sized once
+                size_t number_of_keys = 0;
+                for ( size_t slot = 0; slot < m_values.size(); slot++ ) number_of_keys += std::get<KEY_NUMBER>( m_values[slot]->ValueBase::m_keys ).number_of_keys;
+                index.reserve( number_of_keys );
+
+                for ( size_t slot = 0; slot < m_values.size(); slot++ )
+                {
+                    const KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( m_values[slot]->ValueBase::m_keys );
+
+                    for ( size_t i = 0; i < key_slots.number_of_keys; i++ ) index.set( key_slots.keys[i], UInt32( slot ) );
+                }
+            } ) );
+
+            buildSnapshotIndexes<KEY_NUMBER + 1>( threads );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ) >::type buildSnapshotIndexes( std::vector<std::thread>& ) {}
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ) >::type reserveIndexes( size_t number_of_keys )
+        {
+            std::get<KEY_NUMBER>( m_indexes ).reserve( number_of_keys );
+            reserveIndexes<KEY_NUMBER + 1>( number_of_keys );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ) >::type reserveIndexes( size_t ) {}
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ) >::type remAllKeys( std::shared_ptr<VALUE_CLASS>& val )
+        {
+            remKeys<KEY_NUMBER>( val );
+            remAllKeys<KEY_NUMBER + 1>( val );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ) >::type remAllKeys( std::shared_ptr<VALUE_CLASS>& ) {}
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ), bool >::type checkKeys( const VALUE_CLASS& val ) const
+        {
+            const KeySlots< typename Key<KEY_NUMBER>::Type, ValueBase::MAX_KEYS_PER_INDEX >& key_slots = std::get<KEY_NUMBER>( val.ValueBase::m_keys );
+
+            for ( size_t i = 0; i < key_slots.number_of_keys; i++ )
+            {
+                if ( std::get<KEY_NUMBER>( m_indexes ).find( key_slots.keys[i] ) != val.m_slot ) return false;
+            }
+
+            return checkKeys<KEY_NUMBER + 1>( val );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ), bool >::type checkKeys( const VALUE_CLASS& ) const { return true; }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER < sizeof...(KEY_CLASSES) ), bool >::type checkIndexSizes( size_t ) const
+        {
+            size_t number_of_keys(0);
+
+            for ( size_t slot = 0; slot < m_values.size(); slot++ )
+            {
+                if ( m_values[slot] ) number_of_keys += std::get<KEY_NUMBER>( m_values[slot]->ValueBase::m_keys ).number_of_keys;
+            }
+
+            return number_of_keys == std::get<KEY_NUMBER>( m_indexes ).size() && checkIndexSizes<KEY_NUMBER + 1>( 0 );
+        }
+
+        template < size_t KEY_NUMBER >
+        typename std::enable_if< ( KEY_NUMBER == sizeof...(KEY_CLASSES) ), bool >::type checkIndexSizes( size_t ) const { return true; }
+    };
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    template <typename KEY_CLASS>
+    const UInt32 FlatIndex<KEY_CLASS>::EMPTY_SLOT;
+
+    template <typename... KEY_CLASSES>
+    const size_t ValueEvo<KEY_CLASSES...>::MAX_KEYS_PER_INDEX;
+
+    template <typename... KEY_CLASSES>
+    const UInt32 ValueEvo<KEY_CLASSES...>::NOT_IN_MAP;
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    const size_t MultiKeyMapEvo<VALUE_CLASS, KEY_CLASSES...>::NUMBER_OF_INDEXES;
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    const UInt32 MultiKeyMapEvo<VALUE_CLASS, KEY_CLASSES...>::EXPIRY_WHEEL_SIZE;
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    const size_t MultiKeyMapEvo<VALUE_CLASS, KEY_CLASSES...>::NUMBER_OF_KEPT_EMPTY_SLABS;
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    const size_t MultiKeyMapEvo<VALUE_CLASS, KEY_CLASSES...>::SNAPSHOT_KEYS_OFFSET;
+
+    template <typename VALUE_CLASS, typename... KEY_CLASSES>
+    const size_t MultiKeyMapEvo<VALUE_CLASS, KEY_CLASSES...>::SNAPSHOT_MIN_ELEMENTS_PER_THREAD;
+} // namespace MultiKeyMap
+} // namespace QAppNG
+
+// --------------------------------------------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,255 @@
+/** ===================================================================================================================
+* @file    MultiKeyMapSnapshot Cpp FILE
+*
+* @brief   memory mapped snapshot files of MultiKeyMapEvo (warm restart)
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-042   QAppNG Team                                                      Oct-2026      Original Development
+* #user-042   QAppNG Team                                                      Oct-2026      fsync of the directory after the rename
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include "MultiKeyMapSnapshot.h"
+#include <cstdio>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+namespace MultiKeyMap
+{
+    // first mapping of a new snapshot file
+    static const UInt64 SNAPSHOT_INITIAL_SIZE = 16 * 1024 * 1024;
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SnapshotWriter::SnapshotWriter()
+        : m_file_descriptor( -1 )
+        , m_data( NULL )
+        , m_size( 0 )
+        , m_length( 0 )
+    {
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SnapshotWriter::~SnapshotWriter()
+    {
+        abort();
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool SnapshotWriter::open( const std::string& file_name )
+    {
+        abort();
+
+        m_file_name     = file_name;
+        m_tmp_file_name = file_name + ".tmp";
+
+#ifndef WIN32
+        m_file_descriptor = ::open( m_tmp_file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+        if ( m_file_descriptor < 0 ) return false;
+
+        if ( !grow( SNAPSHOT_INITIAL_SIZE ) )
+        {
+            abort();
+            return false;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    UInt8* SnapshotWriter::append( size_t length )
+    {
+        if ( !m_data ) return NULL;
+
+        if ( m_length + length > m_size && !grow( m_length + length ) ) return NULL;
+
+        UInt8* data = m_data + m_length;
+        m_length += length;
+
+        return data;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool SnapshotWriter::commit()
+    {
+        if ( !m_data ) return false;
+
+#ifndef WIN32
+        bool done = ::msync( m_data, size_t( m_size ), MS_SYNC ) == 0;
+        unmap();
+
+        done = done && ::ftruncate( m_file_descriptor, off_t( m_length ) ) == 0;
+        done = done && ::fsync( m_file_descriptor ) == 0;
+
+        ::close( m_file_descriptor );
+        m_file_descriptor = -1;
+
+        done = done && ::rename( m_tmp_file_name.c_str(), m_file_name.c_str() ) == 0;
+        if ( !done )
+        {
+            ::unlink( m_tmp_file_name.c_str() );
+            return false;
+        }
+
+        // the rename is durable once the directory entry is on disk
+        size_t slash_position = m_file_name.rfind( '/' );
+        std::string directory_name( slash_position == std::string::npos ? "." : slash_position == 0 ? "/" : m_file_name.substr( 0, slash_position ) );
+
+        int directory_descriptor = ::open( directory_name.c_str(), O_RDONLY | O_DIRECTORY );
+        if ( directory_descriptor < 0 ) return false;
+
+        done = ::fsync( directory_descriptor ) == 0;
+        ::close( directory_descriptor );
+
+        return done;
+#else
+        return false;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void SnapshotWriter::abort()
+    {
+#ifndef WIN32
+        unmap();
+
+        if ( m_file_descriptor >= 0 )
+        {
+            ::close( m_file_descriptor );
+            ::unlink( m_tmp_file_name.c_str() );
+        }
+#endif
+
+        m_file_descriptor = -1;
+        m_length          = 0;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool SnapshotWriter::grow( UInt64 min_size )
+    {
+#ifndef WIN32
+        UInt64 size = m_size ? m_size : SNAPSHOT_INITIAL_SIZE;
+        while ( size < min_size ) size *= 2;
+
+        unmap();
+
+        if ( ::ftruncate( m_file_descriptor, off_t( size ) ) != 0 ) return false;
+
+        void* data = ::mmap( NULL, size_t( size ), PROT_READ | PROT_WRITE, MAP_SHARED, m_file_descriptor, 0 );
+        if ( data == MAP_FAILED ) return false;
+
+        m_data = static_cast<UInt8*>( data );
+        m_size = size;
+
+        return true;
+#else
+        UNUSED( min_size );
+        return false;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void SnapshotWriter::unmap()
+    {
+#ifndef WIN32
+        if ( m_data ) ::munmap( m_data, size_t( m_size ) );
+#endif
+
+        m_data = NULL;
+        m_size = 0;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SnapshotReader::SnapshotReader()
+        : m_file_descriptor( -1 )
+        , m_data( NULL )
+        , m_size( 0 )
+    {
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SnapshotReader::~SnapshotReader()
+    {
+        close();
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool SnapshotReader::open( const std::string& file_name )
+    {
+        close();
+
+#ifndef WIN32
+        m_file_descriptor = ::open( file_name.c_str(), O_RDONLY );
+        if ( m_file_descriptor < 0 ) return false;
+
+        struct stat file_status;
+        if ( ::fstat( m_file_descriptor, &file_status ) != 0 || file_status.st_size <= 0 )
+        {
+            close();
+            return false;
+        }
+
+        void* data = ::mmap( NULL, size_t( file_status.st_size ), PROT_READ, MAP_SHARED, m_file_descriptor, 0 );
+        if ( data == MAP_FAILED )
+        {
+            close();
+            return false;
+        }
+
+        m_data = static_cast<UInt8*>( data );
+        m_size = UInt64( file_status.st_size );
+
+        // read once from the beginning to the end by the decoding threads
+        ::madvise( data, size_t( m_size ), MADV_WILLNEED );
+
+        return true;
+#else
+        UNUSED( file_name );
+        return false;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void SnapshotReader::close()
+    {
+#ifndef WIN32
+        if ( m_data ) ::munmap( m_data, size_t( m_size ) );
+        if ( m_file_descriptor >= 0 ) ::close( m_file_descriptor );
+#endif
+
+        m_file_descriptor = -1;
+        m_data            = NULL;
+        m_size            = 0;
+    }
+} // namespace MultiKeyMap
+} // namespace QAppNG
+
+// --------------------------------------------------------------------------------------------------------------------
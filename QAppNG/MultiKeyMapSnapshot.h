@@ -0,0 +1,151 @@
+/** ===================================================================================================================
+* @file    MultiKeyMapSnapshot HEADER FILE
+*
+* @brief   memory mapped snapshot files of MultiKeyMapEvo (warm restart): file layout and writer/reader.
+*
+*          File: SnapshotHeader, one record per element (8 bytes aligned), offsets of the records (UInt64 each,
+*          so the records can be decoded by many threads). A record is SnapshotRecord, the number of keys of
+*          each index (one byte per index, 8 bytes aligned), the keys of index 0, 1, ... and the payload written
+*          by the user encoder.
+*
+*          The writer fills file_name.tmp and renames it only when complete: a crash while writing leaves the
+*          previous snapshot.
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-042   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_MULTI_KEY_MAP_SNAPSHOT_H
+#define QAPPNG_MULTI_KEY_MAP_SNAPSHOT_H
+
+// Include STL
+#include <string>
+#include <utility>
+#include <type_traits>
+
+// other Includes
+#include <QAppNG/core.h>
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+namespace MultiKeyMap
+{
+    // --------------------------------------------------------------------------------------------------------
+
+    // keys that can be copied with memcpy (snapshot files, seqlock readers): trivially copyable types and
+    // std::pair of them (not trivially copyable only because of its assignment operator)
+    template <typename KEY_CLASS>
+    struct IsMemcpyKey : std::is_trivially_copyable<KEY_CLASS> {};
+
+    template <typename FIRST, typename SECOND>
+    struct IsMemcpyKey< std::pair<FIRST, SECOND> >
+        : std::integral_constant< bool, IsMemcpyKey<FIRST>::value && IsMemcpyKey<SECOND>::value > {};
+
+    // --------------------------------------------------------------------------------------------------------
+
+    struct SnapshotHeader
+    {
+        // "QMKMSNAP"
+        static const UInt64 MAGIC                   = 0x50414E534D4B4D51ULL;
+        static const UInt32 VERSION                 = 1;
+        static const size_t MAX_NUMBER_OF_INDEXES   = 16;
+
+        UInt64  magic;
+        UInt32  version;
+        UInt32  number_of_indexes;
+        UInt32  max_keys_per_index;
+        UInt32  expiry_cursor_sec;
+        UInt32  key_sizes[MAX_NUMBER_OF_INDEXES];
+        UInt64  number_of_elements;
+        UInt64  offsets_offset;
+        UInt64  file_size;
+    };
+
+    struct SnapshotRecord
+    {
+        UInt32  record_length;
+        UInt32  payload_length;
+        UInt32  last_activity_time_sec;
+        UInt32  last_activity_time_nsec;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief append-only writer on a memory mapped file that grows (doubling) while it is written
+    */
+    class SnapshotWriter
+    {
+    public:
+        SnapshotWriter();
+
+        // DTOR: a snapshot not committed is removed
+        virtual ~SnapshotWriter();
+
+        // create file_name.tmp
+        bool open( const std::string& file_name );
+
+        // room for length bytes at the end of the file, NULL if the file can not grow.
+        // The pointer is valid until the next append
+        UInt8* append( size_t length );
+
+        // bytes already written
+        UInt8* at( UInt64 offset ) { return m_data + offset; }
+        UInt64 getLength() const { return m_length; }
+
+        // flush to disk, rename file_name.tmp to file_name and flush the directory
+        bool commit();
+        void abort();
+
+    private:
+        SnapshotWriter( const SnapshotWriter& ) = delete;
+        SnapshotWriter& operator=( const SnapshotWriter& ) = delete;
+
+        bool grow( UInt64 min_size );
+        void unmap();
+
+        std::string m_file_name;
+        std::string m_tmp_file_name;
+        int         m_file_descriptor;
+        UInt8*      m_data;
+        UInt64      m_size;
+        UInt64      m_length;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief read-only mapping of a whole snapshot file
+    */
+    class SnapshotReader
+    {
+    public:
+        SnapshotReader();
+        virtual ~SnapshotReader();
+
+        bool open( const std::string& file_name );
+        void close();
+
+        const UInt8* getData() const { return m_data; }
+        UInt64 getSize() const { return m_size; }
+
+    private:
+        SnapshotReader( const SnapshotReader& ) = delete;
+        SnapshotReader& operator=( const SnapshotReader& ) = delete;
+
+        int         m_file_descriptor;
+        UInt8*      m_data;
+        UInt64      m_size;
+    };
+} // namespace MultiKeyMap
+} // namespace QAppNG
+
+// --------------------------------------------------------------------------------------------------------
+#endif
@@ -12,6 +12,10 @@
   * #4732       Alessandro Della Villa                                           Mar-2010      Original development
   * #5774       Stanislav Timinsky                                               Jan-2011      Added shutdown method
   * #6439       Alessandro Della Villa                                           Oct-2011      Added getPointerToMaster
+  * #user-028   QAppNG Team                                                      Oct-2026      Broadcast follows elastic works
+  * #user-029   QAppNG Team                                                      Oct-2026      Process functions use WorkHandle
+  * #user-032   QAppNG Team                                                      Oct-2026      Priority lane by QObservableType
+  * #user-033   QAppNG Team                                                      Oct-2026      threadBroadcast through the broadcast channel
   *
   * @endhistory
   * ===================================================================================================================
@@ -19,6 +23,8 @@
 
 // Include STL & BOOST
 #include <memory>
+#include <bitset>
+#include <type_traits>
 
 // Other Includes
 #include <QAppNG/core.h>
@@ -60,6 +66,9 @@ namespace QAppNG
             : m_work_started(false)
             , m_process_function(DoNothing)
             , m_process_function_with_thread_routing(DoNothing)
+            , m_priority_process_function(DoNothing)
+            , m_priority_process_function_with_thread_routing(DoNothing)
+            , m_broadcast_function(DoNothing)
             , m_processed_entities(0)
             , m_init_done(false)
         {
@@ -72,33 +81,60 @@ namespace QAppNG
         template <typename PROCESSING_ENTITY_DERIVED_CLASS>
         void start( std::string work_name, std::shared_ptr<WorkDataClass> work_setup = std::shared_ptr<WorkDataClass>( new WorkDataClass ) )
         {
+            /** Start the WORK passing a shared pointer to the current instance as INIT parameter 
+            *
+            *   (all threads run doWork() method of other instances)
+            *   Work manager first try to load configuration from WorkManagerConfigxml. If it fails the uses work_setup class
+            */
+            if ( !WorkManager::instance().startWork<PROCESSED_ENTITY, PROCESSING_ENTITY_DERIVED_CLASS>( work_name, m_workmanager_config_file, this->shared_from_this() ) )
+            {
+                WorkManager::instance().startWork<PROCESSED_ENTITY, PROCESSING_ENTITY_DERIVED_CLASS>
+                    ( work_name, work_setup, this->shared_from_this() );
+            }
+
+            // STORE typed work handle: process functions below go straight to the work (no lookup)
+            typedef WorkHandle<PROCESSED_ENTITY, PROCESSING_ENTITY_DERIVED_CLASS> WorkHandleType;
+
+            std::shared_ptr<WorkHandleType> work_handle( new WorkHandleType(
+                WorkManager::instance().getWorkHandle<PROCESSED_ENTITY, PROCESSING_ENTITY_DERIVED_CLASS>( work_name ) ) );
+            m_work_handle = work_handle;
+
             /** Set the PROCESS FUNCTION
             *
             *   m_process_function will be called in the SAME INSTANCE that now is running this start method, let's say the
             *   MASTER instance.
             */
-            fastdelegate::FastDelegate2<size_t, std::shared_ptr<PROCESSED_ENTITY>&, bool> _process_function
-                ( WorkManager::Instance().getPtr(), &WorkManager::addConsumable<PROCESSED_ENTITY, PROCESSING_ENTITY_DERIVED_CLASS> );
+            fastdelegate::FastDelegate1<std::shared_ptr<PROCESSED_ENTITY>&, bool> _process_function
+                ( work_handle.get(), &WorkHandleType::addConsumable );
             m_process_function = _process_function;
 
             /** Set the PROCESS FUNCTION WITH THREAD ROUTING
             *
-            *   the same of process_function but point to the WorkManager method that uses custom thread routing
+            *   the same of process_function but point to the WorkHandle method that uses custom thread routing
             */
-            fastdelegate::FastDelegate4<size_t, std::shared_ptr<PROCESSED_ENTITY>&, UInt64, bool, bool> _process_function_with_thread_routing
-                ( WorkManager::Instance().getPtr(), &WorkManager::addConsumable<PROCESSED_ENTITY, PROCESSING_ENTITY_DERIVED_CLASS> );
+            fastdelegate::FastDelegate3<std::shared_ptr<PROCESSED_ENTITY>&, UInt64, bool, bool> _process_function_with_thread_routing
+                ( work_handle.get(), &WorkHandleType::addConsumable );
             m_process_function_with_thread_routing = _process_function_with_thread_routing;
 
-            /** Start the WORK passing a shared pointer to the current instance as INIT parameter 
+            /** Set the PRIORITY PROCESS FUNCTIONs
             *
-            *   (all threads run doWork() method of other instances)
-            *   Work manager first try to load configuration from WorkManagerConfigxml. If it fails the uses work_setup class
+            *   used for entities whose QObservableType was marked with setPriorityObservableType
             */
-            if ( !WorkManager::instance().startWork<PROCESSED_ENTITY, PROCESSING_ENTITY_DERIVED_CLASS>( work_name, m_workmanager_config_file, this->shared_from_this() ) )
-            {
-                WorkManager::instance().startWork<PROCESSED_ENTITY, PROCESSING_ENTITY_DERIVED_CLASS>
-                    ( work_name, work_setup, this->shared_from_this() );
-            }
+            fastdelegate::FastDelegate1<std::shared_ptr<PROCESSED_ENTITY>&, bool> _priority_process_function
+                ( work_handle.get(), &WorkHandleType::addPriorityConsumable );
+            m_priority_process_function = _priority_process_function;
+
+            fastdelegate::FastDelegate3<std::shared_ptr<PROCESSED_ENTITY>&, UInt64, bool, bool> _priority_process_function_with_thread_routing
+                ( work_handle.get(), &WorkHandleType::addPriorityConsumable );
+            m_priority_process_function_with_thread_routing = _priority_process_function_with_thread_routing;
+
+            /** Set the BROADCAST FUNCTION
+            *
+            *   one call for all workers (broadcast channel of the work, if any)
+            */
+            fastdelegate::FastDelegate1<std::shared_ptr<PROCESSED_ENTITY>&, bool> _broadcast_function
+                ( work_handle.get(), &WorkHandleType::broadcastConsumable );
+            m_broadcast_function = _broadcast_function;
 
             //Store Work Name
             m_work_name = work_name;
@@ -145,20 +181,33 @@ namespace QAppNG
             // get routing key (we are running in the MASTER instance)
             UInt64 routing_key( getRoutingKey(processed_entity) );
 
+            // control events go in the workers priority lane
+            bool priority( m_priority_observable_types.any() && isPriorityEntity( processed_entity, std::is_base_of<QObservable, PROCESSED_ENTITY>() ) );
+
             if (m_number_of_workers > 0 && routing_key != QAppNG::AUTOMATIC_ROUTING_KEY_VALUE && routing_key != QAppNG::BROADCAST_ROUTING_KEY_VALUE)
             {
-                threadSend( routing_key, processed_entity );
+                threadSend( routing_key, processed_entity, priority );
             }
             else if (m_number_of_workers > 0 && routing_key == QAppNG::BROADCAST_ROUTING_KEY_VALUE)
             {
-                threadBroadcast( processed_entity );
+                threadBroadcast( processed_entity, priority );
             }
             else
             {
-                threadSend( processed_entity );
+                threadSend( processed_entity, priority );
             }
         }
 
+        /**
+        *  Entities (QObservable only) of the given type are processed before the others queued for the same worker,
+        *  e.g. context deletes, CELL_CONTEXT_CONFIG, QVIRTUALCLOCK_TIME_PULSE. They can overtake entities processed before.
+        *  Call it on the MASTER instance before feeding it.
+        */
+        void setPriorityObservableType( QObservableType observable_type, bool priority = true )
+        {
+            m_priority_observable_types.set( observable_type, priority );
+        }
+
         //FIX UGLY WORKAROUND
         inline void process_ent(std::shared_ptr<PROCESSED_ENTITY>& processed_entity)
         {
@@ -204,28 +253,42 @@ namespace QAppNG
         // --------------------------------------------------------------------------------------------------------------------
 
         // THREAD BROADCAST
-        inline void threadBroadcast(std::shared_ptr<PROCESSED_ENTITY>& processed_entity)
+        inline void threadBroadcast(std::shared_ptr<PROCESSED_ENTITY>& processed_entity, bool priority = false)
         {
+            // the broadcast is written once (each worker gets its own copy of the shared pointer)
+            if ( !priority )
+            {
+                m_broadcast_function( processed_entity );
+                return;
+            }
+
+            // priority lane: one consumable per worker. elastic works: the number of workers can change at runtime
+            m_number_of_workers = WorkManager::instance().getNumberOfWorkers( m_work_id );
+
             for ( UInt64 tid=0; tid < m_number_of_workers; tid++)
             {
-                m_process_function_with_thread_routing( m_work_id, processed_entity, tid, true );
+                m_priority_process_function_with_thread_routing( processed_entity, tid, true );
             }
         }
 
         // --------------------------------------------------------------------------------------------------------------------
 
         // THREAD SEND WITH CUSTOM ROUTING
-        inline void threadSend(UInt64 routing_key,  std::shared_ptr<PROCESSED_ENTITY>& processed_entity)
+        inline void threadSend(UInt64 routing_key,  std::shared_ptr<PROCESSED_ENTITY>& processed_entity, bool priority = false)
         {
-            m_process_function_with_thread_routing( m_work_id, processed_entity, routing_key, false );
+            ( priority )
+                ? m_priority_process_function_with_thread_routing( processed_entity, routing_key, false )
+                : m_process_function_with_thread_routing( processed_entity, routing_key, false );
         }
 
         // --------------------------------------------------------------------------------------------------------------------
 
         // THREAD SEND WITH AUTOMATIC ROUTING
-        inline void threadSend(std::shared_ptr<PROCESSED_ENTITY>& processed_entity)
+        inline void threadSend(std::shared_ptr<PROCESSED_ENTITY>& processed_entity, bool priority = false)
         {
-            m_process_function( m_work_id, processed_entity );
+            ( priority )
+                ? m_priority_process_function( processed_entity )
+                : m_process_function( processed_entity );
         }
 
         // --------------------------------------------------------------------------------------------------------------------
@@ -285,15 +348,41 @@ namespace QAppNG
             return QAppNG::AUTOMATIC_ROUTING_KEY_VALUE;
         }
 
+        // priority lane selection by QObservableType (only for entities derived from QObservable)
+        bool isPriorityEntity( std::shared_ptr<PROCESSED_ENTITY>& processed_entity, std::true_type )
+        {
+            QObservableType observable_type( processed_entity->GetType() );
+            return observable_type < MAX_NUMBER_OF_OBSERVABLES && m_priority_observable_types.test( observable_type );
+        }
+
+        bool isPriorityEntity( std::shared_ptr<PROCESSED_ENTITY>& processed_entity, std::false_type )
+        {
+            UNUSED( processed_entity );
+            return false;
+        }
+
         // Dummy Functions to init the processing delegates
-        static bool DoNothing(size_t, std::shared_ptr<PROCESSED_ENTITY>&) { return true; }
-        static bool DoNothing(size_t, std::shared_ptr<PROCESSED_ENTITY>&, UInt64, bool) { return true; }
+        static bool DoNothing(std::shared_ptr<PROCESSED_ENTITY>&) { return true; }
+        static bool DoNothing(std::shared_ptr<PROCESSED_ENTITY>&, UInt64, bool) { return true; }
+
+        // typed WorkHandle (its type depends on the derived class, see start)
+        std::shared_ptr<void> m_work_handle;
 
         // pointer to PROCESS method
-        fastdelegate::FastDelegate2<size_t, std::shared_ptr<PROCESSED_ENTITY>&, bool> m_process_function;
+        fastdelegate::FastDelegate1<std::shared_ptr<PROCESSED_ENTITY>&, bool> m_process_function;
 
         // pointer to PROCESS method that uses thread routing
-        fastdelegate::FastDelegate4<size_t, std::shared_ptr<PROCESSED_ENTITY>&, UInt64, bool, bool> m_process_function_with_thread_routing;
+        fastdelegate::FastDelegate3<std::shared_ptr<PROCESSED_ENTITY>&, UInt64, bool, bool> m_process_function_with_thread_routing;
+
+        // pointers to PROCESS methods that use the priority lane
+        fastdelegate::FastDelegate1<std::shared_ptr<PROCESSED_ENTITY>&, bool> m_priority_process_function;
+        fastdelegate::FastDelegate3<std::shared_ptr<PROCESSED_ENTITY>&, UInt64, bool, bool> m_priority_process_function_with_thread_routing;
+
+        // pointer to BROADCAST method
+        fastdelegate::FastDelegate1<std::shared_ptr<PROCESSED_ENTITY>&, bool> m_broadcast_function;
+
+        // QObservableTypes processed with priority
+        std::bitset<MAX_NUMBER_OF_OBSERVABLES> m_priority_observable_types;
 
         // pointer to POST PROCESS method
         fastdelegate::FastDelegate2<std::shared_ptr<PROCESSED_ENTITY>&, UInt64, void> m_post_process_function;
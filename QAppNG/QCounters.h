@@ -14,6 +14,7 @@
 * #7671       A. Della Villa, D. Verna, F. Guzzardi                            Sep-2012      removing atomic structures
 * #7988       C.Guidoccio                                                      Dec-2012      Ticket #7988 - use QCounters for QoSAppMonitoring
 * #8547       C.Guidoccio                                                      Apr-2013      Ticket #8547 - QCounters performance
+* #user-050   QAppNG Team                                                      Oct-2026      status dump from one getCounterValues pass
 *
 * @endhistory
 * ===================================================================================================================
@@ -300,6 +301,9 @@ public:
     // ready to be written on status file
     std::string getFormattedCountersWithTitle( const std::string& tagid ) const
     {
+        std::vector<UInt64> counter_values;
+        getCounterValues(counter_values);
+
         std::stringstream titleline (std::stringstream::out | std::stringstream::in );
         std::stringstream valuesline (std::stringstream::out | std::stringstream::in);
         long cur_titleline_pos=0;
@@ -317,7 +321,7 @@ public:
             titleline << "#" << m_counterData[i].title << STATS_FORMAT_SPACER;
             cur_titleline_pos = (long) titleline.tellp();
 
-            valuesline << "#" <<  getCounterValue(i) << STATS_FORMAT_SPACER;
+            valuesline << "#" <<  counter_values[i] << STATS_FORMAT_SPACER;
 
             cur_valuesline_pos = (long) valuesline.tellp();
 
@@ -337,13 +341,16 @@ public:
 
     std::string getFormattedCounters( const std::string& tagid ) const
     {
+        std::vector<UInt64> counter_values;
+        getCounterValues(counter_values);
+
         std::stringstream valuesline (std::stringstream::out | std::stringstream::in);
 
         valuesline << tagid << STATS_FORMAT_SPACER;
 
         for (std::size_t i = 0; i < m_number_of_counters;  i++)
         {
-            valuesline << "#" <<  getCounterValue(i) << STATS_FORMAT_SPACER;
+            valuesline << "#" <<  counter_values[i] << STATS_FORMAT_SPACER;
         }
         return valuesline.str() + "\n";  // std::endl make stream flush...
     }
@@ -351,9 +358,15 @@ public:
     //-------------------------------------------------------------------------
     // returns a formatted string containing title and justified counter value 
     std::string counterToString(size_t counter_index)
+    {
+        return counterToString(counter_index, getCounterValue(counter_index));
+    }
+
+    // same with a value from getCounterValues
+    std::string counterToString(size_t counter_index, UInt64 counter_value)
     {
         std::stringstream counterString (std::stringstream::out | std::stringstream::in);
-        counterString << std::left << std::setw(m_titleMaxLen) << getCounterTitle(counter_index) << " = " << getCounterValue(counter_index);
+        counterString << std::left << std::setw(m_titleMaxLen) << getCounterTitle(counter_index) << " = " << counter_value;
         return counterString.str();
     }
 
@@ -438,6 +451,10 @@ public:
             return dumpString.str();
         }
 
+        // all the values in one pass
+        std::vector<UInt64> counter_values;
+        getCounterValues(counter_values);
+
         for (masterIt = m_sections.begin();  masterIt != m_sections.end();  masterIt = slaveIt)
         {
             std::string theSection = (*masterIt).first;
@@ -461,7 +478,7 @@ public:
                         dumpString << " --- " << theSection << "\n";  // std::endl make stream flush...
                         dumpString << " ------------------------ \n";  // std::endl make stream flush...
                     }
-                    dumpString << counterToString((size_t)theCounterIndex) << "\n";  // std::endl make stream flush...
+                    dumpString << counterToString((size_t)theCounterIndex, counter_values[(size_t)theCounterIndex]) << "\n";  // std::endl make stream flush...
                 }
             }
         }
@@ -499,8 +516,9 @@ private:
         {
             m_counters = new QAppNG::QCountersDataStorageBase(m_number_of_counters, static_cast<size_t>(m_tid)) ;
 
-            // add raw pointer of current thread to vector
-            m_raw_pointers_to_per_thread_local_storage.push_back( m_counters );
+            // add storage of current thread at list head (readers see it complete)
+            m_counters->setNext( m_per_thread_local_storage_list.load( std::memory_order_relaxed ) );
+            m_per_thread_local_storage_list.store( m_counters, std::memory_order_release );
         }
     }
 
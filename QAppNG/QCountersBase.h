@@ -11,6 +11,7 @@
 * REF#        Who                                                              When          What
 * #7988       C.Guidoccio                                                      Dec-2012      Ticket #7988 - refactor from QCounters
 * #8547       C.Guidoccio                                                      Apr-2013      Ticket #8547 - QCounters performance
+* #user-050   QAppNG Team                                                      Oct-2026      cache line padded per thread storage, lock-free list, getCounterValues
 *
 * @endhistory
 * ===================================================================================================================
@@ -22,6 +23,7 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <atomic>
 
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/mutex.hpp>
@@ -36,6 +38,9 @@
 #define DEFAULT_SECTION_NAME "DEFSECT"
 #define MAX_COUNTER_SIZE     100000
 
+// per thread counters are stored in blocks of whole cache lines
+#define COUNTERS_CACHE_LINE_SIZE 64
+
 // --------------------------------------------------------------------------------------------------------------------
 // FIXME[cg]: 
 // class that contains per thread data storage and references to data, not templated
@@ -45,20 +50,37 @@ namespace QAppNG
     {
     public:
         QCountersDataStorageBase(size_t counters_size, size_t q_counter_thread_id )
-            : m_thread_id(0)
+            : m_counters(NULL)
+            , m_thread_id(0)
+            , m_next(NULL)
         {
-            m_dataStorage.resize( counters_size,0 );
+            // counters start on a cache line and fill whole lines: no line is shared with other threads data
+            const size_t words_per_line = COUNTERS_CACHE_LINE_SIZE / sizeof(UInt64);
+            size_t padded_size = ( counters_size + words_per_line - 1 ) / words_per_line * words_per_line;
+
+            m_dataStorage.resize( padded_size + words_per_line - 1, 0 );
+
+            size_t address = reinterpret_cast<size_t>( &m_dataStorage[0] );
+            m_counters = &m_dataStorage[0] + ( ( COUNTERS_CACHE_LINE_SIZE - address % COUNTERS_CACHE_LINE_SIZE ) % COUNTERS_CACHE_LINE_SIZE ) / sizeof(UInt64);
+
             m_thread_id = q_counter_thread_id;
         }
 
+        // owner thread only
         inline UInt64& getCounter(size_t counter_index) 
         {
-            return m_dataStorage[counter_index];
+            return m_counters[counter_index];
+        }
+
+        // other threads (value written by the owner without atomics, read as a whole UInt64)
+        inline UInt64 readCounter(size_t counter_index) const
+        {
+            return static_cast<const volatile UInt64*>( m_counters )[counter_index];
         }
 
         inline void resetCounter(size_t counter_index) 
         {
-            m_dataStorage[counter_index] = 0;
+            static_cast<volatile UInt64*>( m_counters )[counter_index] = 0;
         }
 
         inline UInt64 getThreadId()
@@ -66,9 +88,22 @@ namespace QAppNG
             return m_thread_id;
         }
 
+        // next storage in the list of QCountersBase (set before the storage is added, then never changed)
+        inline QCountersDataStorageBase* getNext() const
+        {
+            return m_next;
+        }
+
+        inline void setNext(QCountersDataStorageBase* next)
+        {
+            m_next = next;
+        }
+
     private:
-        std::vector<UInt64> m_dataStorage;
-        UInt64              m_thread_id;
+        std::vector<UInt64>         m_dataStorage;
+        UInt64*                     m_counters;
+        UInt64                      m_thread_id;
+        QCountersDataStorageBase*   m_next;
     };
 }
 
@@ -103,6 +138,7 @@ public:
     //   
     QCountersBase(size_t countersNumber,const char* module,std::string appname, UInt64 tid)
         : m_number_of_counters( countersNumber )
+        , m_per_thread_local_storage_list(NULL)
         , m_counterData(m_number_of_counters)
         , m_titleMaxLen(0)
         , m_module(module)
@@ -187,29 +223,40 @@ public:
     inline UInt64 getCounterValue(size_t counter_index) const
     {
         UInt64 counter_value(0);
-        for (size_t i = 0; i < m_raw_pointers_to_per_thread_local_storage.size(); i++)
+
+        for ( const QCountersDataStorageBase* storage = m_per_thread_local_storage_list.load( std::memory_order_acquire ); storage != NULL; storage = storage->getNext() )
         {
-            if ( m_raw_pointers_to_per_thread_local_storage.at(i) != NULL )
-            {
-                counter_value += m_raw_pointers_to_per_thread_local_storage.at(i)->getCounter(counter_index);
-            }
+            counter_value += storage->readCounter(counter_index);
         }
 
         return counter_value;
     } 
 
     //-------------------------------------------------------------------------
-    inline void resetCounterValue(size_t counter_index) const
+    // values of all counters in one pass over the per thread storages (no lock, writers are not slowed down):
+    // use it instead of getCounterValue for each counter when all of them are needed (status dump)
+    void getCounterValues(std::vector<UInt64>& counter_values) const
     {
-        for (size_t i = 0; i < m_raw_pointers_to_per_thread_local_storage.size(); i++)
+        counter_values.assign( m_number_of_counters, 0 );
+
+        for ( const QCountersDataStorageBase* storage = m_per_thread_local_storage_list.load( std::memory_order_acquire ); storage != NULL; storage = storage->getNext() )
         {
-            if ( m_raw_pointers_to_per_thread_local_storage.at(i) != NULL )
+            for ( size_t k = 0; k < m_number_of_counters; k++ )
             {
-                m_raw_pointers_to_per_thread_local_storage.at(i)->resetCounter(counter_index);
+                counter_values[k] += storage->readCounter(k);
             }
         }
     }
 
+    //-------------------------------------------------------------------------
+    inline void resetCounterValue(size_t counter_index) const
+    {
+        for ( QCountersDataStorageBase* storage = m_per_thread_local_storage_list.load( std::memory_order_acquire ); storage != NULL; storage = storage->getNext() )
+        {
+            storage->resetCounter(counter_index);
+        }
+    }
+
     //-------------------------------------------------------------------------
     inline bool isFileWriteEnabled(size_t counter_index) const
     {
@@ -241,10 +288,16 @@ public:
     //-------------------------------------------------------------------------
     // returns a SQL command to save counter value to database
     std::string counterToDB(size_t counter_index,std::string& statusCurrentTime) 
+    {
+        return counterToDB(counter_index, statusCurrentTime, getCounterValue(counter_index));
+    }
+
+    // same with a value from getCounterValues
+    std::string counterToDB(size_t counter_index,std::string& statusCurrentTime, UInt64 counter_value) 
     {
         std::stringstream dbString (std::stringstream::out | std::stringstream::in);
         dbString << "INSERT INTO cnt_" << m_hostname << "_" << m_appname << 
-                    " VALUES('" << statusCurrentTime << "','" << getCounterStringId(counter_index) << "','" << getCounterValue(counter_index) << "','" << m_module << "','" << m_tid << "');";
+                    " VALUES('" << statusCurrentTime << "','" << getCounterStringId(counter_index) << "','" << counter_value << "','" << m_module << "','" << m_tid << "');";
         return dbString.str();
     }
 
@@ -252,12 +305,15 @@ public:
     // return a list of SQL commands for all counters enabled to be written to database
     std::list<std::string> getSQLCommands(std::string& statusCurrentTime)
     {
+        std::vector<UInt64> counter_values;
+        getCounterValues(counter_values);
+
         std::list<std::string> dbCmdList;
         for ( size_t k = 0; k < m_number_of_counters;k++)
         {
             if(isDBWriteEnabled(k))
             {
-                dbCmdList.push_back(counterToDB(k,statusCurrentTime));
+                dbCmdList.push_back(counterToDB(k,statusCurrentTime,counter_values[k]));
             }
         }
         return dbCmdList;
@@ -267,9 +323,8 @@ protected:
     // store number of counters
     size_t m_number_of_counters;
 
-    // ptr to raw pointer vector
-    // FIXME[cg] subst with std::shared_ptr ???
-    std::vector< QAppNG::QCountersDataStorageBase* > m_raw_pointers_to_per_thread_local_storage;
+    // per thread storages (added at head under m_recursive_mutex, never removed: readers walk it without lock)
+    std::atomic< QAppNG::QCountersDataStorageBase* > m_per_thread_local_storage_list;
 
     // mutex only used on counter creation and on counter title setting
     boost::recursive_mutex m_recursive_mutex;
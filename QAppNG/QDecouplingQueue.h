@@ -19,6 +19,7 @@
 
 #include <QAppNG/core.h>
 #include <QAppNG/TrivialCircularLockFreeQueue.h>
+#include <QAppNG/ThreadAffinity.h>
 
 // ----------------------------------------------------------------------------------------------
 
@@ -41,13 +42,15 @@ namespace QAppNG
             , fastdelegate::FastDelegate0< void > initialize_delegate
                 = fastdelegate::FastDelegate0< void >() 
             , fastdelegate::FastDelegate0< void > termination_delegate
-                = fastdelegate::FastDelegate0< void >() )
+                = fastdelegate::FastDelegate0< void >()
+            , const CpuSet& dispatcher_cpu_affinity = CpuSet() )
                 : TrivialCircularLockFreeQueue< ELEMENT_TYPE >( queue_size )
                 , m_exit(false)
                 , m_flushed(false)
                 , m_dispatch_delegate(dispatch_delegate)
                 , m_initialize_dalegate(initialize_delegate)
                 , m_termination_delegate(termination_delegate)
+                , m_dispatcher_cpu_affinity(dispatcher_cpu_affinity)
         {
             assert( m_dispatch_delegate );
 
@@ -82,6 +85,8 @@ namespace QAppNG
         {
             static UInt32   dispatched_elements(0);
 
+            setCurrentThreadCpuAffinity( "QDecouplingQueueDispatcher", m_dispatcher_cpu_affinity );
+
             if ( m_initialize_dalegate )
             {
                 m_initialize_dalegate();
@@ -132,6 +137,7 @@ namespace QAppNG
         fastdelegate::FastDelegate1< ELEMENT_TYPE&, void >       m_dispatch_delegate;
         fastdelegate::FastDelegate0< void >                      m_initialize_dalegate;
         fastdelegate::FastDelegate0< void >                      m_termination_delegate;
+        CpuSet                                                   m_dispatcher_cpu_affinity;
     };
 
     template< typename ELEMENT_TYPE >
@@ -142,12 +148,14 @@ namespace QAppNG
             , fastdelegate::FastDelegate0< void > initialize_delegate
                 = fastdelegate::FastDelegate0< void >()
             , fastdelegate::FastDelegate0< void > termination_delegate
-                = fastdelegate::FastDelegate0< void >() )
+                = fastdelegate::FastDelegate0< void >()
+            , const CpuSet& dispatcher_cpu_affinity = CpuSet() )
             : TrivialCircularLockFreeQueue< ELEMENT_TYPE >( queue_size )
             , m_exit(false)
             , m_dispatch_delegate(dispatch_delegate)
             , m_initialize_dalegate(initialize_delegate)
             , m_termination_delegate(termination_delegate)
+            , m_dispatcher_cpu_affinity(dispatcher_cpu_affinity)
         {
             assert( m_dispatch_delegate );
 
@@ -171,6 +179,8 @@ namespace QAppNG
         {
             static UInt32   dispatched_elements(0);
 
+            setCurrentThreadCpuAffinity( "QDecouplingQueueDispatcher", m_dispatcher_cpu_affinity );
+
             if ( m_initialize_dalegate )
             {
                 m_initialize_dalegate();
@@ -216,6 +226,7 @@ namespace QAppNG
         fastdelegate::FastDelegate1< ELEMENT_TYPE&, void >      m_dispatch_delegate;
         fastdelegate::FastDelegate0< void >                     m_initialize_dalegate;
         fastdelegate::FastDelegate0< void >                     m_termination_delegate;
+        CpuSet                                                  m_dispatcher_cpu_affinity;
     };
 }
 
@@ -32,6 +32,7 @@
 #include <QAppNG/core.h>
 #include <QAppNG/Singleton.h>
 #include <QAppNG/SimplePeriodicTimer.h>
+#include <QAppNG/ThreadAffinity.h>
 #include <QAppNG/QObservable.h>
 #include <QAppNG/MultithreadProcessingEntity.h>
 
@@ -233,6 +234,12 @@ namespace QAppNG
 
         }
 
+        // set CPUs for the timer thread: it must be called before start() to take effect
+        void setTimerThreadCpuAffinity( const CpuSet& cpu_affinity )
+        {
+            m_timer_thread_cpu_affinity = cpu_affinity;
+        }
+
         UInt32 getTotalElapsedSeconds()
         {
             return m_total_elapsed_seconds;
@@ -385,12 +392,15 @@ namespace QAppNG
         volatile bool m_exit;
         volatile bool m_timer_thread_running;
         std::unique_ptr<std::thread> m_timer_thread;
+        CpuSet m_timer_thread_cpu_affinity;
 
         // count number of timer pulse (second passed since QVirtualClock has been started)
         UInt32 m_total_elapsed_seconds;
 
         void timerThreadLoop()
         {
+            setCurrentThreadCpuAffinity( "QVirtualClock_timer", m_timer_thread_cpu_affinity );
+
             m_timer_thread_running = true;
             std::chrono::high_resolution_clock::time_point sleep_time;
             std::chrono::duration<double> sleep_duration_seconds;
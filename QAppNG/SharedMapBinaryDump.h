@@ -0,0 +1,95 @@
+#ifndef Q_SHARED_MAP_BINARY_DUMP_H_NG
+#define Q_SHARED_MAP_BINARY_DUMP_H_NG
+
+/** ===================================================================================================================
+* @file    SharedMapBinaryDump
+*
+* @brief   versioned binary dump of a mapset (SharedMap::dumpToBinaryFile/loadFromBinaryFile): file layout and
+*          key/value encoding.
+*
+*          File: SharedMapDumpHeader, one record per entry (8 bytes aligned), offsets of the records (UInt64 each,
+*          so the records can be decoded by many threads). A record is SharedMapDumpRecord, the encoded key and
+*          the encoded value. Files are written and mapped by MultiKeyMap::SnapshotWriter/SnapshotReader.
+*
+*          Keys and values are encoded by encodeDumpField/decodeDumpField: trivially copyable types and
+*          std::string are handled here, other types need their own overloads (found by argument dependent lookup).
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-045   QAppNG Team                                                      Oct-2026      Original development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+#include <QAppNG/core.h>
+#include <QAppNG/MultiKeyMapSnapshot.h>
+
+namespace QAppNG
+{
+    struct SharedMapDumpHeader
+    {
+        // "QSMPDUMP"
+        static const UInt64 MAGIC   = 0x504D5544504D5351ULL;
+        static const UInt32 VERSION = 1;
+
+        UInt64  magic;
+        UInt32  version;
+        UInt32  reserved;
+        UInt64  number_of_elements;
+        UInt64  offsets_offset;
+        UInt64  file_size;
+    };
+
+    struct SharedMapDumpRecord
+    {
+        UInt32  record_length;
+        UInt32  key_length;
+        UInt32  value_length;
+        UInt32  reserved;
+        UInt64  entry_time;
+    };
+
+    // --------------------------------------------------------------------------------------------------
+    // KEY/VALUE encoding: append field to buffer / read field from length bytes (false: not valid)
+
+    template<class FIELD_CLASS>
+    inline bool encodeDumpField( const FIELD_CLASS& field, std::vector<UInt8>& buffer )
+    {
+        static_assert( std::is_trivially_copyable<FIELD_CLASS>::value, "encodeDumpField/decodeDumpField overloads are needed for this type" );
+
+        const UInt8* data = reinterpret_cast<const UInt8*>( &field );
+        buffer.insert( buffer.end(), data, data + sizeof(FIELD_CLASS) );
+        return true;
+    }
+
+    template<class FIELD_CLASS>
+    inline bool decodeDumpField( const UInt8* data, size_t length, FIELD_CLASS& field )
+    {
+        static_assert( std::is_trivially_copyable<FIELD_CLASS>::value, "encodeDumpField/decodeDumpField overloads are needed for this type" );
+
+        if ( length != sizeof(FIELD_CLASS) ) return false;
+
+        std::memcpy( &field, data, sizeof(FIELD_CLASS) );
+        return true;
+    }
+
+    inline bool encodeDumpField( const std::string& field, std::vector<UInt8>& buffer )
+    {
+        buffer.insert( buffer.end(), field.begin(), field.end() );
+        return true;
+    }
+
+    inline bool decodeDumpField( const UInt8* data, size_t length, std::string& field )
+    {
+        field.assign( reinterpret_cast<const char*>( data ), length );
+        return true;
+    }
+}
+#endif //Q_SHARED_MAP_BINARY_DUMP_H_NG
@@ -0,0 +1,171 @@
+#ifndef Q_SHARED_MAP_CHANGE_LOG_H_NG
+#define Q_SHARED_MAP_CHANGE_LOG_H_NG
+
+/** ===================================================================================================================
+* @file    SharedMapChangeLog
+*
+* @brief   log of the changes (SET/DEL/TOUCH) done on a SharedMap since the last SYNCH, one record per key.
+*
+*          The SharedMap logs each change under its write lock: a change of a key already in the log overwrites
+*          its record (a SET after a DEL is a SET, a TOUCH after a SET only moves the SET time), so the log keeps
+*          the last state of each changed key as the SharedMap did before the change logs. MasterMap::synchMapset
+*          takes the whole log with a swap (the SharedMap is locked only for that) and applies the records on the
+*          master map, so a SYNCH costs the number of changed keys and never a copy of the SharedMap.
+*
+*          The log holds at most max_number_of_records keys: when it is full the SharedMap runs a SYNCH itself.
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-043   QAppNG Team                                                      Oct-2026      Original development
+* #user-043   QAppNG Team                                                      Oct-2026      one record per key, max_number_of_records
+* #user-043   QAppNG Team                                                      Oct-2026      record index released after bursts
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include <vector>
+#include <unordered_map>
+#include <QAppNG/core.h>
+
+namespace QAppNG
+{
+    template<class KEY_CLASS, class VALUE_CLASS>
+    class SharedMapChangeLog
+    {
+    public:
+        enum record_type_enum { SET_RECORD, DEL_RECORD, TOUCH_RECORD };
+
+        struct Record
+        {
+            Record( record_type_enum record_type, const KEY_CLASS& record_key, const VALUE_CLASS& record_value, UInt64 record_time )
+                : type( record_type ), time( record_time ), key( record_key ), value( record_value ) {}
+
+            record_type_enum    type;
+            UInt64              time;
+            KEY_CLASS           key;
+
+            // SET_RECORD only
+            VALUE_CLASS         value;
+        };
+
+        typedef std::vector<Record> RecordVector;
+
+        // keys logged by a SharedMap before it runs a SYNCH itself
+        static const size_t DEFAULT_MAX_NUMBER_OF_RECORDS = 1 << 20;
+
+        // buckets of the record index kept (cleared) by takeRecords whatever the number of records
+        static const size_t MIN_INDEX_BUCKETS_TO_RELEASE = 1024;
+
+        SharedMapChangeLog()
+            : m_max_number_of_records(DEFAULT_MAX_NUMBER_OF_RECORDS)
+            , m_number_of_appended_records(0)
+            , m_number_of_taken_records(0)
+        {
+        }
+
+        // --------------------------------------------------------------------------------------------------
+        // WRITER (SharedMap write lock)
+
+        void appendSet( const KEY_CLASS& key, const VALUE_CLASS& value, UInt64 entry_time )
+        {
+            Record* record = find( key );
+            if ( record )
+            {
+                record->type = SET_RECORD;
+                record->time = entry_time;
+                record->value = value;
+            }
+            else
+            {
+                append( Record( SET_RECORD, key, value, entry_time ) );
+            }
+            ++m_number_of_appended_records;
+        }
+
+        void appendDel( const KEY_CLASS& key )
+        {
+            Record* record = find( key );
+            if ( record )
+            {
+                record->type = DEL_RECORD;
+                record->time = 0;
+                record->value = VALUE_CLASS();
+            }
+            else
+            {
+                append( Record( DEL_RECORD, key, VALUE_CLASS(), 0 ) );
+            }
+            ++m_number_of_appended_records;
+        }
+
+        void appendTouch( const KEY_CLASS& key, UInt64 entry_time )
+        {
+            // SET and TOUCH records get the new time, a deleted key is not touched
+            Record* record = find( key );
+            if ( record )
+            {
+                if ( record->type != DEL_RECORD ) record->time = entry_time;
+            }
+            else
+            {
+                append( Record( TOUCH_RECORD, key, VALUE_CLASS(), entry_time ) );
+            }
+            ++m_number_of_appended_records;
+        }
+
+        // --------------------------------------------------------------------------------------------------
+        // CONSUMER (SharedMap write lock, only for the swap)
+
+        // records appended since the last call move to records; the log goes on in the memory of records
+        // (so a consumer giving back the same cleared vector does not allocate at each SYNCH)
+        void takeRecords( RecordVector& records )
+        {
+            records.clear();
+            m_records.swap( records );
+
+            // clear walks all the buckets: after a burst the index is released instead (SYNCH cost stays O(records))
+            if ( m_record_index.bucket_count() > 4 * m_record_index.size() + MIN_INDEX_BUCKETS_TO_RELEASE ) std::unordered_map<KEY_CLASS, size_t>().swap( m_record_index );
+            else m_record_index.clear();
+
+            m_number_of_taken_records += records.size();
+        }
+
+        // records (changed keys) waiting for the next SYNCH
+        size_t size() const { return m_records.size(); }
+
+        // the SharedMap runs a SYNCH when the log is full (0: never)
+        bool full() const { return m_max_number_of_records && m_records.size() >= m_max_number_of_records; }
+
+        void setMaxNumberOfRecords( size_t max_number_of_records ) { m_max_number_of_records = max_number_of_records; }
+        size_t getMaxNumberOfRecords() const { return m_max_number_of_records; }
+
+        UInt64 getNumberOfAppendedRecords() const { return m_number_of_appended_records; }
+        UInt64 getNumberOfTakenRecords() const { return m_number_of_taken_records; }
+
+    private:
+        Record* find( const KEY_CLASS& key )
+        {
+            typename std::unordered_map<KEY_CLASS, size_t>::const_iterator position = m_record_index.find( key );
+            return position != m_record_index.end() ? &m_records[ position->second ] : NULL;
+        }
+
+        void append( const Record& record )
+        {
+            m_record_index.insert( std::make_pair( record.key, m_records.size() ) );
+            m_records.push_back( record );
+        }
+
+        RecordVector    m_records;
+
+        // position of the record of each key in m_records
+        std::unordered_map<KEY_CLASS, size_t>   m_record_index;
+
+        size_t          m_max_number_of_records;
+        UInt64          m_number_of_appended_records;
+        UInt64          m_number_of_taken_records;
+    };
+}
+#endif //Q_SHARED_MAP_CHANGE_LOG_H_NG
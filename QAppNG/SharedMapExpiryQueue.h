@@ -0,0 +1,97 @@
+#ifndef Q_SHARED_MAP_EXPIRY_QUEUE_H_NG
+#define Q_SHARED_MAP_EXPIRY_QUEUE_H_NG
+
+/** ===================================================================================================================
+* @file    SharedMapExpiryQueue
+*
+* @brief   keys of the MasterMap ordered by entry time (oldest first), so PURGE pops only the expired entries.
+*
+*          An entry is pushed each time the entry time of a key changes and never updated: PURGE skips the popped
+*          entries whose time is not the time in master map anymore (updated, touched or deleted keys) and
+*          compact rebuilds the queue from master map when these stale entries are too many.
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-046   QAppNG Team                                                      Oct-2026      Original development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include <vector>
+#include <algorithm>
+#include <QAppNG/core.h>
+
+namespace QAppNG
+{
+    template<class KEY_CLASS>
+    class SharedMapExpiryQueue
+    {
+    public:
+        // entry time, key
+        typedef std::pair<UInt64, KEY_CLASS> Entry;
+
+        // queue entries (stale ones included) kept without compact
+        static const size_t MIN_SIZE_TO_COMPACT = 1024;
+
+        SharedMapExpiryQueue() : m_number_of_compacts(0) {}
+
+        void push( UInt64 entry_time, const KEY_CLASS& key )
+        {
+            m_heap.push_back( Entry( entry_time, key ) );
+            std::push_heap( m_heap.begin(), m_heap.end(), Later() );
+        }
+
+        // oldest entry
+        const Entry& top() const { return m_heap.front(); }
+
+        void pop()
+        {
+            std::pop_heap( m_heap.begin(), m_heap.end(), Later() );
+            m_heap.pop_back();
+        }
+
+        bool empty() const { return m_heap.empty(); }
+        size_t size() const { return m_heap.size(); }
+
+        // rebuild from data_map (key -> entry time, value) if stale entries are more than the entries of data_map
+        template<class MAP_TYPE>
+        bool compact( const MAP_TYPE& data_map )
+        {
+            if ( m_heap.size() < MIN_SIZE_TO_COMPACT || m_heap.size() <= 2 * data_map.size() ) return false;
+
+            std::vector<Entry> heap;
+            heap.reserve( data_map.size() );
+
+            for ( typename MAP_TYPE::const_iterator element = data_map.begin(); element != data_map.end(); ++element )
+            {
+                heap.push_back( Entry( element->second.first, element->first ) );
+            }
+
+            std::make_heap( heap.begin(), heap.end(), Later() );
+            m_heap.swap( heap );
+
+            ++m_number_of_compacts;
+            return true;
+        }
+
+        UInt64 getNumberOfCompacts() const { return m_number_of_compacts; }
+
+    private:
+        // min heap on entry time
+        struct Later
+        {
+            bool operator()( const Entry& a, const Entry& b ) const { return a.first > b.first; }
+        };
+
+        std::vector<Entry>  m_heap;
+
+        UInt64              m_number_of_compacts;
+    };
+
+    template<class KEY_CLASS>
+    const size_t SharedMapExpiryQueue<KEY_CLASS>::MIN_SIZE_TO_COMPACT;
+}
+#endif //Q_SHARED_MAP_EXPIRY_QUEUE_H_NG
@@ -0,0 +1,629 @@
+/** ===================================================================================================================
+* @file    SharedMemoryMap HEADER FILE
+*
+* @brief   hash map of POD keys/values in a POSIX shared memory segment, shared by the local processes that open
+*          the same name (e.g. IMSI/TMSI correlation built once and read by capture and ticketing).
+*
+*          Open addressing (linear probing) on a fixed number of slots: entries are stored in the slots, so they
+*          are at the same offset for all the processes whatever the address of their mapping.
+*          Readers never lock: each slot has a sequence (odd while written) and readers retry a slot changed
+*          meanwhile (a slot odd for MAX_READ_SPINS retries has its writer stripe locked once, so the slot of a
+*          writer that died is repaired). Writers lock the stripe of the key (process shared robust mutex), so a key has one writer;
+*          free slots are claimed with a CAS because probing crosses stripes. Deleted slots stay as tombstones on
+*          the probe chains and are reused by later inserts. Entry times and PURGE are as in SharedMap.
+*
+*          Example:
+*
+*              QAppNG::SharedMemoryMap<UInt64, ImsiContext> imsi_map;
+*
+*              // created by the first process, opened by the others (same capacity and types)
+*              if ( !imsi_map.open( "/gb_imsi_map", 4 * 1024 * 1024 ) ) ...
+*
+*              imsi_map.set( tmsi, context, now_time );
+*              if ( imsi_map.get( tmsi, context ) ) ...
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-048   QAppNG Team                                                      Oct-2026      Original Development
+* #user-048   QAppNG Team                                                      Oct-2026      bounded reader spin (dead writers)
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_SHARED_MEMORY_MAP_H
+#define QAPPNG_SHARED_MEMORY_MAP_H
+
+// Include STL
+#include <new>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+// other Includes
+#include <QAppNG/core.h>
+#include <QAppNG/SharedMemorySegment.h>
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH = std::hash<KEY_CLASS> >
+    class SharedMemoryMap
+    {
+        // each process maps the segment at its own address: no pointers in keys and values
+        static_assert( std::is_trivially_copyable<KEY_CLASS>::value && std::is_trivially_copyable<VALUE_CLASS>::value, "SharedMemoryMap keys and values must be POD" );
+
+        // atomics in shared memory must not hide a lock
+        static_assert( ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "SharedMemoryMap needs lock free atomics" );
+
+    public:
+        // "QSHMMAP1"
+        static const UInt64 MAGIC               = 0x3150414D4D485351ULL;
+        static const UInt32 VERSION             = 1;
+
+        static const size_t NUMBER_OF_STRIPES   = 256;
+
+        // slots used (entries and tombstones) at most, percent of the slots: linear probing chains stay short
+        static const size_t MAX_LOAD_PERCENT    = 75;
+
+        SharedMemoryMap() : m_header( NULL ), m_stripes( NULL ), m_slots( NULL ), m_slots_mask( 0 ), m_max_used_slots( 0 ) {}
+
+        // DTOR: unmap (the map stays until remove)
+        virtual ~SharedMemoryMap() {}
+
+        //______________________________________________________________________________________________________
+        // open the map name ("/name") or create it with room for capacity entries: all the processes must use
+        // the same capacity, keys and values
+        bool open( const std::string& name, size_t capacity )
+        {
+            close();
+
+            UInt64 number_of_slots = 1;
+            while ( number_of_slots < UInt64( capacity ) * 100 / MAX_LOAD_PERCENT + 1 ) number_of_slots <<= 1;
+
+            if ( !m_segment.open( name, SLOTS_OFFSET + number_of_slots * sizeof(Slot) ) ) return false;
+
+            Header* header = reinterpret_cast<Header*>( m_segment.getData() );
+            Stripe* stripes = reinterpret_cast<Stripe*>( m_segment.getData() + STRIPES_OFFSET );
+
+            if ( m_segment.isCreator() )
+            {
+                // segment is zero filled: empty slots
+                new ( header ) Header();
+                header->magic           = MAGIC;
+                header->version         = VERSION;
+                header->key_size        = UInt32( sizeof(KEY_CLASS) );
+                header->value_size      = UInt32( sizeof(VALUE_CLASS) );
+                header->number_of_slots = number_of_slots;
+
+                for ( size_t i = 0; i < NUMBER_OF_STRIPES; i++ )
+                {
+                    new ( &stripes[i] ) Stripe();
+
+                    if ( !stripes[i].mutex.init() )
+                    {
+                        close();
+                        SharedMemorySegment::unlink( name );
+                        return false;
+                    }
+                }
+
+                // other processes wait for this
+                header->ready.store( 1, std::memory_order_release );
+            }
+            else
+            {
+                for ( size_t wait_steps = 0; !header->ready.load( std::memory_order_acquire ); wait_steps++ )
+                {
+                    if ( wait_steps == READY_WAIT_STEPS )
+                    {
+                        close();
+                        return false;
+                    }
+
+                    std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+                }
+
+                if (  header->magic != MAGIC
+                   || header->version != VERSION
+                   || header->key_size != sizeof(KEY_CLASS)
+                   || header->value_size != sizeof(VALUE_CLASS)
+                   || header->number_of_slots != number_of_slots )
+                {
+                    close();
+                    return false;
+                }
+            }
+
+            m_header         = header;
+            m_stripes        = stripes;
+            m_slots          = reinterpret_cast<Slot*>( m_segment.getData() + SLOTS_OFFSET );
+            m_slots_mask     = number_of_slots - 1;
+            m_max_used_slots = number_of_slots * MAX_LOAD_PERCENT / 100;
+
+            return true;
+        }
+
+        //______________________________________________________________________________________________________
+        void close()
+        {
+            m_segment.close();
+
+            m_header         = NULL;
+            m_stripes        = NULL;
+            m_slots          = NULL;
+            m_slots_mask     = 0;
+            m_max_used_slots = 0;
+        }
+
+        // remove the map name (processes that opened it go on using it)
+        static bool remove( const std::string& name ) { return SharedMemorySegment::unlink( name ); }
+
+        //______________________________________________________________________________________________________
+        // READ (no lock)
+
+        bool get( const KEY_CLASS& key, VALUE_CLASS& value ) const
+        {
+            return find( key, &value, NULL );
+        }
+
+        bool getTime( const KEY_CLASS& key, UInt64& entry_time ) const
+        {
+            return find( key, NULL, &entry_time );
+        }
+
+        size_t count( const KEY_CLASS& key ) const
+        {
+            return find( key, NULL, NULL ) ? 1 : 0;
+        }
+
+        size_t size() const { return m_header ? size_t( m_header->size.load( std::memory_order_relaxed ) ) : 0; }
+        size_t capacity() const { return size_t( m_max_used_slots ); }
+
+        //______________________________________________________________________________________________________
+        // WRITE (lock of the key stripe)
+
+        // false if the map is full
+        bool set( const KEY_CLASS& key, const VALUE_CLASS& value, UInt64 entry_time = 0 )
+        {
+            if ( !m_slots ) return false;
+
+            UInt64 hash = getHash( key );
+            Stripe& stripe = lockStripe( hash );
+
+            bool done = true;
+            UInt64 index = findLocked( key, hash );
+
+            if ( index != NO_SLOT )
+            {
+                // UPDATE
+                Slot& slot = m_slots[index];
+
+                beginWrite( stripe, slot, index );
+                slot.value      = value;
+                slot.entry_time = entry_time;
+                endWrite( stripe, slot );
+            }
+            else
+            {
+                // INSERT: key is on no chain and only this stripe inserts it
+                done = insert( stripe, key, value, entry_time, hash );
+            }
+
+            stripe.mutex.unlock();
+            return done;
+        }
+
+        bool del( const KEY_CLASS& key )
+        {
+            if ( !m_slots ) return false;
+
+            UInt64 hash = getHash( key );
+            Stripe& stripe = lockStripe( hash );
+
+            UInt64 index = findLocked( key, hash );
+            if ( index != NO_SLOT ) erase( stripe, index );
+
+            stripe.mutex.unlock();
+            return index != NO_SLOT;
+        }
+
+        bool touch( const KEY_CLASS& key, UInt64 entry_time )
+        {
+            if ( !m_slots ) return false;
+
+            UInt64 hash = getHash( key );
+            Stripe& stripe = lockStripe( hash );
+
+            UInt64 index = findLocked( key, hash );
+            if ( index != NO_SLOT )
+            {
+                Slot& slot = m_slots[index];
+
+                beginWrite( stripe, slot, index );
+                slot.entry_time = entry_time;
+                endWrite( stripe, slot );
+            }
+
+            stripe.mutex.unlock();
+            return index != NO_SLOT;
+        }
+
+        //______________________________________________________________________________________________________
+        // delete entries older than max_age_seconds, scanning max_scanned_slots slots from where the last purge
+        // of any process stopped (0: all the slots); returns the number of purged entries
+        size_t purge( UInt64 now_time, UInt32 max_age_seconds, size_t max_scanned_slots = 0 )
+        {
+            if ( !m_slots || !max_age_seconds ) return 0;
+
+            UInt64 max_age( static_cast<UInt64>(max_age_seconds) << 32 );
+
+            UInt64 number_of_scanned_slots = max_scanned_slots;
+            if ( !number_of_scanned_slots || number_of_scanned_slots > m_slots_mask + 1 ) number_of_scanned_slots = m_slots_mask + 1;
+
+            UInt64 first_index = m_header->purge_cursor.fetch_add( number_of_scanned_slots, std::memory_order_relaxed );
+            size_t number_of_purged = 0;
+
+            for ( UInt64 i = 0; i < number_of_scanned_slots; i++ )
+            {
+                UInt64 index = ( first_index + i ) & m_slots_mask;
+
+                KEY_CLASS slot_key;
+                UInt64 entry_time;
+                if ( readSlotKey( m_slots[index], slot_key, entry_time ) != FULL_SLOT || !isExpired( now_time, entry_time, max_age ) ) continue;
+
+                Stripe& stripe = lockStripe( getHash( slot_key ) );
+
+                // again with the lock: the slot may have changed meanwhile
+                KEY_CLASS locked_slot_key;
+                if (  readSlotKey( m_slots[index], locked_slot_key, entry_time ) == FULL_SLOT
+                   && locked_slot_key == slot_key
+                   && isExpired( now_time, entry_time, max_age ) )
+                {
+                    erase( stripe, index );
+                    number_of_purged++;
+                }
+
+                stripe.mutex.unlock();
+            }
+
+            return number_of_purged;
+        }
+
+    private:
+        SharedMemoryMap( const SharedMemoryMap& ) = delete;
+        SharedMemoryMap& operator=( const SharedMemoryMap& ) = delete;
+
+        enum slot_state_enum { EMPTY_SLOT = 0, BUSY_SLOT, FULL_SLOT, DELETED_SLOT };
+
+        static const UInt64 NO_SLOT = ~UInt64(0);
+
+        // an opener waits for the creator to initialize the map (in 1 ms steps)
+        static const size_t READY_WAIT_STEPS = 5000;
+
+        // yields of a reader on a slot being written before it locks the stripe of the writer
+        static const size_t MAX_READ_SPINS = 1024;
+
+        struct Header
+        {
+            Header() : ready( 0 ), size( 0 ), number_of_used_slots( 0 ), purge_cursor( 0 ) {}
+
+            UInt64              magic;
+            UInt32              version;
+            UInt32              key_size;
+            UInt32              value_size;
+            UInt64              number_of_slots;
+
+            std::atomic<UInt32> ready;
+            std::atomic<UInt64> size;
+            std::atomic<UInt64> number_of_used_slots;
+            std::atomic<UInt64> purge_cursor;
+        };
+
+        struct alignas(64) Stripe
+        {
+            Stripe() : writing_slot( NO_SLOT ) {}
+
+            ProcessSharedMutex  mutex;
+
+            // slot written by the owner of mutex (repaired if it dies meanwhile)
+            std::atomic<UInt64> writing_slot;
+        };
+
+        struct Slot
+        {
+            // odd while written
+            std::atomic<UInt32> sequence;
+            std::atomic<UInt32> state;
+            UInt64              entry_time;
+            KEY_CLASS           key;
+            VALUE_CLASS         value;
+        };
+
+        static const size_t STRIPES_OFFSET  = ( sizeof(Header) + 63 ) & ~size_t(63);
+        static const size_t SLOTS_OFFSET    = ( STRIPES_OFFSET + NUMBER_OF_STRIPES * sizeof(Stripe) + 63 ) & ~size_t(63);
+
+        // spread weak hashes (e.g. std::hash of integers is the identity)
+        inline UInt64 getHash( const KEY_CLASS& key ) const
+        {
+            UInt64 hash = m_hash( key );
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        static inline bool isExpired( UInt64 now_time, UInt64 entry_time, UInt64 max_age )
+        {
+            return now_time > entry_time && now_time - entry_time > max_age;
+        }
+
+        //______________________________________________________________________________________________________
+        // consistent copy of a slot: its state, and value/entry time (if not NULL) when it is FULL with key
+        UInt32 readSlot( const Slot& slot, const KEY_CLASS& key, bool& match, VALUE_CLASS* value, UInt64* entry_time ) const
+        {
+            for ( size_t spins = 1; ; spins++ )
+            {
+                UInt32 sequence = slot.sequence.load( std::memory_order_acquire );
+
+                // writer of another process may be descheduled, or dead
+                if ( sequence & 1 )
+                {
+                    if ( spins % MAX_READ_SPINS ) std::this_thread::yield();
+                    else                          waitForSlotWriter( UInt64( &slot - m_slots ) );
+                    continue;
+                }
+
+                UInt32 state = slot.state.load( std::memory_order_relaxed );
+                match = false;
+
+                if ( state == FULL_SLOT )
+                {
+                    KEY_CLASS slot_key;
+                    std::memcpy( &slot_key, &slot.key, sizeof(KEY_CLASS) );
+
+                    if ( slot_key == key )
+                    {
+                        match = true;
+                        if ( value )      std::memcpy( value, &slot.value, sizeof(VALUE_CLASS) );
+                        if ( entry_time ) *entry_time = slot.entry_time;
+                    }
+                }
+
+                std::atomic_thread_fence( std::memory_order_acquire );
+                if ( slot.sequence.load( std::memory_order_relaxed ) == sequence ) return state;
+            }
+        }
+
+        // consistent copy of key and entry time of a slot (valid if FULL)
+        UInt32 readSlotKey( const Slot& slot, KEY_CLASS& key, UInt64& entry_time ) const
+        {
+            for ( size_t spins = 1; ; spins++ )
+            {
+                UInt32 sequence = slot.sequence.load( std::memory_order_acquire );
+
+                if ( sequence & 1 )
+                {
+                    if ( spins % MAX_READ_SPINS ) std::this_thread::yield();
+                    else                          waitForSlotWriter( UInt64( &slot - m_slots ) );
+                    continue;
+                }
+
+                UInt32 state = slot.state.load( std::memory_order_relaxed );
+
+                std::memcpy( &key, &slot.key, sizeof(KEY_CLASS) );
+                entry_time = slot.entry_time;
+
+                std::atomic_thread_fence( std::memory_order_acquire );
+                if ( slot.sequence.load( std::memory_order_relaxed ) == sequence ) return state;
+            }
+        }
+
+        //______________________________________________________________________________________________________
+        bool find( const KEY_CLASS& key, VALUE_CLASS* value, UInt64* entry_time ) const
+        {
+            if ( !m_slots ) return false;
+
+            UInt64 index = getHash( key ) & m_slots_mask;
+
+            for ( UInt64 probe = 0; probe <= m_slots_mask; probe++, index = ( index + 1 ) & m_slots_mask )
+            {
+                bool match;
+                UInt32 state = readSlot( m_slots[index], key, match, value, entry_time );
+
+                if ( match ) return true;
+
+                // end of chain (slots are never empty again)
+                if ( state == EMPTY_SLOT ) return false;
+            }
+
+            return false;
+        }
+
+        // index of the slot of key (stripe locked), NO_SLOT if not in map
+        UInt64 findLocked( const KEY_CLASS& key, UInt64 hash ) const
+        {
+            UInt64 index = hash & m_slots_mask;
+
+            for ( UInt64 probe = 0; probe <= m_slots_mask; probe++, index = ( index + 1 ) & m_slots_mask )
+            {
+                bool match;
+                UInt32 state = readSlot( m_slots[index], key, match, NULL, NULL );
+
+                if ( match ) return index;
+                if ( state == EMPTY_SLOT ) return NO_SLOT;
+            }
+
+            return NO_SLOT;
+        }
+
+        //______________________________________________________________________________________________________
+        bool insert( Stripe& stripe, const KEY_CLASS& key, const VALUE_CLASS& value, UInt64 entry_time, UInt64 hash )
+        {
+            UInt64 index = hash & m_slots_mask;
+
+            for ( UInt64 probe = 0; probe <= m_slots_mask; probe++, index = ( index + 1 ) & m_slots_mask )
+            {
+                Slot& slot = m_slots[index];
+                UInt32 state = slot.state.load( std::memory_order_acquire );
+
+                if ( state == DELETED_SLOT )
+                {
+                    // tombstone (writers of other stripes may claim it first)
+                    if ( !slot.state.compare_exchange_strong( state, UInt32( BUSY_SLOT ) ) ) continue;
+                }
+                else if ( state == EMPTY_SLOT )
+                {
+                    if ( m_header->number_of_used_slots.fetch_add( 1 ) >= m_max_used_slots )
+                    {
+                        // map full
+                        m_header->number_of_used_slots.fetch_sub( 1 );
+                        return false;
+                    }
+
+                    if ( !slot.state.compare_exchange_strong( state, UInt32( BUSY_SLOT ) ) )
+                    {
+                        m_header->number_of_used_slots.fetch_sub( 1 );
+                        continue;
+                    }
+                }
+                else
+                {
+                    continue;
+                }
+
+                // claimed: BUSY slots are skipped by readers (NB: a writer dying right here leaves it BUSY)
+                beginWrite( stripe, slot, index );
+                slot.key        = key;
+                slot.value      = value;
+                slot.entry_time = entry_time;
+                slot.state.store( FULL_SLOT, std::memory_order_relaxed );
+                m_header->size.fetch_add( 1, std::memory_order_relaxed );
+                endWrite( stripe, slot );
+
+                return true;
+            }
+
+            return false;
+        }
+
+        void erase( Stripe& stripe, UInt64 index )
+        {
+            Slot& slot = m_slots[index];
+
+            beginWrite( stripe, slot, index );
+            slot.state.store( DELETED_SLOT, std::memory_order_relaxed );
+            m_header->size.fetch_sub( 1, std::memory_order_relaxed );
+            endWrite( stripe, slot );
+        }
+
+        //______________________________________________________________________________________________________
+        inline void beginWrite( Stripe& stripe, Slot& slot, UInt64 index )
+        {
+            stripe.writing_slot.store( index, std::memory_order_relaxed );
+
+            slot.sequence.store( slot.sequence.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+        }
+
+        inline void endWrite( Stripe& stripe, Slot& slot )
+        {
+            slot.sequence.store( slot.sequence.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+
+            stripe.writing_slot.store( NO_SLOT, std::memory_order_relaxed );
+        }
+
+        Stripe& lockStripe( UInt64 hash )
+        {
+            Stripe& stripe = m_stripes[ ( hash >> 48 ) & ( NUMBER_OF_STRIPES - 1 ) ];
+
+            if ( !stripe.mutex.lock() ) repairStripe( stripe );
+
+            return stripe;
+        }
+
+        // slot odd for too long: lock the stripe writing it, a live writer ends its write first and the slot of a
+        // dead one is repaired. No deadlock with the stripe of the caller (findLocked): a writer reads no slot while
+        // one of its slots is odd
+        void waitForSlotWriter( UInt64 index ) const
+        {
+            for ( size_t i = 0; i < NUMBER_OF_STRIPES; i++ )
+            {
+                Stripe& stripe = m_stripes[i];
+                if ( stripe.writing_slot.load( std::memory_order_relaxed ) != index ) continue;
+
+                if ( !stripe.mutex.lock() ) repairStripe( stripe );
+                stripe.mutex.unlock();
+
+                return;
+            }
+        }
+
+        // the previous owner of the stripe died: its slot write may be incomplete, the entry is dropped
+        void repairStripe( Stripe& stripe ) const
+        {
+            UInt64 index = stripe.writing_slot.load( std::memory_order_relaxed );
+            if ( index == NO_SLOT ) return;
+
+            Slot& slot = m_slots[index];
+            UInt32 sequence = slot.sequence.load( std::memory_order_relaxed );
+
+            if ( sequence & 1 )
+            {
+                UInt32 state = slot.state.load( std::memory_order_relaxed );
+
+                if ( state == FULL_SLOT ) m_header->size.fetch_sub( 1, std::memory_order_relaxed );
+                if ( state == FULL_SLOT || state == BUSY_SLOT ) slot.state.store( DELETED_SLOT, std::memory_order_relaxed );
+
+                slot.sequence.store( sequence + 1, std::memory_order_release );
+            }
+
+            stripe.writing_slot.store( NO_SLOT, std::memory_order_relaxed );
+        }
+
+        SharedMemorySegment m_segment;
+
+        Header*             m_header;
+        Stripe*             m_stripes;
+        Slot*               m_slots;
+
+        UInt64              m_slots_mask;
+        UInt64              m_max_used_slots;
+
+        HASH                m_hash;
+    };
+
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH >
+    const UInt64 SharedMemoryMap<KEY_CLASS, VALUE_CLASS, HASH>::MAGIC;
+
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH >
+    const UInt32 SharedMemoryMap<KEY_CLASS, VALUE_CLASS, HASH>::VERSION;
+
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH >
+    const size_t SharedMemoryMap<KEY_CLASS, VALUE_CLASS, HASH>::NUMBER_OF_STRIPES;
+
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH >
+    const size_t SharedMemoryMap<KEY_CLASS, VALUE_CLASS, HASH>::MAX_LOAD_PERCENT;
+
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH >
+    const UInt64 SharedMemoryMap<KEY_CLASS, VALUE_CLASS, HASH>::NO_SLOT;
+
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH >
+    const size_t SharedMemoryMap<KEY_CLASS, VALUE_CLASS, HASH>::READY_WAIT_STEPS;
+
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH >
+    const size_t SharedMemoryMap<KEY_CLASS, VALUE_CLASS, HASH>::STRIPES_OFFSET;
+
+    template < typename KEY_CLASS, typename VALUE_CLASS, typename HASH >
+    const size_t SharedMemoryMap<KEY_CLASS, VALUE_CLASS, HASH>::SLOTS_OFFSET;
+}
+
+// --------------------------------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,183 @@
+/** ===================================================================================================================
+* @file    SharedMemorySegment Cpp FILE
+*
+* @brief   POSIX shared memory segment and process shared robust mutex
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-048   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include "SharedMemorySegment.h"
+#include <cerrno>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    // an opener waits for the creator to size the segment (in 1 ms steps)
+    static const int SEGMENT_SIZE_WAIT_STEPS = 5000;
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SharedMemorySegment::SharedMemorySegment()
+        : m_data( NULL )
+        , m_size( 0 )
+        , m_is_creator( false )
+    {
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SharedMemorySegment::~SharedMemorySegment()
+    {
+        close();
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool SharedMemorySegment::open( const std::string& name, UInt64 size )
+    {
+        close();
+
+#ifndef WIN32
+        int file_descriptor = ::shm_open( name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660 );
+
+        if ( file_descriptor >= 0 )
+        {
+            // new segment (zero filled)
+            if ( ::ftruncate( file_descriptor, off_t( size ) ) != 0 )
+            {
+                ::close( file_descriptor );
+                ::shm_unlink( name.c_str() );
+                return false;
+            }
+
+            m_is_creator = true;
+        }
+        else
+        {
+            if ( errno != EEXIST ) return false;
+
+            file_descriptor = ::shm_open( name.c_str(), O_RDWR, 0660 );
+            if ( file_descriptor < 0 ) return false;
+
+            // the creator may not have sized it yet
+            struct stat file_status;
+            int wait_steps = 0;
+
+            while ( ::fstat( file_descriptor, &file_status ) == 0 && file_status.st_size == 0 && wait_steps++ < SEGMENT_SIZE_WAIT_STEPS ) ::usleep( 1000 );
+
+            if ( ::fstat( file_descriptor, &file_status ) != 0 || UInt64( file_status.st_size ) != size )
+            {
+                ::close( file_descriptor );
+                return false;
+            }
+        }
+
+        void* data = ::mmap( NULL, size_t( size ), PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0 );
+
+        // the mapping keeps the segment
+        ::close( file_descriptor );
+
+        if ( data == MAP_FAILED )
+        {
+            if ( m_is_creator ) ::shm_unlink( name.c_str() );
+            m_is_creator = false;
+            return false;
+        }
+
+        m_data = static_cast<UInt8*>( data );
+        m_size = size;
+
+        return true;
+#else
+        UNUSED( name );
+        UNUSED( size );
+        return false;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void SharedMemorySegment::close()
+    {
+#ifndef WIN32
+        if ( m_data ) ::munmap( m_data, size_t( m_size ) );
+#endif
+
+        m_data       = NULL;
+        m_size       = 0;
+        m_is_creator = false;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool SharedMemorySegment::unlink( const std::string& name )
+    {
+#ifndef WIN32
+        return ::shm_unlink( name.c_str() ) == 0;
+#else
+        UNUSED( name );
+        return false;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool ProcessSharedMutex::init()
+    {
+#ifndef WIN32
+        pthread_mutexattr_t attributes;
+        if ( ::pthread_mutexattr_init( &attributes ) != 0 ) return false;
+
+        bool done = ::pthread_mutexattr_setpshared( &attributes, PTHREAD_PROCESS_SHARED ) == 0
+                 && ::pthread_mutexattr_setrobust( &attributes, PTHREAD_MUTEX_ROBUST ) == 0
+                 && ::pthread_mutex_init( &m_mutex, &attributes ) == 0;
+
+        ::pthread_mutexattr_destroy( &attributes );
+
+        return done;
+#else
+        return false;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool ProcessSharedMutex::lock()
+    {
+#ifndef WIN32
+        if ( ::pthread_mutex_lock( &m_mutex ) != EOWNERDEAD ) return true;
+
+        // we own it now: usable again once the caller repaired the data
+        ::pthread_mutex_consistent( &m_mutex );
+        return false;
+#else
+        return true;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void ProcessSharedMutex::unlock()
+    {
+#ifndef WIN32
+        ::pthread_mutex_unlock( &m_mutex );
+#endif
+    }
+} // namespace QAppNG
+
+// --------------------------------------------------------------------------------------------------------------------
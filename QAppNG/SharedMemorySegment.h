@@ -0,0 +1,92 @@
+/** ===================================================================================================================
+* @file    SharedMemorySegment HEADER FILE
+*
+* @brief   POSIX shared memory segment (shm_open + mmap) shared by the local processes that open the same name,
+*          and a mutex that can live in it (process shared, robust: a process dying while it holds the mutex
+*          does not block the others).
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-048   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_SHARED_MEMORY_SEGMENT_H
+#define QAPPNG_SHARED_MEMORY_SEGMENT_H
+
+// Include STL
+#include <string>
+
+// other Includes
+#include <QAppNG/core.h>
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief the segment is zero filled when created; the creator initializes it, the other processes must wait
+    *         for that (e.g. a ready flag written last by the creator)
+    */
+    class SharedMemorySegment
+    {
+    public:
+        SharedMemorySegment();
+
+        // DTOR: unmap (the segment stays until unlink)
+        virtual ~SharedMemorySegment();
+
+        // open name ("/name") or create it with size bytes if it does not exist yet
+        bool open( const std::string& name, UInt64 size );
+        void close();
+
+        // remove name: processes that mapped it keep their mapping
+        static bool unlink( const std::string& name );
+
+        UInt8* getData() const { return m_data; }
+        UInt64 getSize() const { return m_size; }
+
+        // true if this process created the segment (and has to initialize it)
+        bool isCreator() const { return m_is_creator; }
+
+    private:
+        SharedMemorySegment( const SharedMemorySegment& ) = delete;
+        SharedMemorySegment& operator=( const SharedMemorySegment& ) = delete;
+
+        UInt8*  m_data;
+        UInt64  m_size;
+        bool    m_is_creator;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief mutex placed in a SharedMemorySegment (init by the creator only)
+    */
+    class ProcessSharedMutex
+    {
+    public:
+        bool init();
+
+        // false if the previous owner died holding the mutex: the caller owns it and must repair what it protects
+        bool lock();
+        void unlock();
+
+    private:
+#ifndef WIN32
+        pthread_mutex_t m_mutex;
+#endif
+    };
+}
+
+// --------------------------------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,323 @@
+/** ===================================================================================================================
+* @file    SlabPool HEADER FILE
+*
+* @brief   slab allocator for objects of one size: blocks are carved from SLAB_SIZE aligned slabs, freed blocks go
+*          back to their slab and slabs with no used block are released in bulk (releaseEmptySlabs).
+*
+*          SlabAllocator is a standard allocator on a shared SlabPool, meant for std::allocate_shared: the object
+*          and its shared_ptr control block take one block, the pool lives until the last object is freed.
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-041   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_SLAB_POOL_H
+#define QAPPNG_SLAB_POOL_H
+
+// Include STL
+#include <new>
+#include <memory>
+#include <mutex>
+#include <cstdlib>
+
+// other Includes
+#include <QAppNG/core.h>
+
+#ifdef WIN32
+#include <malloc.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    // --------------------------------------------------------------------------------------------------------
+    //                                              *** SlabPool ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief the block size is the size of the first allocation, other sizes are allocated with operator new.
+    *         Thread safe: objects may be freed by any thread (e.g. the last owner of a shared_ptr).
+    */
+    class SlabPool
+    {
+    public:
+        static const size_t SLAB_SIZE       = 64 * 1024;
+        static const size_t BLOCK_ALIGNMENT = 16;
+
+        SlabPool()
+            : m_block_size( 0 ), m_blocks_per_slab( 0 )
+            , m_partial_slabs( NULL ), m_empty_slabs( NULL )
+            , m_number_of_slabs( 0 ), m_number_of_empty_slabs( 0 ), m_number_of_used_blocks( 0 )
+            , m_number_of_slab_allocations( 0 ), m_number_of_released_slabs( 0 )
+        {
+        }
+
+        // DTOR: all blocks are free (SlabAllocator keeps the pool alive), full slabs can not exist
+        ~SlabPool()
+        {
+            freeSlabList( m_partial_slabs );
+            freeSlabList( m_empty_slabs );
+        }
+
+        //______________________________________________________________________________________________________
+        void* allocate( size_t size )
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+
+            if ( !m_block_size ) setBlockSize( size );
+
+            if ( !m_blocks_per_slab || size > m_block_size ) return ::operator new( size );
+
+            if ( !m_partial_slabs && !addSlab() ) throw std::bad_alloc();
+
+            Slab* slab = m_partial_slabs;
+            void* block;
+
+            if ( slab->free_blocks )
+            {
+                block = slab->free_blocks;
+                slab->free_blocks = *static_cast<void**>( block );
+            }
+            else
+            {
+                block = getFirstBlock( slab ) + slab->number_of_carved_blocks++ * m_block_size;
+            }
+
+            // slab full: out of the partial list until a block is freed
+            if ( ++slab->number_of_used_blocks == m_blocks_per_slab ) unlink( m_partial_slabs, slab );
+
+            ++m_number_of_used_blocks;
+
+            return block;
+        }
+
+        //______________________________________________________________________________________________________
+        void deallocate( void* block, size_t size )
+        {
+            if ( !block ) return;
+
+            std::lock_guard<std::mutex> lock( m_mutex );
+
+            if ( !m_blocks_per_slab || size > m_block_size )
+            {
+                ::operator delete( block );
+                return;
+            }
+
+            Slab* slab = reinterpret_cast<Slab*>( reinterpret_cast<UIntPtr>( block ) & ~UIntPtr( SLAB_SIZE - 1 ) );
+
+            if ( slab->number_of_used_blocks-- == m_blocks_per_slab ) link( m_partial_slabs, slab );
+
+            *static_cast<void**>( block ) = slab->free_blocks;
+            slab->free_blocks = block;
+
+            --m_number_of_used_blocks;
+
+            // no used block: carved again from the beginning when reused
+            if ( !slab->number_of_used_blocks )
+            {
+                unlink( m_partial_slabs, slab );
+
+                slab->free_blocks             = NULL;
+                slab->number_of_carved_blocks = 0;
+
+                link( m_empty_slabs, slab );
+                ++m_number_of_empty_slabs;
+            }
+        }
+
+        //______________________________________________________________________________________________________
+        // bulk reclamation (e.g. after a purge): free empty slabs except number_of_kept_slabs
+        size_t releaseEmptySlabs( size_t number_of_kept_slabs = 0 )
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+
+            size_t number_of_released_slabs = 0;
+
+            while ( m_number_of_empty_slabs > number_of_kept_slabs )
+            {
+                Slab* slab = m_empty_slabs;
+                unlink( m_empty_slabs, slab );
+                freeSlab( slab );
+
+                --m_number_of_empty_slabs;
+                --m_number_of_slabs;
+                ++number_of_released_slabs;
+            }
+
+            m_number_of_released_slabs += number_of_released_slabs;
+
+            return number_of_released_slabs;
+        }
+
+        // statistics
+        size_t getBlockSize() const                 { return m_block_size; }
+        size_t getNumberOfSlabs() const             { return m_number_of_slabs; }
+        size_t getNumberOfEmptySlabs() const        { return m_number_of_empty_slabs; }
+        size_t getNumberOfUsedBlocks() const        { return m_number_of_used_blocks; }
+        size_t getNumberOfSlabAllocations() const   { return m_number_of_slab_allocations; }
+        size_t getNumberOfReleasedSlabs() const     { return m_number_of_released_slabs; }
+
+    private:
+        SlabPool( const SlabPool& ) = delete;
+        SlabPool& operator=( const SlabPool& ) = delete;
+
+        typedef uintptr_t UIntPtr;
+
+        // at the beginning of each slab
+        struct Slab
+        {
+            Slab*   prev;
+            Slab*   next;
+            void*   free_blocks;
+            size_t  number_of_used_blocks;
+            size_t  number_of_carved_blocks;
+        };
+
+        static const size_t SLAB_HEADER_SIZE = ( sizeof(Slab) + BLOCK_ALIGNMENT - 1 ) & ~( BLOCK_ALIGNMENT - 1 );
+
+        void setBlockSize( size_t size )
+        {
+            m_block_size      = ( size + BLOCK_ALIGNMENT - 1 ) & ~( BLOCK_ALIGNMENT - 1 );
+            m_blocks_per_slab = m_block_size < SLAB_SIZE ? ( SLAB_SIZE - SLAB_HEADER_SIZE ) / m_block_size : 0;
+        }
+
+        inline UInt8* getFirstBlock( Slab* slab ) const { return reinterpret_cast<UInt8*>( slab ) + SLAB_HEADER_SIZE; }
+
+        bool addSlab()
+        {
+            Slab* slab = m_empty_slabs;
+
+            if ( slab )
+            {
+                unlink( m_empty_slabs, slab );
+                --m_number_of_empty_slabs;
+            }
+            else
+            {
+                // aligned: the slab of a block is found from its address
+                void* memory = NULL;
+#ifndef WIN32
+                if ( ::posix_memalign( &memory, SLAB_SIZE, SLAB_SIZE ) != 0 ) return false;
+#else
+                memory = ::_aligned_malloc( SLAB_SIZE, SLAB_SIZE );
+                if ( !memory ) return false;
+#endif
+                slab = static_cast<Slab*>( memory );
+                slab->free_blocks             = NULL;
+                slab->number_of_used_blocks   = 0;
+                slab->number_of_carved_blocks = 0;
+
+                ++m_number_of_slabs;
+                ++m_number_of_slab_allocations;
+            }
+
+            link( m_partial_slabs, slab );
+            return true;
+        }
+
+        static void freeSlab( Slab* slab )
+        {
+#ifndef WIN32
+            ::free( slab );
+#else
+            ::_aligned_free( slab );
+#endif
+        }
+
+        static void freeSlabList( Slab* slab )
+        {
+            while ( slab )
+            {
+                Slab* next = slab->next;
+                freeSlab( slab );
+                slab = next;
+            }
+        }
+
+        static void link( Slab*& head, Slab* slab )
+        {
+            slab->prev = NULL;
+            slab->next = head;
+            if ( head ) head->prev = slab;
+            head = slab;
+        }
+
+        static void unlink( Slab*& head, Slab* slab )
+        {
+            if ( slab->prev ) slab->prev->next = slab->next;
+            else              head             = slab->next;
+            if ( slab->next ) slab->next->prev = slab->prev;
+
+            slab->prev = NULL;
+            slab->next = NULL;
+        }
+
+        std::mutex  m_mutex;
+
+        size_t      m_block_size;
+        size_t      m_blocks_per_slab;
+
+        // slabs with free blocks (first used for allocation) and slabs with no used block
+        Slab*       m_partial_slabs;
+        Slab*       m_empty_slabs;
+
+        size_t      m_number_of_slabs;
+        size_t      m_number_of_empty_slabs;
+        size_t      m_number_of_used_blocks;
+        size_t      m_number_of_slab_allocations;
+        size_t      m_number_of_released_slabs;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+    //                                            *** SlabAllocator ***
+    // --------------------------------------------------------------------------------------------------------
+
+    template <typename T>
+    class SlabAllocator
+    {
+    public:
+        typedef T value_type;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef SlabAllocator<U> other;
+        };
+
+        explicit SlabAllocator( const std::shared_ptr<SlabPool>& slab_pool ) : m_slab_pool( slab_pool ) {}
+
+        template <typename U>
+        SlabAllocator( const SlabAllocator<U>& other ) : m_slab_pool( other.getSlabPool() ) {}
+
+        T* allocate( size_t n )
+        {
+            return static_cast<T*>( m_slab_pool->allocate( n * sizeof(T) ) );
+        }
+
+        void deallocate( T* p, size_t n )
+        {
+            m_slab_pool->deallocate( p, n * sizeof(T) );
+        }
+
+        const std::shared_ptr<SlabPool>& getSlabPool() const { return m_slab_pool; }
+
+    private:
+        std::shared_ptr<SlabPool> m_slab_pool;
+    };
+
+    template <typename T, typename U>
+    inline bool operator==( const SlabAllocator<T>& a, const SlabAllocator<U>& b ) { return a.getSlabPool() == b.getSlabPool(); }
+
+    template <typename T, typename U>
+    inline bool operator!=( const SlabAllocator<T>& a, const SlabAllocator<U>& b ) { return a.getSlabPool() != b.getSlabPool(); }
+}
+
+// --------------------------------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,228 @@
+/** ===================================================================================================================
+* @file    ThreadAffinity Cpp FILE
+*
+* @brief   CPU sets and thread placement helpers (pthread_setaffinity_np wrapper)
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-026   QAppNG Team                                                      Oct-2026      Original Development
+* #user-026   QAppNG Team                                                      Oct-2026      cpu numbers bounded to CPU_SETSIZE
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include "ThreadAffinity.h"
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <exception>
+#include <stdexcept>
+
+#ifndef WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    namespace
+    {
+        // placement registry: indexed by ThreadCounter thread id
+        std::mutex                                                          g_placement_mutex;
+        std::array<std::string, ThreadCounter::MAX_NUMBER_OF_THREADS>       g_placement_role;
+        std::array<std::string, ThreadCounter::MAX_NUMBER_OF_THREADS>       g_placement_cpus;
+        std::array<Int32, ThreadCounter::MAX_NUMBER_OF_THREADS>             g_placement_last_cpu;
+        std::array<bool, ThreadCounter::MAX_NUMBER_OF_THREADS>              g_placement_is_set = {};
+
+        // cpus an affinity mask can hold (ranges are expanded one cpu at a time)
+#ifndef WIN32
+        const unsigned long MAX_NUMBER_OF_CPUS = CPU_SETSIZE;
+#else
+        const unsigned long MAX_NUMBER_OF_CPUS = 64;
+#endif
+
+        // whole token must be a cpu number ("4x", "-1" and "+2" are rejected): throws std::invalid_argument,
+        // std::out_of_range if it is not below MAX_NUMBER_OF_CPUS
+        UInt32 parseCpu( const std::string& token )
+        {
+            if ( token.empty() || token.find_first_not_of( "0123456789" ) != std::string::npos ) throw std::invalid_argument( token );
+
+            unsigned long cpu = std::stoul( token );
+            if ( cpu >= MAX_NUMBER_OF_CPUS ) throw std::out_of_range( token );
+
+            return static_cast<UInt32>( cpu );
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    CpuSet::CpuSet( const std::string& cpu_list )
+    {
+        std::istringstream input( cpu_list );
+        std::string token;
+
+        while ( std::getline( input, token, ',' ) )
+        {
+            // trim blanks
+            token.erase( std::remove( token.begin(), token.end(), ' ' ), token.end() );
+            if ( token.empty() ) continue;
+
+            size_t dash_position = token.find( '-' );
+
+            try
+            {
+                if ( dash_position == std::string::npos )
+                {
+                    add( parseCpu( token ) );
+                }
+                else
+                {
+                    UInt32 first_cpu = parseCpu( token.substr( 0, dash_position ) );
+                    UInt32 last_cpu  = parseCpu( token.substr( dash_position + 1 ) );
+
+                    if ( first_cpu > last_cpu ) throw std::invalid_argument( token );
+
+                    for ( UInt32 cpu = first_cpu; cpu <= last_cpu; ++cpu ) add( cpu );
+                }
+            }
+            catch ( const std::logic_error& )
+            {
+                std::ostringstream error_message;
+                error_message << "CpuSet - Invalid cpu list: '" << cpu_list << "'. Valid syntax: '0-3,8,10-11', cpus below " << MAX_NUMBER_OF_CPUS;
+                throw std::runtime_error( error_message.str() );
+            }
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void CpuSet::add( UInt32 cpu )
+    {
+        std::vector<UInt32>::iterator it = std::lower_bound( m_cpus.begin(), m_cpus.end(), cpu );
+
+        if ( it == m_cpus.end() || *it != cpu )
+        {
+            m_cpus.insert( it, cpu );
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    std::string CpuSet::toString() const
+    {
+        if ( m_cpus.empty() ) return "-";
+
+        std::ostringstream output;
+
+        size_t i = 0;
+        while ( i < m_cpus.size() )
+        {
+            // collapse consecutive cpus in a range
+            size_t j = i;
+            while ( j + 1 < m_cpus.size() && m_cpus[j + 1] == m_cpus[j] + 1 ) ++j;
+
+            if ( i > 0 ) output << ",";
+
+            output << m_cpus[i];
+            if ( j > i ) output << "-" << m_cpus[j];
+
+            i = j + 1;
+        }
+
+        return output.str();
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool setCurrentThreadCpuAffinity( const std::string& thread_role, const CpuSet& cpu_set )
+    {
+        // no constraint: thread left floating and NOT registered (it would take a ThreadCounter id for nothing)
+        if ( cpu_set.empty() ) return true;
+
+        bool affinity_applied( false );
+
+#ifndef WIN32
+        cpu_set_t os_cpu_set;
+        CPU_ZERO( &os_cpu_set );
+
+        for ( UInt32 cpu : cpu_set.getCpus() )
+        {
+            if ( cpu < CPU_SETSIZE ) CPU_SET( cpu, &os_cpu_set );
+        }
+
+        affinity_applied = ( pthread_setaffinity_np( pthread_self(), sizeof(os_cpu_set), &os_cpu_set ) == 0 );
+#endif
+
+        // register ACTUAL placement (what the OS gave us, not what was asked)
+        size_t thread_id = ThreadCounter::Instance().getThreadId();
+
+        std::unique_lock<std::mutex> lock( g_placement_mutex );
+
+        g_placement_role[thread_id]     = thread_role;
+        g_placement_cpus[thread_id]     = getCurrentThreadCpuAffinity().toString();
+        g_placement_last_cpu[thread_id] = getCurrentCpu();
+        g_placement_is_set[thread_id]   = true;
+
+        return affinity_applied;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    CpuSet getCurrentThreadCpuAffinity()
+    {
+        CpuSet output;
+
+#ifndef WIN32
+        cpu_set_t os_cpu_set;
+        CPU_ZERO( &os_cpu_set );
+
+        if ( pthread_getaffinity_np( pthread_self(), sizeof(os_cpu_set), &os_cpu_set ) == 0 )
+        {
+            for ( UInt32 cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+            {
+                if ( CPU_ISSET( cpu, &os_cpu_set ) ) output.add( cpu );
+            }
+        }
+#endif
+
+        return output;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    Int32 getCurrentCpu()
+    {
+#ifndef WIN32
+        return static_cast<Int32>( sched_getcpu() );
+#else
+        return -1;
+#endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    std::string getThreadsPlacementStatus()
+    {
+        std::ostringstream output;
+
+        std::unique_lock<std::mutex> lock( g_placement_mutex );
+
+        for ( size_t thread_id = 0; thread_id < ThreadCounter::MAX_NUMBER_OF_THREADS; ++thread_id )
+        {
+            if ( !g_placement_is_set[thread_id] ) continue;
+
+            output << "|- TID " << thread_id << " " << g_placement_role[thread_id]
+                   << ": cpus=" << g_placement_cpus[thread_id]
+                   << " started_on=" << g_placement_last_cpu[thread_id] << std::endl;
+        }
+
+        return output.str();
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
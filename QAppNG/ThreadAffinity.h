@@ -0,0 +1,77 @@
+/** ===================================================================================================================
+* @file    ThreadAffinity HEADER FILE
+*
+* @brief   CPU sets and thread placement helpers (pthread_setaffinity_np wrapper)
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-026   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_THREAD_AFFINITY_H
+#define QAPPNG_THREAD_AFFINITY_H
+
+#include <QAppNG/core.h>
+#include <QAppNG/ThreadCounter.h>
+#include <string>
+#include <vector>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    /**
+    *  @brief set of logical CPUs a thread may run on.
+    *
+    *         It is built from the usual Linux list syntax ("0-3,8,10-11"), the same used by taskset and isolcpus,
+    *         so WorkManager xml and LWS configuration can be written the way the machine is partitioned.
+    *         An empty CpuSet means "no constraint": the thread is left floating.
+    */
+    class CpuSet
+    {
+    public:
+        CpuSet() {}
+
+        // parse cpu list: throws std::runtime_error on bad syntax or on a cpu not below CPU_SETSIZE
+        explicit CpuSet( const std::string& cpu_list );
+
+        bool empty() const { return m_cpus.empty(); }
+        void add( UInt32 cpu );
+        void clear() { m_cpus.clear(); }
+
+        const std::vector<UInt32>& getCpus() const { return m_cpus; }
+
+        // return the set in compact list syntax ("0-3,8"), "-" if empty
+        std::string toString() const;
+
+    private:
+        // sorted, no duplicates
+        std::vector<UInt32> m_cpus;
+    };
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    /**
+    *  Pin the calling thread to cpu_set and register its placement under thread_role (used by status reports).
+    *  An empty cpu_set does nothing: the thread is neither pinned nor registered (no ThreadCounter id is taken).
+    *  Returns false if the OS refused the affinity.
+    */
+    bool setCurrentThreadCpuAffinity( const std::string& thread_role, const CpuSet& cpu_set );
+
+    // Read back the CPUs the calling thread is actually allowed to run on
+    CpuSet getCurrentThreadCpuAffinity();
+
+    // CPU the calling thread is running on right now (-1 if unknown)
+    Int32 getCurrentCpu();
+
+    // Placement report of all threads registered with setCurrentThreadCpuAffinity: "<tid> <role>: cpus=... started_on=..."
+    // (started_on: CPU the thread was running on when it was pinned)
+    std::string getThreadsPlacementStatus();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+#endif
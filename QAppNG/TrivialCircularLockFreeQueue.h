@@ -9,6 +9,7 @@
 * REF#        Who                                                              When          What
 * #????       A. Della Villa                                                   31/10/2008    Original development
 * #8060       A. Della Villa, D. Verna, F. Lasagni                             Feb-2013      minor improvements
+* #user-030   QAppNG Team                                                      Oct-2026      frontRange/pop(n): bulk consume in place
 *
 * @endhistory
 * ===================================================================================================================
@@ -210,6 +211,40 @@ namespace QAppNG
             return m_data_array[ static_cast< size_t >( m_read_index) ];
         }
 
+        // BULK READ: set first to the front element and return how many elements (up to max_elements) follow it
+        // contiguously in the array (it stops at the array end, the rest is returned by the next call).
+        // Elements stay in the queue (the producer cannot overwrite them) until they are released with pop(n)
+        size_t frontRange( std::shared_ptr< ELEMENT_CLASS >*& first, size_t max_elements )
+        {
+            // write index is read once: the producer can move it while we are here
+            UInt64 write_index = m_write_index;
+            UInt64 read_index  = m_read_index;
+
+            size_t available = static_cast< size_t >( ( write_index >= read_index ) ? write_index - read_index : m_queue_end_index - read_index );
+
+            first = &m_data_array[ static_cast< size_t >( read_index ) ];
+
+            return ( available < max_elements ) ? available : max_elements;
+        }
+
+        // BULK POP: release the first n elements (n must not exceed what frontRange returned)
+        void pop( size_t n )
+        {
+            size_t read_index = static_cast< size_t >( m_read_index );
+
+            for ( size_t i = 0; i < n; ++i )
+            {
+                m_data_array[ read_index ].reset();
+
+                if ( ++read_index == m_queue_end_index )
+                {
+                    read_index = 0;
+                }
+            }
+
+            m_read_index = read_index;
+        }
+
     protected:
         std::vector< std::shared_ptr< ELEMENT_CLASS > >  m_data_array;
         size_t                      m_queue_size;
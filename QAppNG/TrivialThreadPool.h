@@ -8,6 +8,14 @@
 * @history
 * REF#        Who                                                              When          What
 * #????       A. Della Villa                                                   31/10/2008    Original development
+* #user-028   QAppNG Team                                                      Oct-2026      Elastic pool: addWorker/removeLastWorker
+* #user-030   QAppNG Team                                                      Oct-2026      doWorkBatch interface, pool statistics on timer
+* #user-031   QAppNG Team                                                      Oct-2026      WorkManager friend (fused stage workers)
+* #user-032   QAppNG Team                                                      Oct-2026      Per worker priority lane
+* #user-033   QAppNG Team                                                      Oct-2026      Broadcast channel
+* #user-034   QAppNG Team                                                      Oct-2026      Sampled queue wait/service time telemetry
+* #user-035   QAppNG Team                                                      Oct-2026      Power of two choices automatic routing
+* #user-036   QAppNG Team                                                      Oct-2026      Worker queue fill getter (load shedding)
 *
 * @endhistory
 * ===================================================================================================================
@@ -17,16 +25,30 @@
 
 // Include STL & BOOST
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <type_traits>
 #include <boost/array.hpp>
 
+#ifndef WIN32
+#include <pthread.h>
+#include <time.h>
+#endif
+
 // Other Includes
 #include "core.h"
 #include "TrivialCircularLockFreeQueue.h"
+#include "WorkTelemetry.h"
 
 #include <QAppNG/ThreadCounter.h>
+#include <QAppNG/ThreadAffinity.h>
 
 namespace QAppNG
 {
+    // forward declaration (WorkManager sets up workers of fused stages, they run outside the pool)
+    class WorkManager;
+
     // --------------------------------------------------------------------------------------------------------
 
     // THREADS WRITE Back OPERATIVE DATA
@@ -37,6 +59,8 @@ namespace QAppNG
         std::shared_ptr< std::vector<UInt64> > per_thread_number_of_calls;
         std::shared_ptr< std::vector<UInt64> > per_thread_last_sleep_msec;
         std::shared_ptr< std::vector<UInt64> > consumer_TIDs;
+        std::shared_ptr< std::vector<std::string> > consumer_cpu_affinity;
+        std::shared_ptr< WorkTelemetry > telemetry;
     };
 
     // --------------------------------------------------------------------------------------------------------
@@ -54,6 +78,7 @@ namespace QAppNG
     {
         // Declare TrivialThreadPool as FRIEND CLASS
         template<class CONSUMABLE_CLASS, class WORKER_CLASS> friend class TrivialThreadPool;
+        friend class WorkManager;
 
     public:
         ThreadDataClass()
@@ -64,12 +89,24 @@ namespace QAppNG
             , adaptive_min_sleep_msec(10)
             , adaptive_max_sleep_msec(400)
             , fixed_sleep_msec(300)
+            , statistics_update_msec(10)
+            , priority_queue_size(0)
+            , max_priority_burst(64)
+            , broadcast_queue_size(1024)
+            , telemetry_sample_rate(256)
+            , power_of_two_choices_routing(false)
+            , max_number_of_workers(0)
             , thread_key(0)
             , thread_id()
             , is_running(false)
             , exit_loop(false)
             , thread_num_consumed(0)
             , thread_num_assigned(0)
+            , thread_num_priority_consumed(0)
+            , thread_num_priority_assigned(0)
+            , thread_num_broadcast_consumed(0)
+            , thread_broadcast_read(0)
+            , telemetry_countdown(0)
             , thread_num_of_calls(0)
             , thread_last_sleep(0)
         {};
@@ -92,6 +129,37 @@ namespace QAppNG
         UInt32 adaptive_max_sleep_msec;
         UInt32 fixed_sleep_msec;
 
+        // pool statistics (pool_total_consumed used by hasPlaceInQueue and write back data) are collected
+        // by worker 0 at most once every statistics_update_msec (0 means after each batch)
+        UInt32 statistics_update_msec;
+
+        // PRIORITY LANE: each worker has a second small queue (0, the default, means no priority lane) that is drained before
+        // the normal one. After max_priority_burst priority consumables in a row the normal queue gets a batch.
+        // Priority consumables are not ordered with the normal ones (they overtake them)
+        UInt32 priority_queue_size;
+        UInt32 max_priority_burst;
+
+        // BROADCAST CHANNEL: broadcasts are written once in a ring of broadcast_queue_size consumables read by all
+        // workers (0 means no channel: a copy is queued to each worker). Each worker takes a broadcast right after
+        // the consumables it was assigned before it, so broadcasts keep their order with routed consumables.
+        UInt32 broadcast_queue_size;
+
+        // TELEMETRY: queue wait and service time are measured on one consumable (of the normal queue) out of
+        // telemetry_sample_rate (0 means no telemetry, see WorkTelemetry)
+        UInt32 telemetry_sample_rate;
+
+        // AUTOMATIC ROUTING: false is round robin, true samples two random workers and gives the consumable to the
+        // one with the shorter queue (power of two choices), so slow consumables do not pile up on one worker
+        bool   power_of_two_choices_routing;
+
+        // CPU placement: cpu_affinity is applied to all workers of the pool,
+        // per_worker_cpu_affinity[thread_key] (if given and not empty) overrides it for a single worker
+        CpuSet                cpu_affinity;
+        std::vector<CpuSet>   per_worker_cpu_affinity;
+
+        // Elastic pool: workers can be added up to max_number_of_workers (0 means the initial number of workers)
+        UInt32 max_number_of_workers;
+
         // pass private member values
         std::thread::id      getTID()      { return thread_id; };
         UInt64                 getKey()      { return thread_key; };
@@ -106,9 +174,18 @@ namespace QAppNG
         volatile bool is_running;
         volatile bool exit_loop;
 
-        // Status Parameters
+        // Status Parameters (num_consumed/assigned: normal queue only, it is FIFO)
         UInt64 thread_num_consumed;
         UInt64 thread_num_assigned;
+        UInt64 thread_num_priority_consumed;
+        UInt64 thread_num_priority_assigned;
+        UInt64 thread_num_broadcast_consumed;
+
+        // broadcast channel cursor: next broadcast sequence to read (written by the worker, read by the producer)
+        volatile UInt64 thread_broadcast_read;
+
+        // consumables to assign before the next sampled one (written by the producer)
+        UInt32 telemetry_countdown;
         UInt64 thread_num_of_calls;
         UInt32 thread_last_sleep;
     };
@@ -133,6 +210,7 @@ namespace QAppNG
         // Declare TrivialThreadPool as FRIEND CLASS
         template<class CONSUMABLE_CLASS, class WORKER_CLASS>
         friend class TrivialThreadPool;
+        friend class WorkManager;
 
     public:
         typedef THREAD_INIT_DATA_CLASS ThreadInitClass;
@@ -174,6 +252,56 @@ namespace QAppNG
         std::shared_ptr<ThreadDataClass> m_thread_data;
     };
 
+    // --------------------------------------------------------------------------------------------------------
+    //                                          *** ConsumableRange ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief consecutive consumables popped in bulk from a worker queue, passed to WORKER_CLASS::doWorkBatch
+    *
+    *         The consumables are NOT copied: the range points inside the worker queue and it is valid only
+    *         during the doWorkBatch call (they are released from the queue when it returns).
+    */
+    template<class CONSUMABLE_CLASS>
+    class ConsumableRange
+    {
+    public:
+        typedef CONSUMABLE_CLASS* iterator;
+
+        ConsumableRange( CONSUMABLE_CLASS* first, size_t size ) : m_first(first), m_size(size) {};
+
+        iterator begin() const { return m_first; };
+        iterator end()   const { return m_first + m_size; };
+        size_t   size()  const { return m_size; };
+        bool     empty() const { return m_size == 0; };
+
+        CONSUMABLE_CLASS& operator[]( size_t i ) const { return m_first[i]; };
+
+    private:
+        CONSUMABLE_CLASS* m_first;
+        size_t            m_size;
+    };
+
+    /**
+    *  @brief true if WORKER_CLASS has bool doWorkBatch( ConsumableRange<CONSUMABLE_CLASS>& batch, UInt64 thread_key )
+    *
+    *         Workers opt into batched processing just defining doWorkBatch, TrivialThreadPool then calls it
+    *         (instead of doWork) with up to max_consumables_per_loop consumables at a time. doWork is still needed
+    *         for No_MultiThread works.
+    */
+    template<class WORKER_CLASS, class CONSUMABLE_CLASS>
+    class WorkerHasDoWorkBatch
+    {
+        template<class W>
+        static std::true_type  test( decltype( std::declval<W&>().doWorkBatch( std::declval< ConsumableRange<CONSUMABLE_CLASS>& >(), UInt64(0) ) )* );
+
+        template<class W>
+        static std::false_type test( ... );
+
+    public:
+        static const bool value = decltype( test<WORKER_CLASS>( 0 ) )::value;
+    };
+
     // --------------------------------------------------------------------------------------------------------
     //                                           *** TrivialThreadPool ***
     // --------------------------------------------------------------------------------------------------------
@@ -184,7 +312,8 @@ namespace QAppNG
     *  @brief simple alternative to CAL Threadpool
     *
     *         TrivialThreadPool runs the doWork( std::shared_ptr<CONSUMABLE_CLASS> consumable, UInt64 thread_id )
-    *         of WORKER_CLASS that is the Worker.
+    *         of WORKER_CLASS that is the Worker, or its doWorkBatch( ConsumableRange<...>& batch, UInt64 thread_id )
+    *         if the Worker defines it (see WorkerHasDoWorkBatch).
     */
     template<class CONSUMABLE_CLASS, class WORKER_CLASS>
     class TrivialThreadPool
@@ -194,9 +323,15 @@ namespace QAppNG
                          , int num_workers
                          , ThreadDataClass* thread_data=NULL
                          , std::shared_ptr<ThreadOperativeDataWriteBackClass> _write_back_data = std::shared_ptr<ThreadOperativeDataWriteBackClass>() )
-            : pool_total_assigned(0)
+            : number_of_threads(0)
+            , number_of_slots(0)
+            , pool_total_assigned(0)
             , pool_total_consumed(0)
             , pool_threads(ThreadCounter::MAX_NUMBER_OF_THREADS)
+            , broadcast_write_sequence(0)
+            , broadcast_min_read(0)
+            , telemetry(NULL)
+            , routing_random_state(0x9E3779B97F4A7C15ULL)
             , allStarted(false)
             , allStopped(false)
         {
@@ -208,54 +343,138 @@ namespace QAppNG
             if (_write_back_data)
                 write_back_data = _write_back_data;
 
-            // Set the member number_of_threads
-            number_of_threads = num_workers;
+            // Store setup used to create workers (also the ones added later)
+            thread_data_setup = *thread_data;
+            thread_data_setup.work_name = work_name;
+
+            // Elastic pool: per worker vectors are reserved for the maximum number of workers
+            // so they are never reallocated while workers are reading them
+            max_number_of_threads = std::min<UInt64>( std::max<UInt64>( num_workers, thread_data->max_number_of_workers ), ThreadCounter::MAX_NUMBER_OF_THREADS );
 
             // Set length for queues vector
-            threads_queues.reserve(num_workers);
-            thread_datas.reserve(num_workers);
-            workers.reserve(num_workers);
+            threads_queues.reserve(max_number_of_threads);
+            threads_priority_queues.reserve(max_number_of_threads);
+            thread_datas.reserve(max_number_of_threads);
+            workers.reserve(max_number_of_threads);
 
-            // Set max total places in all queues of all threads
-            pool_max_place_in_queues = number_of_threads * thread_data->max_queue_size;
+            // Telemetry is written in the WorkTelemetry given with write back data
+            if ( write_back_data && write_back_data->telemetry && thread_data_setup.telemetry_sample_rate )
+            {
+                telemetry = write_back_data->telemetry.get();
+                telemetry_samples.resize( max_number_of_threads );
+            }
+
+            // Create broadcast channel
+            broadcast_ring.resize( thread_data_setup.broadcast_queue_size );
+            for ( size_t i = 0; i < broadcast_ring.size(); ++i )
+                broadcast_ring[i].assigned_before.assign( max_number_of_threads, 0 );
 
             for (int worker = 0; worker < num_workers; worker++)
+            {
+                addWorker();
+            }
+
+            // Set all-thread-started to true
+            allStarted = true;
+        };
+
+        //______________________________________________________
+        // Elastic pool: start a new worker with thread_key = current number of workers (false if already at max)
+        // it must be called by the producer thread, the new worker can be routed as soon as it returns
+        bool addWorker()
+        {
+            size_t worker = size_t(number_of_threads);
+
+            if ( worker >= max_number_of_threads ) return false;
+
+            if ( worker == number_of_slots )
             {
                 // Store a copy of thread_data in the thread_datas vector
                 thread_datas.push_back( std::shared_ptr<ThreadDataClass> (new ThreadDataClass) );
-                *thread_datas[worker] = *thread_data;
-                thread_datas[worker]->work_name = work_name;
+                *thread_datas[worker] = thread_data_setup;
 
                 // Set thread_key (it is used to cycle workers)
                 thread_datas[worker]->thread_key = worker;
 
-                // Create Queue
-                threads_queues.push_back( new TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>(thread_datas[worker]->max_queue_size) );
+                // Set per worker CPU affinity (it overrides the pool one)
+                if ( worker < thread_data_setup.per_worker_cpu_affinity.size() && !thread_data_setup.per_worker_cpu_affinity[worker].empty() )
+                {
+                    thread_datas[worker]->cpu_affinity = thread_data_setup.per_worker_cpu_affinity[worker];
+                }
 
-                // Create new WORKER_CLASS and store pointer (NUOVA parte aggiunta per Mike)
-                workers.push_back( new WORKER_CLASS() );
+                threads_queues.push_back( NULL );
+                threads_priority_queues.push_back( NULL );
+                workers.push_back( NULL );
 
-                workers.back()->m_thread_data = thread_datas[worker];
+                ++number_of_slots;
+            }
+            else
+            {
+                // worker removed before: counters go on from where they were
+                thread_datas[worker]->exit_loop = false;
+            }
 
-                // Start Pool Threads
-                pool_threads[worker].reset( new std::thread( [this, worker] { this->ThreadMainLoop( this->thread_datas[worker]); } ) );
+            // new worker reads only broadcasts written from now on
+            thread_datas[worker]->thread_broadcast_read  = broadcast_write_sequence.load( std::memory_order_relaxed );
+            thread_datas[worker]->telemetry_countdown    = thread_data_setup.telemetry_sample_rate;
 
-                // Wait for Complete Thread Start-Up
-                while ( !thread_datas[worker]->is_running )
-                {
-                    std::this_thread::sleep_for( std::chrono::milliseconds(10) );
-                }
+            // Create Queue
+            threads_queues[worker] = new TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>(thread_datas[worker]->max_queue_size);
+
+            if ( thread_datas[worker]->priority_queue_size )
+                threads_priority_queues[worker] = new TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>(thread_datas[worker]->priority_queue_size);
+
+            // Create new WORKER_CLASS and store pointer (NUOVA parte aggiunta per Mike)
+            workers[worker] = new WORKER_CLASS();
+
+            workers[worker]->m_thread_data = thread_datas[worker];
+
+            // Start Pool Threads
+            pool_threads[worker].reset( new std::thread( [this, worker] { this->ThreadMainLoop( this->thread_datas[worker]); } ) );
+
+            // Wait for Complete Thread Start-Up
+            while ( !thread_datas[worker]->is_running )
+            {
+                std::this_thread::sleep_for( std::chrono::milliseconds(10) );
             }
 
-            // Set all-thread-started to true
-            allStarted = true;
+            ++number_of_threads;
+
+            // Set max total places in all queues of all threads
+            pool_max_place_in_queues = number_of_threads * thread_data_setup.max_queue_size;
+
+            return true;
+        };
+
+        //______________________________________________________
+        // Elastic pool: stop the worker with the highest thread_key (worker 0 is never removed)
+        // the caller must not route consumables to it anymore: its queue is flushed before the thread exits
+        bool removeLastWorker()
+        {
+            if ( number_of_threads <= 1 ) return false;
+
+            size_t worker = size_t(number_of_threads - 1);
+
+            --number_of_threads;
+
+            pool_max_place_in_queues = number_of_threads * thread_data_setup.max_queue_size;
+
+            thread_datas[worker]->exit_loop = true;
+
+            pool_threads[worker]->join();
+            pool_threads[worker].reset();
+
+            delete workers[worker];
+            workers[worker] = NULL;
+
+            return true;
         };
 
         //______________________________________________________
         bool addConsumable( CONSUMABLE_CLASS& consumable )
         {
-            //  AUTOMATIC CONSUMABLE ROUTING -> calculate automatic_thread_key (cycling workers)
-            size_t automatic_thread_key( size_t(pool_total_assigned % number_of_threads) );
+            //  AUTOMATIC CONSUMABLE ROUTING -> calculate automatic_thread_key (cycling workers or power of two choices)
+            size_t automatic_thread_key = size_t( getAutomaticThreadKey() );
 
             // using automatic_thread_key the queues are cycled so consumables are equally divided between all workers of the pool
             TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>& thread_queue = *threads_queues[ automatic_thread_key ];
@@ -263,6 +482,8 @@ namespace QAppNG
             //increment per thread assigned
             ++thread_datas[ automatic_thread_key ]->thread_num_assigned;
 
+            if ( telemetry ) sampleConsumable( automatic_thread_key );
+
             // push consumable in the queue
             thread_queue.push( consumable );
 
@@ -281,6 +502,8 @@ namespace QAppNG
             //increment per thread assigned
             ++thread_datas[ size_t(thread_key) ]->thread_num_assigned;
 
+            if ( telemetry ) sampleConsumable( size_t(thread_key) );
+
             // push consumable in the queue
             thread_queue.push( consumable );
 
@@ -290,13 +513,80 @@ namespace QAppNG
             return true;
         };
 
+        //______________________________________________________
+        // PRIORITY LANE: the consumable is given to a specific worker and processed before its normal queue
+        // (it goes in the normal queue if the pool has no priority lane)
+        bool addPriorityConsumable( CONSUMABLE_CLASS& consumable, UInt64 thread_key )
+        {
+            if ( !threads_priority_queues[ size_t(thread_key) ] ) return addConsumable( consumable, thread_key );
+
+            //increment per thread priority assigned (normal queue counters are not touched)
+            ++thread_datas[ size_t(thread_key) ]->thread_num_priority_assigned;
+
+            // push consumable in the priority queue
+            threads_priority_queues[ size_t(thread_key) ]->push( consumable );
+
+            return true;
+        };
+
+        //______________________________________________________
+        // BROADCAST CHANNEL: one write for all the running workers, whatever their number (each worker processes its own
+        // copy of the slot). It waits if the slowest worker still has to read broadcast_queue_size broadcasts
+        bool addBroadcastConsumable( CONSUMABLE_CLASS& consumable )
+        {
+            if ( broadcast_ring.empty() )
+            {
+                for ( UInt64 thread_key = 0; thread_key < number_of_threads; ++thread_key ) addConsumable( consumable, thread_key );
+                return true;
+            }
+
+            while ( !hasPlaceInBroadcastChannel() )
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds(1) );
+            }
+
+            UInt64 write_sequence = broadcast_write_sequence.load( std::memory_order_relaxed );
+            BroadcastSlot& slot = broadcast_ring[ size_t( write_sequence % broadcast_ring.size() ) ];
+
+            // overwrite the slot (the consumable broadcast broadcast_queue_size times ago is released here)
+            slot.consumable = consumable;
+
+            // position of the broadcast in each worker queue (the producer is the only writer of thread_num_assigned)
+            for ( size_t thread_key = 0; thread_key < number_of_threads; ++thread_key )
+                slot.assigned_before[thread_key] = thread_datas[thread_key]->thread_num_assigned;
+
+            // publish
+            broadcast_write_sequence.store( write_sequence + 1, std::memory_order_release );
+
+            return true;
+        };
+
+        //______________________________________________________
+        bool hasPlaceInBroadcastChannel()
+        {
+            if ( broadcast_ring.empty() ) return hasPlaceInQueue();
+
+            UInt64 write_sequence = broadcast_write_sequence.load( std::memory_order_relaxed );
+
+            if ( write_sequence - broadcast_min_read < broadcast_ring.size() ) return true;
+
+            // refresh slowest worker cursor (only when the channel looks full)
+            broadcast_min_read = write_sequence;
+            for ( size_t thread_key = 0; thread_key < number_of_threads; ++thread_key )
+                broadcast_min_read = std::min<UInt64>( broadcast_min_read, UInt64( thread_datas[thread_key]->thread_broadcast_read ) );
+
+            return write_sequence - broadcast_min_read < broadcast_ring.size();
+        };
+
+        bool hasBroadcastChannel() { return !broadcast_ring.empty(); };
+
         //______________________________________________________
         void stopThreadPool()
         {
             // #9263: stop threads in reverse order of creation
-            for (Int8 tid = workers.size() - 1 ; tid >= 0; --tid)
+            for (Int64 tid = Int64(number_of_threads) - 1 ; tid >= 0; --tid)
             {
-                workers[tid]->m_thread_data->exit_loop = true;
+                thread_datas[tid]->exit_loop = true;
 
                 pool_threads[tid]->join();
             }
@@ -304,6 +594,26 @@ namespace QAppNG
             allStopped = true;
         };
 
+        //______________________________________________________
+        // AUTOMATIC ROUTING (producer thread only): worker for the next automatically routed consumable
+        UInt64 getAutomaticThreadKey()
+        {
+            UInt64 workers( number_of_threads );
+
+            if ( !thread_data_setup.power_of_two_choices_routing || workers < 2 ) return pool_total_assigned % workers;
+
+            // xorshift64: two distinct workers out of the running ones
+            routing_random_state ^= routing_random_state << 13;
+            routing_random_state ^= routing_random_state >> 7;
+            routing_random_state ^= routing_random_state << 17;
+
+            UInt64 first_key( routing_random_state % workers );
+            UInt64 second_key( ( first_key + 1 + ( routing_random_state >> 32 ) % ( workers - 1 ) ) % workers );
+
+            // queue length is an estimate (the worker pops a batch after processing it, so it includes the running one)
+            return getThreadUsedQueue( second_key ) < getThreadUsedQueue( first_key ) ? second_key : first_key;
+        };
+
         //______________________________________________________
         bool hasPlaceInQueue()
         {
@@ -316,11 +626,46 @@ namespace QAppNG
             return !threads_queues[ size_t(thread_key) ]->full();
         };
 
+        //______________________________________________________
+        bool hasPlaceInPriorityQueue( UInt64 thread_key )
+        {
+            return threads_priority_queues[ size_t(thread_key) ] ? !threads_priority_queues[ size_t(thread_key) ]->full() : hasPlaceInQueue( thread_key );
+        };
+
         // ____________________________________________________________________________________________________________
         //                                            GET INFO ABOUT WORK
 
         UInt64 getPoolTotalAssigned() { return pool_total_assigned; };
         UInt64 getPoolTotalConsumed() { return pool_total_consumed; };
+        UInt64 getNumberOfWorkers()   { return number_of_threads; };
+
+        // CPU time used by a running worker thread (0 if not available)
+        UInt64 getThreadCpuTimeUsec( UInt64 thread_key )
+        {
+            UInt64 output(0);
+#ifndef WIN32
+            clockid_t thread_clock;
+            struct timespec thread_cpu_time;
+
+            if ( pool_threads[ size_t(thread_key) ]
+                && pthread_getcpuclockid( pool_threads[ size_t(thread_key) ]->native_handle(), &thread_clock ) == 0
+                && clock_gettime( thread_clock, &thread_cpu_time ) == 0 )
+            {
+                output = UInt64(thread_cpu_time.tv_sec) * 1000000 + UInt64(thread_cpu_time.tv_nsec) / 1000;
+            }
+#endif
+            return output;
+        };
+
+        // per worker counters: consumed is incremented AFTER doWork, so consumed >= n means the first n assigned are done
+        UInt64 getThreadAssigned( UInt64 thread_key ) { return thread_datas[ size_t(thread_key) ]->thread_num_assigned; };
+        UInt64 getThreadConsumed( UInt64 thread_key ) { return thread_datas[ size_t(thread_key) ]->thread_num_consumed; };
+
+        // consumables in the worker queue, the batch being processed included (what makes the queue full)
+        UInt64 getThreadUsedQueue( UInt64 thread_key ) { return threads_queues[ size_t(thread_key) ]->getUsedQueue(); };
+
+        UInt64 getThreadPriorityAssigned( UInt64 thread_key ) { return thread_datas[ size_t(thread_key) ]->thread_num_priority_assigned; };
+        UInt64 getThreadPriorityConsumed( UInt64 thread_key ) { return thread_datas[ size_t(thread_key) ]->thread_num_priority_consumed; };
 
         std::vector<UInt64> getPoolPerThreadConsumed()
         { std::vector<UInt64> output; for (int i=0; i<number_of_threads; i++) output.push_back( thread_datas[i]->thread_num_consumed ); return output; };
@@ -333,7 +678,7 @@ namespace QAppNG
         //______________________________________________________
         ~TrivialThreadPool()
         {
-            for (size_t tid = 0; tid < number_of_threads; tid++)
+            for (size_t tid = 0; tid < number_of_slots; tid++)
             {
                 thread_datas[tid]->thread_init_data.reset();
 
@@ -343,15 +688,38 @@ namespace QAppNG
         };
 
     private:
-        UInt64                                                           number_of_threads;
+        // number_of_threads: running workers, number_of_slots: workers ever started (their counters are kept)
+        volatile UInt64                                                  number_of_threads;
+        volatile UInt64                                                  number_of_slots;
+        UInt64                                                           max_number_of_threads;
+        ThreadDataClass                                                  thread_data_setup;
         UInt64                                                           pool_total_assigned;
         UInt64                                                           pool_total_consumed;
         UInt64                                                           pool_max_place_in_queues;
         std::vector< std::unique_ptr< std::thread > >                    pool_threads;
         std::vector< TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>* >   threads_queues;
+        std::vector< TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>* >   threads_priority_queues;
         std::vector< std::shared_ptr<ThreadDataClass> >                thread_datas;
         std::vector< WORKER_CLASS* >                                     workers;
 
+        // BROADCAST CHANNEL: single writer (producer), multi reader ring, each worker reads at its own cursor
+        struct BroadcastSlot
+        {
+            CONSUMABLE_CLASS      consumable;
+            std::vector<UInt64>   assigned_before;    // per worker thread_num_assigned when the broadcast was written
+        };
+
+        std::vector< BroadcastSlot >                                     broadcast_ring;
+        std::atomic<UInt64>                                              broadcast_write_sequence;
+        UInt64                                                           broadcast_min_read;
+
+        // TELEMETRY (NULL if disabled): consumables sampled by the producer, one ring per worker
+        WorkTelemetry*                                                   telemetry;
+        std::vector< TelemetrySampleRing >                               telemetry_samples;
+
+        // AUTOMATIC ROUTING: power of two choices random state (producer thread only)
+        UInt64                                                           routing_random_state;
+
         // i dati vengono scritti sulla struttura puntata da questo shared pointer
         // che viene passato dall'applicazione client in modo che la stessa possa leggere
         // le statistiche dei threads. I dati scritti qui non hanno nessun altro scopo
@@ -362,15 +730,146 @@ namespace QAppNG
         bool allStopped;
 
         //______________________________________________________
-        bool ProcessConsumable( CONSUMABLE_CLASS& consumable, std::shared_ptr<ThreadDataClass>& thread_data )
+        // pop up to max_to_consume consumables from the queue in bulk and process them, return how many were processed
+        // (consumed_counter is the thread counter of the queue)
+        // normal_queue: the batch stops at the next broadcast and sampled consumables are measured
+        size_t ProcessConsumables( TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>& queue, size_t max_to_consume, std::shared_ptr<ThreadDataClass>& thread_data, UInt64& consumed_counter
+                                 , bool normal_queue = false )
+        {
+            CONSUMABLE_CLASS* first( NULL );
+            size_t batch_size = queue.frontRange( first, max_to_consume );
+
+            // BROADCAST CHANNEL: the broadcasts are read after the queue, so the ones written before the consumables
+            // we got are seen (the producer publishes a broadcast before adding the next consumables)
+            if ( normal_queue && batch_size && !broadcast_ring.empty() )
+            {
+                std::atomic_thread_fence( std::memory_order_acquire );
+                batch_size = size_t( getConsumablesBeforeNextBroadcast( thread_data, batch_size ) );
+            }
+
+            if ( batch_size == 0 ) return 0;
+
+            // TELEMETRY: the batch is timed only if it holds a sampled consumable
+            const TelemetrySampleRing::Sample* sample( ( normal_queue && telemetry ) ? telemetry_samples[ size_t(thread_data->thread_key) ].front() : NULL );
+            bool timed_batch( sample && sample->position <= consumed_counter + batch_size );
+
+            std::chrono::steady_clock::time_point batch_start;
+            if ( timed_batch ) batch_start = std::chrono::steady_clock::now();
+
+            ConsumableRange<CONSUMABLE_CLASS> batch( first, batch_size );
+
+            ProcessConsumables( batch, thread_data, consumed_counter, std::integral_constant<bool, WorkerHasDoWorkBatch<WORKER_CLASS, CONSUMABLE_CLASS>::value>() );
+
+            // release consumables from the queue
+            queue.pop( batch_size );
+
+            if ( timed_batch ) updateTelemetry( thread_data, batch_start, batch_size );
+
+            return batch_size;
+        };
+
+        //______________________________________________________
+        // TELEMETRY (producer): the consumable just assigned to thread_key is sampled once every telemetry_sample_rate
+        inline void sampleConsumable( size_t thread_key )
+        {
+            ThreadDataClass& thread_data = *thread_datas[thread_key];
+
+            if ( --thread_data.telemetry_countdown ) return;
+
+            thread_data.telemetry_countdown = thread_data.telemetry_sample_rate;
+
+            // position of the consumable in the worker queue (ring full: the sample is skipped)
+            telemetry_samples[thread_key].push( thread_data.thread_num_assigned, std::chrono::steady_clock::now() );
+        };
+
+        //______________________________________________________
+        // TELEMETRY (worker): record the sampled consumables of the batch just processed
+        void updateTelemetry( std::shared_ptr<ThreadDataClass>& thread_data, const std::chrono::steady_clock::time_point& batch_start, size_t batch_size )
+        {
+            std::chrono::steady_clock::time_point batch_end = std::chrono::steady_clock::now();
+
+            WorkTelemetry::WorkerTelemetry& worker_telemetry = telemetry->per_worker[ size_t(thread_data->thread_key) ];
+            TelemetrySampleRing& samples = telemetry_samples[ size_t(thread_data->thread_key) ];
+
+            UInt64 service_usec = UInt64( std::chrono::duration_cast<std::chrono::microseconds>( batch_end - batch_start ).count() ) / batch_size;
+
+            const TelemetrySampleRing::Sample* sample;
+            while ( ( sample = samples.front() ) != NULL && sample->position <= thread_data->thread_num_consumed )
+            {
+                Int64 queue_wait_usec = std::chrono::duration_cast<std::chrono::microseconds>( batch_start - sample->enqueue_time ).count();
+
+                worker_telemetry.queue_wait.add( queue_wait_usec > 0 ? UInt64( queue_wait_usec ) : 0 );
+                worker_telemetry.service_time.add( service_usec );
+
+                samples.pop();
+            }
+        };
+
+        //______________________________________________________
+        // BROADCAST CHANNEL: process the next broadcast if it is due (all the consumables assigned before it are consumed)
+        bool ProcessNextBroadcast( std::shared_ptr<ThreadDataClass>& thread_data )
+        {
+            UInt64 read_sequence = thread_data->thread_broadcast_read;
+
+            if ( read_sequence == broadcast_write_sequence.load( std::memory_order_acquire ) ) return false;
+
+            BroadcastSlot& slot = broadcast_ring[ size_t( read_sequence % broadcast_ring.size() ) ];
+
+            if ( slot.assigned_before[ size_t(thread_data->thread_key) ] > thread_data->thread_num_consumed ) return false;
+
+            // each worker gets its own copy of the slot (a shared_ptr copy for WorkManager works): doWork may reset or
+            // reassign its argument as with a queued consumable, without touching the slot read by the other workers
+            CONSUMABLE_CLASS consumable( slot.consumable );
+            ConsumableRange<CONSUMABLE_CLASS> batch( &consumable, 1 );
+
+            ProcessConsumables( batch, thread_data, thread_data->thread_num_broadcast_consumed, std::integral_constant<bool, WorkerHasDoWorkBatch<WORKER_CLASS, CONSUMABLE_CLASS>::value>() );
+
+            // slot can be overwritten by the producer once all workers moved their cursor
+            std::atomic_thread_fence( std::memory_order_release );
+            thread_data->thread_broadcast_read = read_sequence + 1;
+
+            return true;
+        };
+
+        //______________________________________________________
+        // BROADCAST CHANNEL: number of consumables of the normal queue the worker can process before the next broadcast
+        UInt64 getConsumablesBeforeNextBroadcast( std::shared_ptr<ThreadDataClass>& thread_data, UInt64 max_to_consume )
+        {
+            UInt64 read_sequence = thread_data->thread_broadcast_read;
+
+            if ( read_sequence == broadcast_write_sequence.load( std::memory_order_acquire ) ) return max_to_consume;
+
+            UInt64 assigned_before = broadcast_ring[ size_t( read_sequence % broadcast_ring.size() ) ].assigned_before[ size_t(thread_data->thread_key) ];
+
+            if ( assigned_before <= thread_data->thread_num_consumed ) return 0;
+
+            return std::min<UInt64>( max_to_consume, assigned_before - thread_data->thread_num_consumed );
+        };
+
+        //______________________________________________________
+        // WORKER_CLASS::doWorkBatch: the whole batch in a single call
+        void ProcessConsumables( ConsumableRange<CONSUMABLE_CLASS>& batch, std::shared_ptr<ThreadDataClass>& thread_data, UInt64& consumed_counter, std::true_type )
         {
-            // do the work, the following methods comes from the class WORKER_CLASS
-            bool work_done = workers[ size_t(thread_data->thread_key) ]->doWork( consumable, thread_data->thread_key );
+            workers[ size_t(thread_data->thread_key) ]->doWorkBatch( batch, thread_data->thread_key );
 
             // Increment thread consumed consumables counter.
-            thread_data->thread_num_consumed++;
+            consumed_counter += batch.size();
+        };
+
+        //______________________________________________________
+        // WORKER_CLASS::doWork: one call per consumable
+        void ProcessConsumables( ConsumableRange<CONSUMABLE_CLASS>& batch, std::shared_ptr<ThreadDataClass>& thread_data, UInt64& consumed_counter, std::false_type )
+        {
+            WORKER_CLASS* worker = workers[ size_t(thread_data->thread_key) ];
+
+            for ( size_t i = 0; i < batch.size(); ++i )
+            {
+                // do the work, the following methods comes from the class WORKER_CLASS
+                worker->doWork( batch[i], thread_data->thread_key );
 
-            return work_done;
+                // Increment thread consumed consumables counter (after doWork: routing relies on it)
+                consumed_counter++;
+            }
         };
 
         //______________________________________________________
@@ -380,8 +879,9 @@ namespace QAppNG
             // the total consumed consumables from all threads
 
             // Update pool_total_consumed (it is important for hasPlaceInQueue() method)
+            // removed workers are included: they have consumed all they were assigned
             UInt64 total = 0;
-            for (size_t i = 0; i < number_of_threads; ++i)
+            for (size_t i = 0; i < number_of_slots; ++i)
                 total += thread_datas[i]->thread_num_consumed;
 
             pool_total_consumed = total;
@@ -392,18 +892,46 @@ namespace QAppNG
             // ci venga restituito false quando in realt qualche posto in coda c'.
             // Questo non  un problema, l'importante  che non avvenga il contrario!
 
-            if ( write_back_data )
+            // TELEMETRY: queue fill of running workers (consumed is read first, so it is never above assigned)
+            if ( telemetry )
             {
                 for (size_t i = 0; i < number_of_threads; ++i)
                 {
-                    write_back_data->per_thread_assigned->operator[](i)        = thread_datas[i]->thread_num_assigned;
-                    write_back_data->per_thread_consumed->operator[](i)        = thread_datas[i]->thread_num_consumed;
+                    UInt64 thread_consumed = thread_datas[i]->thread_num_consumed;
+                    telemetry->queue_fill.add( thread_datas[i]->thread_num_assigned - thread_consumed, thread_datas[i]->max_queue_size );
+                }
+            }
+
+            if ( write_back_data )
+            {
+                for (size_t i = 0; i < number_of_slots; ++i)
+                {
+                    // broadcasts not read yet are counted as assigned only for running workers
+                    UInt64 broadcast_assigned = thread_datas[i]->thread_num_broadcast_consumed;
+                    if ( i < number_of_threads )
+                        broadcast_assigned += broadcast_write_sequence.load( std::memory_order_relaxed ) - thread_datas[i]->thread_broadcast_read;
+
+                    write_back_data->per_thread_assigned->operator[](i)        = thread_datas[i]->thread_num_assigned + thread_datas[i]->thread_num_priority_assigned + broadcast_assigned;
+                    write_back_data->per_thread_consumed->operator[](i)        = thread_datas[i]->thread_num_consumed + thread_datas[i]->thread_num_priority_consumed + thread_datas[i]->thread_num_broadcast_consumed;
                     write_back_data->per_thread_last_sleep_msec->operator[](i) = thread_datas[i]->thread_last_sleep;
                     write_back_data->per_thread_number_of_calls->operator[](i) = thread_datas[i]->thread_num_of_calls;
                 }
             }
         };
 
+        //______________________________________________________
+        // thread 0 only: update statistics if the timer expired
+        void updatePoolStatisticsOnTimer( std::chrono::steady_clock::time_point& next_statistics_update, std::chrono::steady_clock::duration statistics_interval )
+        {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            if ( now >= next_statistics_update )
+            {
+                updatePoolStatistics();
+                next_statistics_update = now + statistics_interval;
+            }
+        };
+
         // ____________________________________________________________________
         // Thread Main Loop
         // ____________________________________________________________________
@@ -432,13 +960,31 @@ namespace QAppNG
             if (write_back_data)
                 write_back_data->consumer_TIDs->operator[]( thread_key ) = TID;
 
+            // pin worker to its CPUs (empty set leaves it floating) and store actual placement
+            setCurrentThreadCpuAffinity( thread_data->work_name + "_worker_" + std::to_string( thread_key ), thread_data->cpu_affinity );
+
+            if (write_back_data && write_back_data->consumer_cpu_affinity)
+                write_back_data->consumer_cpu_affinity->operator[]( thread_key ) = getCurrentThreadCpuAffinity().toString();
+
             // get handler to the thread queue
             TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>& queue = *threads_queues[thread_key];
+            TrivialCircularLockFreeQueue<CONSUMABLE_CLASS>* priority_queue = threads_priority_queues[thread_key];
 
             // set counters to limit consumables per loop
             UInt64 consumed = 0;
             UInt32 max_to_consume = thread_data->max_consumables_per_loop;
 
+            // broadcast channel (shared by all workers)
+            bool has_broadcast_channel = !broadcast_ring.empty();
+
+            // priority lane starvation protection
+            UInt64 priority_in_a_row = 0;
+            UInt32 max_priority_burst = thread_data->max_priority_burst ? thread_data->max_priority_burst : 1;
+
+            // pool statistics timer (only thread 0 uses it)
+            std::chrono::steady_clock::duration statistics_interval = std::chrono::milliseconds( thread_data->statistics_update_msec );
+            std::chrono::steady_clock::time_point next_statistics_update = std::chrono::steady_clock::now();
+
             // set adaptive parameter
             UInt64 used_queue_t0         = 0;
             UInt64 used_queue_t1         = 0;
@@ -458,24 +1004,36 @@ namespace QAppNG
             // BEGIN THREAD LOOP
             while ( !thread_data->exit_loop )
             {
-                if ( !queue.empty() && consumed < max_to_consume )
+                if ( priority_queue && !priority_queue->empty() && consumed < max_to_consume
+                    && ( priority_in_a_row < max_priority_burst || queue.empty() ) )
                 {
-                    // copy front element from thread queue
-                    CONSUMABLE_CLASS consumable = queue.front();
+                    // PRIORITY LANE first (up to max_priority_burst in a row if the normal queue is waiting)
+                    size_t processed = ProcessConsumables( *priority_queue, size_t( std::min<UInt64>( max_to_consume - consumed, max_priority_burst ) )
+                        , thread_data, thread_data->thread_num_priority_consumed );
 
-                    // pop front element from thread queue
-                    queue.pop();
+                    consumed          += processed;
+                    priority_in_a_row += processed;
 
-                    // call processing
-                    ProcessConsumable( consumable, thread_data );
+                    // SPECIAL CODE FOR THREAD 0: Update Statistics (on timer, not for each consumable)
+                    if (thread_key == 0 && allStarted) updatePoolStatisticsOnTimer( next_statistics_update, statistics_interval );
+                }
+                else if ( has_broadcast_channel && consumed < max_to_consume && ProcessNextBroadcast( thread_data ) )
+                {
+                    // BROADCAST CHANNEL: the next broadcast was due
+                    consumed++;
 
-                    // SPECIAL CODE FOR THREAD 0: Update Statistics
-                    if (thread_key == 0 && allStarted)
-                    {
-                        updatePoolStatistics();
-                    }
+                    // SPECIAL CODE FOR THREAD 0: Update Statistics (on timer, not for each consumable)
+                    if (thread_key == 0 && allStarted) updatePoolStatisticsOnTimer( next_statistics_update, statistics_interval );
+                }
+                else if ( !queue.empty() && consumed < max_to_consume )
+                {
+                    // pop a batch of elements from thread queue and process them (not beyond the next broadcast)
+                    consumed += ProcessConsumables( queue, size_t(max_to_consume - consumed), thread_data, thread_data->thread_num_consumed, true );
 
-                    consumed++;
+                    priority_in_a_row = 0;
+
+                    // SPECIAL CODE FOR THREAD 0: Update Statistics (on timer, not for each consumable)
+                    if (thread_key == 0 && allStarted) updatePoolStatisticsOnTimer( next_statistics_update, statistics_interval );
                 }
                 else
                 {
@@ -486,6 +1044,15 @@ namespace QAppNG
                         consumed = 0;
                     }
 
+                    priority_in_a_row = 0;
+
+                    // SPECIAL CODE FOR THREAD 0: Update Statistics before sleeping, so they are not stale while idle
+                    if (thread_key == 0 && allStarted)
+                    {
+                        updatePoolStatistics();
+                        next_statistics_update = std::chrono::steady_clock::now() + statistics_interval;
+                    }
+
                     // do SLEEPING
                     if (thread_data->adaptive_load_balance)
                     {
@@ -529,28 +1096,35 @@ namespace QAppNG
             // END THREAD LOOP
 
             // Let's flush the  queues
-            while ( !queue.empty())
+            while ( priority_queue && !priority_queue->empty() )
             {
-                // copy front element from thread queue
-                CONSUMABLE_CLASS consumable = queue.front();
+                ProcessConsumables( *priority_queue, size_t(thread_data->priority_queue_size), thread_data, thread_data->thread_num_priority_consumed );
+            }
 
-                // pop front element from thread queue
-                queue.pop();
+            while ( true )
+            {
+                // broadcasts in their place between the queued consumables
+                if ( has_broadcast_channel && ProcessNextBroadcast( thread_data ) ) continue;
 
-                // call processing
-                ProcessConsumable( consumable, thread_data );
+                if ( queue.empty() ) break;
 
-                // SPECIAL CODE FOR THREAD 0: Update Statistics
-                if (thread_key == 0 && allStarted)
-                {
-                    updatePoolStatistics();
-                }
+                // pop a batch of elements from thread queue and process them
+                ProcessConsumables( queue, size_t(thread_data->max_queue_size), thread_data, thread_data->thread_num_consumed, true );
+            }
+
+            // SPECIAL CODE FOR THREAD 0: Update Statistics
+            if (thread_key == 0 && allStarted)
+            {
+                updatePoolStatistics();
             }
 
             // DELETE queue
             delete threads_queues[thread_key];
             threads_queues[thread_key] = NULL;
 
+            delete threads_priority_queues[thread_key];
+            threads_priority_queues[thread_key] = NULL;
+
             // Release TID (Thread ID), useful to understand that thread termination is complete
             thread_data->is_running = false;
         };
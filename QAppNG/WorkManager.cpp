@@ -16,6 +16,7 @@
 */
 
 #include "WorkManager.h"
+#include <algorithm>
 #include <pugixml/pugixml.hpp>
 
 // --------------------------------------------------------------------------------------------------------
@@ -29,6 +30,9 @@ namespace QAppNG
         // USE LOCK
         boost::unique_lock<boost::mutex> lock(m_mutex);
 
+        // no telemetry snapshot of a half destroyed WorkManager
+        if ( work_manager_telemetry.get() ) work_manager_telemetry->StopTimer();
+
         // disable getStatus method
         disable_get_status = true;
 
@@ -66,6 +70,43 @@ namespace QAppNG
 
     // --------------------------------------------------------------------------------------------------------
 
+    UInt32 WorkManager::getNumberOfWorkers( size_t work_unique_id )
+    {
+        assert(works_vector[work_unique_id]);
+        return works_vector[work_unique_id]->number_of_workers;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+
+    bool WorkManager::resizeWork( const std::string& work_name, UInt32 number_of_workers )
+    {
+        std::shared_ptr<WorkDataClass> work_data;
+
+        {
+            // USE LOCK: works_map is changed by startWork
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+
+            std::unordered_map< std::string, std::shared_ptr<WorkDataClass> >::iterator it = works_map.find( work_name );
+            if ( it == works_map.end() ) return false;
+
+            work_data = it->second;
+        }
+
+        if ( !work_data->elastic
+            || number_of_workers < work_data->min_number_of_workers
+            || number_of_workers > work_data->max_number_of_workers )
+        {
+            return false;
+        }
+
+        // applied by the producer thread (see __updateElasticPool)
+        work_data->requested_number_of_workers.store( number_of_workers, std::memory_order_release );
+
+        return true;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+
     UInt32 WorkManager::getQueueSize( const std::string& work_name )
     {
         assert(works_map.count(work_name));
@@ -85,9 +126,9 @@ namespace QAppNG
     {
         assert(works_map.count(work_name));
 
-        // we must sum consumed for each worker involved in the WORK
+        // we must sum consumed for each worker involved in the WORK (also removed ones in elastic pools)
         UInt64 consumed(0);
-        for ( size_t i = 0; i < works_map[work_name]->number_of_workers; i++ )
+        for ( size_t i = 0; i < works_map[work_name]->per_thread_consumed->size(); i++ )
             consumed += works_map[work_name]->per_thread_consumed->operator[](i);
 
         return consumed;
@@ -101,6 +142,78 @@ namespace QAppNG
     };	
     // --------------------------------------------------------------------------------------------------------
 
+    namespace
+    {
+        const char* getOverloadStrategyName( WorkDataClass::overload_strategy_enum overload_strategy )
+        {
+            switch ( overload_strategy )
+            {
+                case WorkDataClass::Wait: return "Wait";
+                case WorkDataClass::Shed: return "Shed";
+                case WorkDataClass::Spill: return "Spill";
+                default:                  return "Drop";
+            }
+        }
+
+        // label values (Prometheus) and strings (JSON) share the same escaping
+        std::string escapeTelemetryString( const std::string& value )
+        {
+            std::string output;
+            for ( size_t i = 0; i < value.size(); ++i )
+            {
+                if      ( value[i] == '\\' ) output += "\\\\";
+                else if ( value[i] == '"' )  output += "\\\"";
+                else if ( value[i] == '\n' ) output += "\\n";
+                else                         output += value[i];
+            }
+            return output;
+        }
+
+        void writePrometheusFamily( std::ostream& output, const char* name, const char* type, const char* help )
+        {
+            output << "# HELP " << name << " " << help << "\n";
+            output << "# TYPE " << name << " " << type << "\n";
+        }
+
+        // histogram in seconds: buckets are cumulated, +Inf and _count use the same total (a writer may be running)
+        void writePrometheusHistogram( std::ostream& output, const char* name, const std::string& labels, const LatencyHistogram& histogram )
+        {
+            std::streamsize precision = output.precision( 9 );
+
+            UInt64 cumulated = 0;
+            for ( size_t i = 0; i + 1 < LatencyHistogram::NUMBER_OF_BUCKETS; ++i )
+            {
+                cumulated += histogram.getBucketCount( i );
+                output << name << "_bucket{" << labels << ",le=\"" << LatencyHistogram::getBucketUpperBoundUsec( i ) / 1e6 << "\"} " << cumulated << "\n";
+            }
+            cumulated += histogram.getBucketCount( LatencyHistogram::NUMBER_OF_BUCKETS - 1 );
+
+            output << name << "_bucket{" << labels << ",le=\"+Inf\"} " << cumulated << "\n";
+            output << name << "_sum{" << labels << "} " << histogram.getSumUsec() / 1e6 << "\n";
+            output << name << "_count{" << labels << "} " << cumulated << "\n";
+
+            output.precision( precision );
+        }
+
+        void writeJsonLatency( std::ostream& output, const LatencyHistogram& histogram )
+        {
+            output << "{\"samples\": " << histogram.getCount()
+                   << ", \"sum\": " << histogram.getSumUsec()
+                   << ", \"p50\": " << histogram.getPercentileUsec( 0.50 )
+                   << ", \"p90\": " << histogram.getPercentileUsec( 0.90 )
+                   << ", \"p99\": " << histogram.getPercentileUsec( 0.99 ) << "}";
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------------
+
+    bool WorkManager::hasTelemetry( const std::shared_ptr<WorkDataClass>& work_data )
+    {
+        return work_data->telemetry && work_data->work_type == WorkDataClass::TrivialThreadPool && work_data->thread_data_setup.telemetry_sample_rate;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+
     std::string WorkManager::getStatus()
     {
         std::stringstream output; output.clear(); output.str("");
@@ -133,8 +246,14 @@ namespace QAppNG
             std::stringstream consumer_TIDs_stream; consumer_TIDs_stream.str("");
             std::stringstream last_sleeps_stream; last_sleeps_stream.str("");
             std::stringstream threads_percentual_load; threads_percentual_load.str("");
+            std::stringstream threads_cpu_affinity; threads_cpu_affinity.str("");
             for ( size_t i = 0; i < work_data->consumer_TIDs->size(); i++ )
             {
+                if ( i < work_data->number_of_workers )
+                {
+                    threads_cpu_affinity << work_data->consumer_cpu_affinity->operator[](i) << "; ";
+                }
+
                 if (work_data->consumer_TIDs->operator[](i) > 0)
                 {
                     consumer_TIDs_stream << work_data->consumer_TIDs->operator[](i) << ", ";
@@ -154,15 +273,19 @@ namespace QAppNG
             if (consumer_TIDs_stream.str() == "") consumer_TIDs_stream.str("-");
             if (last_sleeps_stream.str() == "") last_sleeps_stream.str("-");
             if (threads_percentual_load.str() == "") threads_percentual_load.str("-");
+            if (threads_cpu_affinity.str() == "") threads_cpu_affinity.str("-");
 
             UInt64 number_of_calls = 0;
             UInt64 consumed = 0;
             std::ostringstream per_thread_used_queue_output;
-            for ( size_t i = 0; i < work_data->number_of_workers; i++ )
+            for ( size_t i = 0; i < work_data->per_thread_consumed->size(); i++ )
             {
                 number_of_calls += work_data->per_thread_number_of_calls->operator[](i);
                 consumed += work_data->per_thread_consumed->operator[](i);
 
+                // elastic pools: removed workers are counted but not shown
+                if ( i >= work_data->number_of_workers ) continue;
+
                 UInt64 per_thread_used_queue = work_data->per_thread_assigned->operator[](i) - work_data->per_thread_consumed->operator[](i);
                 float per_thread_used_queu_percentage =  100.00 * per_thread_used_queue / work_data->thread_data_setup.max_queue_size;
                 per_thread_used_queue_output << std::resetiosflags( std::ios::floatfield ) << per_thread_used_queue << " (" << std::fixed << std::setprecision(2) << per_thread_used_queu_percentage << "%), ";
@@ -193,14 +316,110 @@ namespace QAppNG
             }
             output << "|- Pool Workers IDs      = " << consumer_TIDs_stream.str()                  << std::endl;
             output << "|- Number of Workers     = " << work_data->number_of_workers                << std::endl;
+            if ( work_data->elastic )
+            {
+                output << "|- Elastic Workers       = min " << work_data->min_number_of_workers
+                       << ", max " << work_data->max_number_of_workers
+                       << ", autoscaling " << ( work_data->autoscaling ? "On" : "Off" )
+                       << ", resizes " << work_data->number_of_resizes
+                       << ( work_data->routing_router->isResizing() ? " (resizing)" : "" )      << std::endl;
+            }
+            if ( work_data->fused )
+            {
+                // consumables run inline by the upstream workers (not counted in produced/consumed)
+                UInt64 fused_consumed = 0;
+                size_t fused_workers  = 0;
+                for ( size_t i = 0; i < work_data->fused_stage_slots.size(); i++ )
+                {
+                    if ( work_data->fused_stage_slots[i].state != WorkDataClass::FusedStageSlot::eUpstreamWorker ) continue;
+
+                    fused_consumed += work_data->fused_stage_slots[i].consumed;
+                    ++fused_workers;
+                }
+
+                output << "|- Fused Into            = " << work_data->fused_into
+                       << " (" << fused_workers << " upstream workers, " << fused_consumed << " consumed inline)" << std::endl;
+            }
             output << "|- Queue Size            = " << work_data->thread_data_setup.max_queue_size << std::endl;
-            output << "|- Routing Paths         = " << work_data->routing_map->size()              << std::endl;
+            if ( work_data->work_type == WorkDataClass::TrivialThreadPool && work_data->thread_data_setup.priority_queue_size )
+            {
+                output << "|- Priority Lane         = size " << work_data->thread_data_setup.priority_queue_size
+                       << ", burst " << work_data->thread_data_setup.max_priority_burst
+                       << ", produced " << work_data->priority_produced << std::endl;
+            }
+            if ( work_data->work_type == WorkDataClass::TrivialThreadPool && work_data->thread_data_setup.broadcast_queue_size )
+            {
+                output << "|- Broadcast Channel     = size " << work_data->thread_data_setup.broadcast_queue_size
+                       << ", broadcasts " << work_data->broadcast_produced << std::endl;
+            }
+            if ( work_data->work_type == WorkDataClass::TrivialThreadPool )
+            {
+                output << "|- Automatic Routing     = " << ( work_data->thread_data_setup.power_of_two_choices_routing ? "PowerOfTwoChoices" : "RoundRobin" ) << std::endl;
+            }
+            if ( work_data->routing_policy == WorkDataClass::RoutingMap )
+            {
+                output << "|- Routing Policy        = RoutingMap"                                  << std::endl;
+                output << "|- Routing Paths         = " << work_data->routing_map->size()              << std::endl;
+            }
+            else
+            {
+                output << "|- Routing Policy        = ConsistentHash"                              << std::endl;
+                output << "|- Routing Overrides     = " << work_data->routing_router->getNumberOfOverrides()
+                       << " (hot key migrations: " << work_data->routing_router->getNumberOfMigrations()
+                       << ", aborted: " << work_data->routing_router->getNumberOfAbortedMigrations()
+                       << ", expired: " << work_data->routing_router->getNumberOfExpiredOverrides() << ")" << std::endl;
+            }
+            if ( work_data->load_shedder )
+            {
+                std::ostringstream load_shedding_output;
+                load_shedding_output << std::fixed << std::setprecision(1)
+                                     << "shed fraction " << work_data->load_shedder->getShedFraction() * 100
+                                     << "%, last queue fill " << work_data->load_shedder->getLastQueueFill() * 100 << "%";
+
+                output << "|- Load Shedding         = " << load_shedding_output.str() << std::endl;
+            }
+            if ( work_data->spill )
+            {
+                output << "|- Spill File            = " << work_data->spill->getFileName()
+                       << " (used " << ( work_data->spill->getUsedBytes() >> 10 ) << " KB, peak " << ( work_data->spill->getPeakUsedBytes() >> 10 )
+                       << " KB of " << ( work_data->spill->getSizeBytes() >> 20 ) << " MB), spilled " << work_data->spill->getNumberOfAppended()
+                       << ", drained " << work_data->spill->getNumberOfPopped() << std::endl;
+            }
             output << "|- Consumable produced   = " << work_data->produced                         << std::endl;
             output << "|- Consumable consumed   = " << consumed                                    << std::endl;
-            output << "|- Consumable dropped    = " << work_data->dropped                          << std::endl;
+            output << "|- Consumable dropped    = " << work_data->dropped;
+            if ( work_data->dropped )
+            {
+                output << " (queue full " << work_data->dropped_queue_full
+                       << ", priority full " << work_data->dropped_priority_queue_full
+                       << ", broadcast full " << work_data->dropped_broadcast_full
+                       << ", removed worker " << work_data->dropped_removed_worker
+                       << ", parking full " << work_data->dropped_parking_full
+                       << ", disabled " << work_data->dropped_disabled
+                       << ", shed " << work_data->dropped_shed
+                       << ", spill " << work_data->dropped_spill << ")";
+            }
+            output                                                                             << std::endl;
             output << "|- Avg Consumables/Call  = " << consumables_per_call                        << std::endl;
             output << "|- Avg Queue Usage       = " << input_average_used_queue_output.str()       << std::endl;
             output << "|- Thread Queue Usage    = " << per_thread_used_queue_output.str()          << std::endl;
+            if ( hasTelemetry( work_data ) )
+            {
+                // all workers merged
+                LatencyHistogram queue_wait, service_time;
+                for ( size_t i = 0; i < work_data->telemetry->per_worker.size(); i++ )
+                {
+                    queue_wait.merge( work_data->telemetry->per_worker[i].queue_wait );
+                    service_time.merge( work_data->telemetry->per_worker[i].service_time );
+                }
+
+                output << "|- Queue Wait (usec)     = p50 " << queue_wait.getPercentileUsec( 0.50 ) << ", p99 " << queue_wait.getPercentileUsec( 0.99 )
+                       << " (" << queue_wait.getCount() << " samples)" << std::endl;
+                output << "|- Service Time (usec)   = p50 " << service_time.getPercentileUsec( 0.50 ) << ", p99 " << service_time.getPercentileUsec( 0.99 )
+                       << " (" << service_time.getCount() << " samples)" << std::endl;
+                output << "|- Queue Fill            = p50 " << work_data->telemetry->queue_fill.getPercentile( 0.50 )
+                       << "%, p99 " << work_data->telemetry->queue_fill.getPercentile( 0.99 ) << "%" << std::endl;
+            }
             
             if(work_data->thread_data_setup.adaptive_load_balance == true)
                 output << "|- Thread Sleep Times    = " << last_sleeps_stream.str() << std::endl;
@@ -208,14 +427,225 @@ namespace QAppNG
                 output << "|- Thread Sleep Times    = " << work_data->thread_data_setup.fixed_sleep_msec << std::endl;
                 	
             output << "|- Thread Load           = " << threads_percentual_load.str()               << std::endl;
+            output << "|- Thread CPU Affinity   = " << threads_cpu_affinity.str()                  << std::endl;
+        }
+
+        // actual placement of all pinned/registered threads (workers, LWS, QVirtualClock, decoupling queues...)
+        std::string threads_placement( getThreadsPlacementStatus() );
+        if ( !threads_placement.empty() )
+        {
+            output << std::endl;
+            output << "THREADS Placement:" << std::endl;
+            output << threads_placement;
+        }
+
+        return output.str();
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+
+    std::string WorkManager::getTelemetryPrometheus()
+    {
+        std::ostringstream output;
+
+        // DO NOT USE LOCK (see getStatus)
+        if (disable_get_status) return output.str();
+
+        // works sorted by name: stable output
+        std::map< std::string, std::shared_ptr<WorkDataClass> > works( works_map.begin(), works_map.end() );
+        std::map< std::string, std::shared_ptr<WorkDataClass> >::iterator it;
+
+        writePrometheusFamily( output, "qappng_work_workers", "gauge", "Running workers of the work." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            output << "qappng_work_workers{work=\"" << escapeTelemetryString( it->first ) << "\"} " << it->second->number_of_workers << "\n";
+        }
+
+        writePrometheusFamily( output, "qappng_work_queue_size", "gauge", "Queue size of each worker." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            output << "qappng_work_queue_size{work=\"" << escapeTelemetryString( it->first ) << "\"} " << it->second->thread_data_setup.max_queue_size << "\n";
+        }
+
+        writePrometheusFamily( output, "qappng_work_produced_total", "counter", "Consumables added to the work." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            output << "qappng_work_produced_total{work=\"" << escapeTelemetryString( it->first ) << "\"} " << it->second->produced << "\n";
+        }
+
+        writePrometheusFamily( output, "qappng_work_dropped_total", "counter", "Consumables dropped, by overload strategy and reason." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            std::shared_ptr<WorkDataClass>& work_data = it->second;
+
+            std::string labels( "work=\"" + escapeTelemetryString( it->first ) + "\",strategy=\""
+                + getOverloadStrategyName( work_data->overload_strategy ) + "\",reason=\"" );
+
+            output << "qappng_work_dropped_total{" << labels << "queue_full\"} "          << work_data->dropped_queue_full          << "\n";
+            output << "qappng_work_dropped_total{" << labels << "priority_queue_full\"} " << work_data->dropped_priority_queue_full << "\n";
+            output << "qappng_work_dropped_total{" << labels << "broadcast_full\"} "      << work_data->dropped_broadcast_full      << "\n";
+            output << "qappng_work_dropped_total{" << labels << "removed_worker\"} "      << work_data->dropped_removed_worker      << "\n";
+            output << "qappng_work_dropped_total{" << labels << "parking_full\"} "        << work_data->dropped_parking_full        << "\n";
+            output << "qappng_work_dropped_total{" << labels << "disabled\"} "            << work_data->dropped_disabled            << "\n";
+            output << "qappng_work_dropped_total{" << labels << "shed\"} "                << work_data->dropped_shed                << "\n";
+            output << "qappng_work_dropped_total{" << labels << "spill\"} "               << work_data->dropped_spill               << "\n";
+        }
+
+        writePrometheusFamily( output, "qappng_work_worker_assigned_total", "counter", "Consumables assigned to each worker." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            for ( size_t i = 0; i < it->second->per_thread_assigned->size(); i++ )
+            {
+                output << "qappng_work_worker_assigned_total{work=\"" << escapeTelemetryString( it->first ) << "\",worker=\"" << i << "\"} "
+                       << it->second->per_thread_assigned->operator[](i) << "\n";
+            }
+        }
+
+        writePrometheusFamily( output, "qappng_work_worker_consumed_total", "counter", "Consumables processed by each worker." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            for ( size_t i = 0; i < it->second->per_thread_consumed->size(); i++ )
+            {
+                output << "qappng_work_worker_consumed_total{work=\"" << escapeTelemetryString( it->first ) << "\",worker=\"" << i << "\"} "
+                       << it->second->per_thread_consumed->operator[](i) << "\n";
+            }
+        }
+
+        writePrometheusFamily( output, "qappng_work_queue_fill_percent", "gauge", "Worker queue fill percentiles (sampled on the pool statistics timer)." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            if ( !hasTelemetry( it->second ) ) continue;
+
+            const QueueFillHistogram& queue_fill = it->second->telemetry->queue_fill;
+            std::string labels( "work=\"" + escapeTelemetryString( it->first ) + "\",quantile=\"" );
+
+            output << "qappng_work_queue_fill_percent{" << labels << "0.5\"} "  << queue_fill.getPercentile( 0.50 ) << "\n";
+            output << "qappng_work_queue_fill_percent{" << labels << "0.9\"} "  << queue_fill.getPercentile( 0.90 ) << "\n";
+            output << "qappng_work_queue_fill_percent{" << labels << "0.99\"} " << queue_fill.getPercentile( 0.99 ) << "\n";
+            output << "qappng_work_queue_fill_percent{" << labels << "1\"} "    << queue_fill.getPercentile( 1.00 ) << "\n";
+        }
+
+        writePrometheusFamily( output, "qappng_work_queue_wait_seconds", "histogram", "Time from addConsumable to the worker picking it (sampled)." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            if ( !hasTelemetry( it->second ) ) continue;
+
+            for ( size_t i = 0; i < it->second->telemetry->per_worker.size(); i++ )
+            {
+                std::ostringstream labels;
+                labels << "work=\"" << escapeTelemetryString( it->first ) << "\",worker=\"" << i << "\"";
+                writePrometheusHistogram( output, "qappng_work_queue_wait_seconds", labels.str(), it->second->telemetry->per_worker[i].queue_wait );
+            }
+        }
+
+        writePrometheusFamily( output, "qappng_work_service_time_seconds", "histogram", "Processing time per consumable (sampled batches)." );
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            if ( !hasTelemetry( it->second ) ) continue;
+
+            for ( size_t i = 0; i < it->second->telemetry->per_worker.size(); i++ )
+            {
+                std::ostringstream labels;
+                labels << "work=\"" << escapeTelemetryString( it->first ) << "\",worker=\"" << i << "\"";
+                writePrometheusHistogram( output, "qappng_work_service_time_seconds", labels.str(), it->second->telemetry->per_worker[i].service_time );
+            }
+        }
+
+        return output.str();
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+
+    std::string WorkManager::getTelemetryJson()
+    {
+        std::ostringstream output;
+
+        // DO NOT USE LOCK (see getStatus)
+        if (disable_get_status) return "{\"works\": []}\n";
+
+        std::map< std::string, std::shared_ptr<WorkDataClass> > works( works_map.begin(), works_map.end() );
+        std::map< std::string, std::shared_ptr<WorkDataClass> >::iterator it;
+
+        output << "{\"works\": [";
+
+        for ( it = works.begin(); it != works.end(); ++it )
+        {
+            std::shared_ptr<WorkDataClass>& work_data = it->second;
+
+            std::string type("Disabled");
+            if      (work_data->work_type == WorkDataClass::No_MultiThread)    type = "No_MultiThread";
+            else if (work_data->work_type == WorkDataClass::TrivialThreadPool) type = "TrivialThreadPool";
+
+            UInt64 consumed = 0;
+            for ( size_t i = 0; i < work_data->per_thread_consumed->size(); i++ ) consumed += work_data->per_thread_consumed->operator[](i);
+
+            output << ( it == works.begin() ? "\n" : ",\n" );
+            output << "  {\"name\": \"" << escapeTelemetryString( it->first ) << "\""
+                   << ", \"type\": \"" << type << "\""
+                   << ", \"status\": \"" << ( work_data->current_work_state == WorkDataClass::eWorkRunning ? "Running" : "Stopped" ) << "\""
+                   << ", \"workers\": " << work_data->number_of_workers
+                   << ", \"queue_size\": " << work_data->thread_data_setup.max_queue_size
+                   << ", \"overload_strategy\": \"" << getOverloadStrategyName( work_data->overload_strategy ) << "\""
+                   << ", \"produced\": " << work_data->produced
+                   << ", \"consumed\": " << consumed
+                   << ",\n   \"dropped\": {\"total\": " << work_data->dropped
+                   << ", \"queue_full\": " << work_data->dropped_queue_full
+                   << ", \"priority_queue_full\": " << work_data->dropped_priority_queue_full
+                   << ", \"broadcast_full\": " << work_data->dropped_broadcast_full
+                   << ", \"removed_worker\": " << work_data->dropped_removed_worker
+                   << ", \"parking_full\": " << work_data->dropped_parking_full
+                   << ", \"disabled\": " << work_data->dropped_disabled
+                   << ", \"shed\": " << work_data->dropped_shed
+                   << ", \"spill\": " << work_data->dropped_spill << "}";
+
+            if ( hasTelemetry( work_data ) )
+            {
+                const QueueFillHistogram& queue_fill = work_data->telemetry->queue_fill;
+
+                output << ",\n   \"queue_fill_percent\": {\"samples\": " << queue_fill.getCount()
+                       << ", \"p50\": " << queue_fill.getPercentile( 0.50 )
+                       << ", \"p90\": " << queue_fill.getPercentile( 0.90 )
+                       << ", \"p99\": " << queue_fill.getPercentile( 0.99 )
+                       << ", \"max\": " << queue_fill.getPercentile( 1.00 ) << "}";
+            }
+
+            output << ",\n   \"per_worker\": [";
+
+            for ( size_t i = 0; i < work_data->per_thread_consumed->size(); i++ )
+            {
+                UInt64 assigned = work_data->per_thread_assigned->operator[](i);
+                UInt64 worker_consumed = work_data->per_thread_consumed->operator[](i);
+
+                output << ( i == 0 ? "\n" : ",\n" );
+                output << "    {\"worker\": " << i
+                       << ", \"running\": " << ( i < work_data->number_of_workers ? "true" : "false" )
+                       << ", \"assigned\": " << assigned
+                       << ", \"consumed\": " << worker_consumed
+                       << ", \"queue_used\": " << ( assigned > worker_consumed ? assigned - worker_consumed : 0 );
+
+                if ( hasTelemetry( work_data ) )
+                {
+                    output << ",\n     \"queue_wait_usec\": ";
+                    writeJsonLatency( output, work_data->telemetry->per_worker[i].queue_wait );
+                    output << ", \"service_time_usec\": ";
+                    writeJsonLatency( output, work_data->telemetry->per_worker[i].service_time );
+                }
+
+                output << "}";
+            }
+
+            output << "]}";
         }
 
+        output << "\n]}\n";
+
         return output.str();
     };
 
     // --------------------------------------------------------------------------------------------------------
 
-    bool WorkManager::loadWorkSetup( const std::string& xml_config_filename, const std::string& work_name, std::shared_ptr<WorkDataClass> work_setup )
+    bool WorkManager::loadWorkSetup( const std::string& xml_config_filename, const std::string& work_name, std::shared_ptr<WorkDataClass> work_setup
+        , std::vector<std::string> fusion_chain )
     {
         // TODO!!! XML!!!
         pugi::xml_document xml_doc;
@@ -262,10 +692,12 @@ namespace QAppNG
 
             if      (overload_strategy == "Drop") work_setup->overload_strategy = WorkDataClass::Drop;
             else if (overload_strategy == "Wait") work_setup->overload_strategy = WorkDataClass::Wait;
+            else if (overload_strategy == "Shed") work_setup->overload_strategy = WorkDataClass::Shed;
+            else if (overload_strategy == "Spill") work_setup->overload_strategy = WorkDataClass::Spill;
             else
             {
                 std::ostringstream errorStr;
-                errorStr<<"Unknown overload strategy:"<<overload_strategy<<" in "<<xml_config_filename<<":"<<work_name<<". Valid settings:'Drop','Wait'";
+                errorStr<<"Unknown overload strategy:"<<overload_strategy<<" in "<<xml_config_filename<<":"<<work_name<<". Valid settings:'Drop','Wait','Shed','Spill'";
                 throw std::runtime_error(errorStr.str());
             }
         }
@@ -274,9 +706,109 @@ namespace QAppNG
             work_setup->overload_strategy = WorkDataClass::Drop;
         }
 
+        // SET ROUTING POLICY
+        if ( my_work.attribute("routing_policy") )
+        {
+            std::string routing_policy = my_work.attribute("routing_policy").value();
+
+            if      (routing_policy == "ConsistentHash") work_setup->routing_policy = WorkDataClass::ConsistentHash;
+            else if (routing_policy == "RoutingMap")     work_setup->routing_policy = WorkDataClass::RoutingMap;
+            else
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Unknown routing policy:"<<routing_policy<<" in "<<xml_config_filename<<":"<<work_name<<". Valid settings:'ConsistentHash','RoutingMap'";
+                throw std::runtime_error(errorStr.str());
+            }
+        }
+        else
+        {
+            work_setup->routing_policy = WorkDataClass::ConsistentHash;
+        }
+
+        // SET AUTOMATIC ROUTING (addConsumable without routing key)
+        if ( my_work.attribute("automatic_routing") )
+        {
+            std::string automatic_routing = my_work.attribute("automatic_routing").value();
+
+            if      (automatic_routing == "RoundRobin")        work_setup->thread_data_setup.power_of_two_choices_routing = false;
+            else if (automatic_routing == "PowerOfTwoChoices") work_setup->thread_data_setup.power_of_two_choices_routing = true;
+            else
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Unknown automatic routing:"<<automatic_routing<<" in "<<xml_config_filename<<":"<<work_name<<". Valid settings:'RoundRobin','PowerOfTwoChoices'";
+                throw std::runtime_error(errorStr.str());
+            }
+        }
+        else
+            work_setup->thread_data_setup.power_of_two_choices_routing = false;
+
+        if ( my_work.attribute("hot_key_rebalancing") )
+        {
+            std::string hot_key_rebalancing = my_work.attribute("hot_key_rebalancing").value();
+
+            if      (hot_key_rebalancing == "True")  work_setup->hot_key_rebalancing = true;
+            else if (hot_key_rebalancing == "False") work_setup->hot_key_rebalancing = false;
+            else
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Unknown hot key rebalancing:"<<hot_key_rebalancing<<" in "<<xml_config_filename<<":"<<work_name<<". Valid settings:'True','False'";
+                throw std::runtime_error(errorStr.str());
+            }
+        }
+        else
+            work_setup->hot_key_rebalancing = false;
+
+        work_setup->rebalancing_window = my_work.attribute("rebalancing_window").as_uint(100000);
+
         // SET NUMBER OF WORKERS (correction based on work type are applied in WorkManager::__startWork)
         work_setup->number_of_workers = my_work.attribute("number_of_workers").as_int(1);
 
+        // SET ELASTIC POOL: number_of_workers is the initial value
+        // e.g. <Work name="Decoder" number_of_workers="4" min_number_of_workers="2" max_number_of_workers="8" autoscaling="True"/>
+        work_setup->min_number_of_workers = my_work.attribute("min_number_of_workers").as_uint(0);
+        work_setup->max_number_of_workers = my_work.attribute("max_number_of_workers").as_uint(0);
+
+        if ( ( work_setup->min_number_of_workers || work_setup->max_number_of_workers )
+            && ( work_setup->work_type != WorkDataClass::TrivialThreadPool || work_setup->routing_policy != WorkDataClass::ConsistentHash ) )
+        {
+            std::ostringstream errorStr;
+            errorStr<<"Elastic work not allowed in "<<xml_config_filename<<":"<<work_name<<". Valid settings: type 'TrivialThreadPool' and routing_policy 'ConsistentHash'";
+            throw std::runtime_error(errorStr.str());
+        }
+
+        if ( my_work.attribute("autoscaling") )
+        {
+            std::string autoscaling = my_work.attribute("autoscaling").value();
+
+            if      (autoscaling == "True")  work_setup->autoscaling = true;
+            else if (autoscaling == "False") work_setup->autoscaling = false;
+            else
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Unknown autoscaling:"<<autoscaling<<" in "<<xml_config_filename<<":"<<work_name<<". Valid settings:'True','False'";
+                throw std::runtime_error(errorStr.str());
+            }
+        }
+        else
+            work_setup->autoscaling = false;
+
+        work_setup->scaling_interval_msec  = my_work.attribute("scaling_interval_msec").as_uint(10000);
+        work_setup->scale_up_queue_fill    = my_work.attribute("scale_up_queue_fill").as_float(0.5f);
+        work_setup->scale_down_queue_fill  = my_work.attribute("scale_down_queue_fill").as_float(0.05f);
+        work_setup->scale_up_cpu_load      = my_work.attribute("scale_up_cpu_load").as_float(0.8f);
+        work_setup->scale_down_cpu_load    = my_work.attribute("scale_down_cpu_load").as_float(0.3f);
+
+        // SET SHED STRATEGY CONTROLLER (overload_strategy="Shed")
+        work_setup->shed_high_queue_fill   = my_work.attribute("shed_high_queue_fill").as_float(0.8f);
+        work_setup->shed_low_queue_fill    = my_work.attribute("shed_low_queue_fill").as_float(0.5f);
+        work_setup->shed_fraction_step     = my_work.attribute("shed_fraction_step").as_float(0.05f);
+        work_setup->shed_interval_msec     = my_work.attribute("shed_interval_msec").as_uint(100);
+
+        // SET SPILL FILE (overload_strategy="Spill")
+        work_setup->spill_file             = my_work.attribute("spill_file").value();
+        work_setup->spill_file_size_mb     = my_work.attribute("spill_file_size_mb").as_uint(256);
+        work_setup->spill_drain_interval_msec = my_work.attribute("spill_drain_interval_msec").as_uint(10);
+
         // SET MAX QUEUE SIZE
         work_setup->thread_data_setup.max_queue_size = my_work.attribute("max_queue_size").as_int(100000);
 
@@ -306,6 +838,126 @@ namespace QAppNG
 
         work_setup->thread_data_setup.fixed_sleep_msec = my_work.attribute("fixed_sleep_msec").as_int(300);
 
+        // SET POOL STATISTICS UPDATE PERIOD (collected by worker 0)
+        work_setup->thread_data_setup.statistics_update_msec = my_work.attribute("statistics_update_msec").as_int(10);
+
+        // SET PRIORITY LANE (off by default: priority consumables go in the normal queue until priority_queue_size is set)
+        work_setup->thread_data_setup.priority_queue_size = my_work.attribute("priority_queue_size").as_uint(0);
+        work_setup->thread_data_setup.max_priority_burst  = my_work.attribute("max_priority_burst").as_uint(64);
+
+        // SET BROADCAST CHANNEL (broadcast_queue_size="0": broadcasts are queued to each worker)
+        work_setup->thread_data_setup.broadcast_queue_size = my_work.attribute("broadcast_queue_size").as_uint(1024);
+
+        // SET TELEMETRY (telemetry_sample_rate="0" disables it)
+        work_setup->thread_data_setup.telemetry_sample_rate = my_work.attribute("telemetry_sample_rate").as_uint(256);
+
+        // SET CPU AFFINITY: whole work (attribute) and single workers (<Worker key="n" cpu_affinity="..."/> children)
+        // e.g. <Work name="Decoder" number_of_workers="4" cpu_affinity="4-7"> <Worker key="0" cpu_affinity="4"/> </Work>
+        work_setup->thread_data_setup.cpu_affinity = CpuSet( my_work.attribute("cpu_affinity").value() );
+        work_setup->thread_data_setup.per_worker_cpu_affinity.clear();
+
+        for ( pugi::xml_node worker = my_work.child("Worker"); worker; worker = worker.next_sibling("Worker") )
+        {
+            if ( !worker.attribute("key") )
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Missing Worker key in "<<xml_config_filename<<":"<<work_name<<". Syntax: <Worker key=\"0\" cpu_affinity=\"0-3\"/>";
+                throw std::runtime_error(errorStr.str());
+            }
+
+            size_t worker_key = worker.attribute("key").as_uint();
+
+            // elastic pools: workers added up to max_number_of_workers can have their own affinity
+            size_t max_worker_key = std::max( size_t( work_setup->number_of_workers ), size_t( work_setup->max_number_of_workers ) );
+
+            if ( worker_key >= max_worker_key )
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Worker key "<<worker.attribute("key").value()<<" out of range in "<<xml_config_filename<<":"<<work_name<<". Valid keys: 0 to "<<max_worker_key - 1<<" (number_of_workers, max_number_of_workers)";
+                throw std::runtime_error(errorStr.str());
+            }
+
+            if ( work_setup->thread_data_setup.per_worker_cpu_affinity.size() <= worker_key )
+            {
+                work_setup->thread_data_setup.per_worker_cpu_affinity.resize( worker_key + 1 );
+            }
+
+            work_setup->thread_data_setup.per_worker_cpu_affinity[worker_key] = CpuSet( worker.attribute("cpu_affinity").value() );
+        }
+
+        // SET STAGE FUSION: a Stage with fuse="True" is run inline by the workers of the last not fused Stage before it
+        // e.g. <Pipeline name="Ingest"> <Stage work="Decode"/> <Stage work="UserContext" fuse="True"/> </Pipeline>
+        work_setup->fused_into.clear();
+
+        for ( pugi::xml_node pipeline = works.child("Pipeline"); pipeline; pipeline = pipeline.next_sibling("Pipeline") )
+        {
+            std::string upstream_work("");
+
+            for ( pugi::xml_node stage = pipeline.child("Stage"); stage; stage = stage.next_sibling("Stage") )
+            {
+                std::string stage_work = stage.attribute("work").value();
+                bool        fuse       = false;
+
+                if ( stage.attribute("fuse") )
+                {
+                    std::string fuse_value = stage.attribute("fuse").value();
+
+                    if      (fuse_value == "True")  fuse = true;
+                    else if (fuse_value == "False") fuse = false;
+                    else
+                    {
+                        std::ostringstream errorStr;
+                        errorStr<<"Unknown stage fuse:"<<fuse_value<<" in "<<xml_config_filename<<":"<<pipeline.attribute("name").value()<<":"<<stage_work<<". Valid settings:'True','False'";
+                        throw std::runtime_error(errorStr.str());
+                    }
+                }
+
+                if ( fuse && stage_work == work_name )
+                {
+                    if ( upstream_work.empty() || ( !work_setup->fused_into.empty() && work_setup->fused_into != upstream_work ) )
+                    {
+                        std::ostringstream errorStr;
+                        errorStr<<"Stage fusion not allowed in "<<xml_config_filename<<":"<<pipeline.attribute("name").value()<<":"<<work_name<<". A fused Stage needs one not fused Stage before it (in all Pipelines)";
+                        throw std::runtime_error(errorStr.str());
+                    }
+
+                    work_setup->fused_into = upstream_work;
+                }
+
+                if ( !fuse ) upstream_work = stage_work;
+            }
+        }
+
+        // fused stage runs on upstream threads: routing must be the same (same key -> same worker)
+        if ( !work_setup->fused_into.empty() )
+        {
+            // the upstream work may be fused too: A fused into B fused into A would never end
+            fusion_chain.push_back( work_name );
+
+            if ( std::find( fusion_chain.begin(), fusion_chain.end(), work_setup->fused_into ) != fusion_chain.end() )
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Stage fusion cycle in "<<xml_config_filename<<":"<<work_name<<" (fused into "<<work_setup->fused_into<<")";
+                throw std::runtime_error(errorStr.str());
+            }
+
+            std::shared_ptr<WorkDataClass> upstream_setup( new WorkDataClass );
+
+            // hot key rebalancing moves keys of one work only: the two works would not route a key to the same worker anymore
+            if ( !loadWorkSetup( xml_config_filename, work_setup->fused_into, upstream_setup, fusion_chain )
+                || work_setup->work_type != WorkDataClass::TrivialThreadPool || upstream_setup->work_type != WorkDataClass::TrivialThreadPool
+                || work_setup->number_of_workers != upstream_setup->number_of_workers || work_setup->routing_policy != upstream_setup->routing_policy
+                || work_setup->min_number_of_workers || work_setup->max_number_of_workers
+                || upstream_setup->min_number_of_workers || upstream_setup->max_number_of_workers
+                || work_setup->hot_key_rebalancing || upstream_setup->hot_key_rebalancing )
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Stage fusion not allowed in "<<xml_config_filename<<":"<<work_name<<" (fused into "<<work_setup->fused_into<<")"
+                        <<". Valid settings: both works with type 'TrivialThreadPool', the same number_of_workers and routing_policy, not elastic, no hot_key_rebalancing";
+                throw std::runtime_error(errorStr.str());
+            }
+        }
+
         return true;
     };
 
@@ -315,6 +967,12 @@ namespace QAppNG
     {
         if (!works_map.count(work_name)) return false;
 
+        // consumables parked by hot key rebalancing go back to their old worker before stopping
+        if ( works_map[work_name]->routing_handover_flusher ) works_map[work_name]->routing_handover_flusher();
+
+        // spilled consumables are given to the workers before stopping
+        if ( works_map[work_name]->spill_flusher ) works_map[work_name]->spill_flusher();
+
         // set Work to STOPPED state (so adding consumable is disabled)
         works_map[work_name]->current_work_state = WorkDataClass::eWorkStopped;
 
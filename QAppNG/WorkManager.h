@@ -10,6 +10,13 @@
 * #????       A. Della Villa                                                   Oct-2008      Original development
 * #4331       A. Della Villa                                                   Nov-2009      WorkManager version 2.0
 * #5536       A. Della Villa                                                   Dec-2010      New user-defined routing policy
+* #user-029   QAppNG Team                                                      Oct-2026      Typed WorkHandle returned by startWork
+* #user-031   QAppNG Team                                                      Oct-2026      Pipeline stage fusion
+* #user-032   QAppNG Team                                                      Oct-2026      Priority lane (addPriorityConsumable)
+* #user-033   QAppNG Team                                                      Oct-2026      Broadcast channel (broadcastConsumable)
+* #user-034   QAppNG Team                                                      Oct-2026      Telemetry exports (Prometheus text, JSON)
+* #user-036   QAppNG Team                                                      Oct-2026      Session preserving load shedding (Shed strategy)
+* #user-037   QAppNG Team                                                      Oct-2026      Disk spill of overflow consumables (Spill strategy)
 *
 * @endhistory
 * ===================================================================================================================
@@ -23,7 +30,11 @@
 #include <vector>
 #include <iostream>
 #include <unordered_map>
+#include <functional>
+#include <chrono>
+#include <atomic>
 #include <exception>
+#include <typeindex>
 #include <boost/array.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/locks.hpp>
@@ -34,6 +45,10 @@
 #include "Singleton.h"
 #include "TrivialThreadPool.h"
 #include "WorkManagerStatus.h"
+#include "WorkRouting.h"
+#include "WorkTelemetry.h"
+#include "WorkOverload.h"
+#include "QObservable.h"
 
 namespace QAppNG
 {
@@ -42,6 +57,26 @@ namespace QAppNG
     // forward declaration of FicticiousWorker used for NO_Multithread case
     template<class WORK_CLASS> class FicticiousWorker;
 
+    // forward declaration of WorkHandle returned by startWork
+    template<class WORK_CONSUMABLE_CLASS, class WORK_CLASS> class WorkHandle;
+
+    // --------------------------------------------------------------------------------------------------------
+
+    // std::atomic member of WorkDataClass, which is copied from the work setup by startWork (copy is not atomic)
+    template<typename T>
+    class WorkDataAtomic : public std::atomic<T>
+    {
+    public:
+        WorkDataAtomic( T value = T() ) : std::atomic<T>( value ) {}
+        WorkDataAtomic( const WorkDataAtomic& other ) : std::atomic<T>( other.load( std::memory_order_acquire ) ) {}
+
+        WorkDataAtomic& operator=( const WorkDataAtomic& other )
+        {
+            this->store( other.load( std::memory_order_acquire ), std::memory_order_release );
+            return *this;
+        }
+    };
+
     // --------------------------------------------------------------------------------------------------------
     //                                             *** WorkDataClass ***
     // --------------------------------------------------------------------------------------------------------
@@ -55,19 +90,53 @@ namespace QAppNG
     */
     class WorkDataClass
     {
-        // Declare WorkManager as FRIEND CLASS
+        // Declare WorkManager and WorkHandle as FRIEND CLASSes
         friend class WorkManager;
+        template<class WORK_CONSUMABLE_CLASS, class WORK_CLASS> friend class WorkHandle;
 
     public:
         WorkDataClass()
             : number_of_workers(1)
             , work_type(TrivialThreadPool)
             , overload_strategy(Drop)
+            , shed_high_queue_fill(0.8f)
+            , shed_low_queue_fill(0.5f)
+            , shed_fraction_step(0.05f)
+            , shed_interval_msec(100)
+            , spill_file_size_mb(256)
+            , spill_drain_interval_msec(10)
+            , routing_policy(ConsistentHash)
+            , hot_key_rebalancing(false)
+            , rebalancing_window(100000)
+            , min_number_of_workers(0)
+            , max_number_of_workers(0)
+            , autoscaling(false)
+            , scaling_interval_msec(10000)
+            , scale_up_queue_fill(0.5f)
+            , scale_down_queue_fill(0.05f)
+            , scale_up_cpu_load(0.8f)
+            , scale_down_cpu_load(0.3f)
             , current_work_state(eWorkRunning)
             , work_name("no_work_name_defined")
             , thread_pool_destroyer(NULL)
             , produced(0)
             , dropped(0)
+            , dropped_queue_full(0)
+            , dropped_priority_queue_full(0)
+            , dropped_broadcast_full(0)
+            , dropped_removed_worker(0)
+            , dropped_parking_full(0)
+            , dropped_disabled(0)
+            , dropped_shed(0)
+            , dropped_spill(0)
+            , elastic(false)
+            , requested_number_of_workers(0)
+            , number_of_resizes(0)
+            , autoscaling_counter(0)
+            , autoscaling_last_cpu_usec(0)
+            , fused(false)
+            , priority_produced(0)
+            , broadcast_produced(0)
         {
             routing_map.reset( new std::unordered_map<UInt64, UInt64>() );
         };
@@ -75,7 +144,53 @@ namespace QAppNG
         // Work Setup
         UInt32 number_of_workers;
         enum work_type_enum { No_MultiThread, TrivialThreadPool, Disabled } work_type;
-        enum overload_strategy_enum { Drop, Wait } overload_strategy;
+        enum overload_strategy_enum { Drop, Wait, Shed, Spill } overload_strategy;
+
+        // Shed overload strategy (TrivialThreadPool only): whole sessions are dropped instead of random consumables.
+        // The session key is the QObservable context key (if the consumable has one) or the user defined routing key;
+        // the shed fraction of sessions follows the fullest worker queue (see SessionLoadShedder). Consumables of the
+        // sessions that are not shed, without session key, priority and broadcast ones are never dropped (Wait).
+        float  shed_high_queue_fill;
+        float  shed_low_queue_fill;
+        float  shed_fraction_step;
+        UInt32 shed_interval_msec;
+
+        // Spill overload strategy (TrivialThreadPool of QObservable consumables, setSpillDecoder before startWork): when a
+        // worker queue is full the consumable is written in a memory mapped spill file (spill_file, empty means
+        // "<work_name>.spill" in the current directory: it must not exist, its name is removed as soon as it is created)
+        // of spill_file_size_mb and it is given back to its worker when the queue has place again, by the next
+        // addConsumable calls or by the spill drainer thread every spill_drain_interval_msec (producer idle). Once
+        // something is spilled the next consumables follow it in the file, so their order is kept; priority and
+        // broadcast ones Wait. Routing is fixed: hot key rebalancing and elastic resize are disabled.
+        std::string spill_file;
+        UInt32      spill_file_size_mb;
+        UInt32      spill_drain_interval_msec;
+
+        // User defined routing: ConsistentHash needs no memory per key, RoutingMap is the old learned map
+        // (bounded to MAX_NUMBER_OF_ROUTING_PATHS keys). Hot keys can be moved only with ConsistentHash.
+        enum routing_policy_enum { ConsistentHash, RoutingMap } routing_policy;
+        bool   hot_key_rebalancing;
+        UInt64 rebalancing_window;
+
+        // Elastic pool (TrivialThreadPool with ConsistentHash routing): number_of_workers is the initial value and it
+        // can move in [min_number_of_workers, max_number_of_workers] (0 means number_of_workers) using resizeWork
+        // or, if autoscaling is enabled, every scaling_interval_msec following queue fill and workers CPU load
+        UInt32 min_number_of_workers;
+        UInt32 max_number_of_workers;
+        bool   autoscaling;
+        UInt32 scaling_interval_msec;
+        float  scale_up_queue_fill;
+        float  scale_down_queue_fill;
+        float  scale_up_cpu_load;
+        float  scale_down_cpu_load;
+
+        // Stage fusion (<Pipeline> in xml): name of the upstream work whose workers run this work inline, empty if not fused.
+        // When a worker of fused_into adds a (not broadcast) consumable to this work, doWork runs right away on the same
+        // thread (on an instance of WORK_CLASS owned by that thread), without queue. Other producers use the pool as usual.
+        // ATTENTION: the fused WORK_CLASS instance is NOT the pool worker with the same thread key: per key state kept in
+        // WORK_CLASS members is split between the two if other producers add consumables (with the same keys) to this work.
+        // Fuse a keyed work only if the upstream work is its only producer.
+        std::string fused_into;
 
         // Thread Setup
         ThreadDataClass thread_data_setup;
@@ -102,6 +217,29 @@ namespace QAppNG
         UInt64 produced;
         UInt64 dropped;
 
+        // dropped consumables by reason (their sum is dropped)
+        UInt64 dropped_queue_full;              // Drop strategy: worker queue full
+        UInt64 dropped_priority_queue_full;     // Drop strategy: worker priority lane full
+        UInt64 dropped_broadcast_full;          // Drop strategy: broadcast channel full (once per worker)
+        UInt64 dropped_removed_worker;          // routed by thread key to a worker removed by a resize
+        UInt64 dropped_parking_full;            // resize parking full, Drop overload strategy
+        UInt64 dropped_disabled;                // Disabled work
+        UInt64 dropped_shed;                    // Shed strategy: session shed by the overload controller
+        UInt64 dropped_spill;                   // Spill strategy: spill file full or consumable not encoded/decoded
+
+        // Shed strategy: shed fraction controller (producer thread only)
+        std::shared_ptr< SessionLoadShedder > load_shedder;
+
+        // Spill strategy: ConsumableSpillFile<WORK_CONSUMABLE_CLASS> (producer thread or spill drainer, with the drainer
+        // mutex) and its flusher called by stopWork. The drainer is declared after thread_pool and spill: it is deleted
+        // (and its thread joined) first
+        std::shared_ptr< SpillFile > spill;
+        std::function<void()> spill_flusher;
+        std::shared_ptr< SpillDrainer > spill_drainer;
+
+        // queue wait, service time and queue fill distributions (TrivialThreadPool only)
+        std::shared_ptr< WorkTelemetry > telemetry;
+
         // Thread IDs
         boost::optional< UInt64 > producer_TID;
 
@@ -111,10 +249,56 @@ namespace QAppNG
         std::shared_ptr< std::vector<UInt64> > per_thread_number_of_calls;
         std::shared_ptr< std::vector<UInt64> > per_thread_last_sleep_msec;
         std::shared_ptr< std::vector<UInt64> > consumer_TIDs;
+        std::shared_ptr< std::vector<std::string> > consumer_cpu_affinity;
 
         // user defined THREADs ROUTING MAP
-        // when user specify a routing_key this map is used to lear the routes
+        // when user specify a routing_key this map is used to lear the routes (RoutingMap policy only)
         std::shared_ptr< std::unordered_map<UInt64, UInt64> > routing_map;
+
+        // user defined THREADs ROUTER (ConsistentHash policy)
+        std::shared_ptr< ConsistentHashRouter > routing_router;
+
+        // gives back consumables parked by the router (key handover or resize), called by stopWork
+        std::function<void()> routing_handover_flusher;
+
+        // Elastic pool operative data: requested_number_of_workers is written by resizeWork (any thread)
+        // and applied by the producer thread in the next addConsumable
+        bool                   elastic;
+        WorkDataAtomic<UInt64> requested_number_of_workers;
+        UInt64                 number_of_resizes;
+        UInt64                 autoscaling_counter;
+        UInt64                 autoscaling_last_cpu_usec;
+        std::chrono::steady_clock::time_point autoscaling_last_check;
+
+        // Stage fusion operative data: one slot for each thread (indexed by ThreadCounter thread id),
+        // each slot is written only by its own thread
+        struct FusedStageSlot
+        {
+            enum fused_stage_state_enum { eUnknownThread, eUpstreamWorker, eNotUpstreamWorker };
+
+            FusedStageSlot() : state(eUnknownThread), thread_key(0), consumed(0) {};
+
+            fused_stage_state_enum  state;
+            UInt64                  thread_key;     // thread key of the upstream worker
+            UInt64                  consumed;
+            std::shared_ptr<void>   worker;         // WORK_CLASS instance used by this thread
+
+            // slots are written by different threads: keep them on different cache lines
+            UInt8                   padding[64];
+        };
+
+        bool                         fused;
+        std::vector<FusedStageSlot>  fused_stage_slots;
+
+        // WorkDataClass of fused_into, set by startWork of this work or of the upstream one (whichever comes last):
+        // read by producers with std::atomic_load, NULL until the upstream work is started
+        std::shared_ptr<WorkDataClass> fused_upstream;
+
+        // consumables added to the priority lane (they are counted also in produced)
+        UInt64 priority_produced;
+
+        // broadcasts (counted once, produced counts one consumable per worker)
+        UInt64 broadcast_produced;
     };
 
     // --------------------------------------------------------------------------------------------------------
@@ -129,6 +313,7 @@ namespace QAppNG
     class WorkManager: public Singleton<WorkManager>
     {
         friend class Singleton<WorkManager>;
+        template<class WORK_CONSUMABLE_CLASS, class WORK_CLASS> friend class WorkHandle;
 
         static const size_t MAX_NUMBER_OF_WORK = 256;
 
@@ -139,35 +324,37 @@ namespace QAppNG
         //____________________________________________________________________________________________________________
         // START WORK METHOD 1: uses configuration LOADED from xml file
         template < class WORK_CONSUMABLE_CLASS, class WORK_CLASS >
-        bool startWork( const std::string& work_name
+        WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS> startWork( const std::string& work_name
             , const std::string& xml_config_filename
             , std::shared_ptr<typename WORK_CLASS::ThreadInitClass> work_init_data = std::shared_ptr<typename WORK_CLASS::ThreadInitClass>() )
         {
             std::shared_ptr<WorkDataClass> work_setup( new WorkDataClass );
-            if ( loadWorkSetup( xml_config_filename, work_name, work_setup ) )
+            if ( loadWorkSetup( xml_config_filename, work_name, work_setup )
+                && __startWork<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name, work_setup, work_init_data ) )
             {
-                return __startWork<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name, work_setup, work_init_data );
+                return getWorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name );
             }
             else
             {
-                return false;
+                return WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>();
             }
         };
 
         //____________________________________________________________________________________________________________
         // START WORK METHOD 2: complete configuration structure is given (work_setup) and INIT-DATA is optional
         template < class WORK_CONSUMABLE_CLASS, class WORK_CLASS >
-        bool startWork( const std::string& work_name
+        WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS> startWork( const std::string& work_name
             , std::shared_ptr<WorkDataClass> work_setup
             , std::shared_ptr<typename WORK_CLASS::ThreadInitClass> work_init_data = std::shared_ptr<typename WORK_CLASS::ThreadInitClass>() )
         {
-            return __startWork<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name, work_setup, work_init_data );
+            return __startWork<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name, work_setup, work_init_data )
+                ? getWorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name ) : WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>();
         };
 
         //____________________________________________________________________________________________________________
         // START WORK METHOD 3: parameters are given and NO-INIT-DATA is passed to WORKERs
         template < class WORK_CONSUMABLE_CLASS, class WORK_CLASS >
-        bool startWork( const std::string& work_name
+        WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS> startWork( const std::string& work_name
             , UInt32 number_of_workers = 1
             , UInt32 worker_max_queue_size = 100000
             , WorkDataClass::work_type_enum work_type = WorkDataClass::TrivialThreadPool
@@ -185,13 +372,14 @@ namespace QAppNG
             work_setup->thread_data_setup.adaptive_max_sleep_msec  = 400;
             work_setup->thread_data_setup.fixed_sleep_msec         = 300;
 
-            return __startWork<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name, work_setup, std::shared_ptr<typename WORK_CLASS::ThreadInitClass>() );
+            return __startWork<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name, work_setup, std::shared_ptr<typename WORK_CLASS::ThreadInitClass>() )
+                ? getWorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name ) : WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>();
         };
 
         //____________________________________________________________________________________________________________
         // START WORK METHOD 4: parameters are given and INIT-DATA is passed to WORKERs
         template < class WORK_CONSUMABLE_CLASS, class WORK_CLASS >
-        bool startWork( const std::string& work_name
+        WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS> startWork( const std::string& work_name
             , std::shared_ptr<typename WORK_CLASS::ThreadInitClass> work_init_data
             , UInt32 number_of_workers
             , UInt32 worker_max_queue_size = 100000
@@ -210,7 +398,8 @@ namespace QAppNG
             work_setup->thread_data_setup.adaptive_max_sleep_msec  = 400;
             work_setup->thread_data_setup.fixed_sleep_msec         = 300;
 
-            return __startWork<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name, work_setup, work_init_data );
+            return __startWork<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name, work_setup, work_init_data )
+                ? getWorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_name ) : WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>();
         };
 
 
@@ -220,16 +409,7 @@ namespace QAppNG
         inline bool addConsumable( const std::string& work_name
             , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
         {
-            std::shared_ptr<WorkDataClass> work_data
-                = works_map[work_name];
-
-            std::shared_ptr< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS > > thread_pool
-                = std::static_pointer_cast<TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >>(work_data->thread_pool);
-
-            UInt64 automatic_routing_thread_key(thread_pool->getPoolTotalAssigned() % work_data->number_of_workers);
-
-            // Call method: __addConsumable specifying Automatic Consumable Routing
-            return __addConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, eAutomaticRouting, automatic_routing_thread_key );
+            return __addConsumableWithAutomaticRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_map[work_name], work_consumable );
         };
 
         //____________________________________________________________________________________________________________
@@ -238,17 +418,7 @@ namespace QAppNG
         inline bool addConsumable( size_t work_unique_id
             , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
         {
-            std::shared_ptr<WorkDataClass> work_data
-                = works_vector[work_unique_id];
-
-            std::shared_ptr< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS > > thread_pool
-                = std::static_pointer_cast<TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS > >(work_data->thread_pool);
-
-            UInt64 automatic_routing_thread_key( thread_pool->getPoolTotalAssigned() % work_data->number_of_workers );
-
-
-            // Call method: __addConsumable specifying Automatic Consumable Routing
-            return __addConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, eAutomaticRouting, automatic_routing_thread_key);
+            return __addConsumableWithAutomaticRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_vector[work_unique_id], work_consumable );
         };
 
         //____________________________________________________________________________________________________________
@@ -258,98 +428,110 @@ namespace QAppNG
             , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
             , UInt64 user_defined_routing_key, bool broadcast)
         {
-            std::shared_ptr<WorkDataClass> work_data( works_map[work_name] );
-            UInt64 thread_key;
+            return __addConsumableWithUserDefinedRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_map[work_name], work_consumable, user_defined_routing_key, broadcast );
+        };
 
-            // the following assert is not needed if no routing key is used
-            assert( work_data->number_of_workers );
+        //____________________________________________________________________________________________________________
+        // ADD CONSUMABLE METHOD 4: lookup by work_unique_id (FAST LOOKUP), USER-DEFINED-CONSUMABLE-ROUTING between threads
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool addConsumable( size_t work_unique_id
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+            , UInt64 user_defined_routing_key, bool broadcast )
+        {
+            return __addConsumableWithUserDefinedRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_vector[work_unique_id], work_consumable, user_defined_routing_key, broadcast );
+        };
 
-            // OLD Map-Based routing policy
+        //____________________________________________________________________________________________________________
+        // ADD PRIORITY CONSUMABLE METHODs: same as ADD CONSUMABLE METHODs but the consumable goes in the priority lane
+        // of the worker, drained before its normal queue (control events: context deletes, configuration, time pulses...).
+        // It is not ordered with normal consumables and it is never parked by routing handovers.
+        // The lane is off by default (priority_queue_size="0"): the consumable then goes in the normal queue.
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool addPriorityConsumable( const std::string& work_name
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
+        {
+            return __addConsumableWithAutomaticRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_map[work_name], work_consumable, true );
+        };
 
-            if (!broadcast)
-            {
-                if (!work_data->routing_map->count(user_defined_routing_key))
-                {
-                    // #10650: We reached Maximum number of routing paths.
-                    // An exception is thrown to notify we are having too many routing keys
-                    // for any WORK_CONSUMABLE_CLASS
-                    if (work_data->routing_map->size() > MAX_NUMBER_OF_ROUTING_PATHS)
-                    {
-                        std::ostringstream error_message;
-                        error_message << "WorkManager - Maximum Number Of Routing Path Exceeded - "
-                            << "Work Name: " << work_data->work_name;
-
-                        throw std::runtime_error(error_message.str().c_str());
-                    }
-
-                    work_data->routing_map->insert(std::unordered_map< UInt64, UInt64 >::value_type
-                        (user_defined_routing_key, work_data->routing_map->size() % work_data->number_of_workers));
-                }
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool addPriorityConsumable( size_t work_unique_id
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
+        {
+            return __addConsumableWithAutomaticRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_vector[work_unique_id], work_consumable, true );
+        };
 
-                thread_key = work_data->routing_map->operator[]( user_defined_routing_key );
-            }
-            else
-            {
-                // A broadcast event is routed by threadId
-                thread_key = user_defined_routing_key;
-            }
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool addPriorityConsumable( const std::string& work_name
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+            , UInt64 user_defined_routing_key, bool broadcast)
+        {
+            return __addConsumableWithUserDefinedRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_map[work_name], work_consumable, user_defined_routing_key, broadcast, true );
+        };
 
-            // NEW routing policy
-            //UInt64 thread_key = user_defined_routing_key % work_data->number_of_workers;
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool addPriorityConsumable( size_t work_unique_id
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+            , UInt64 user_defined_routing_key, bool broadcast )
+        {
+            return __addConsumableWithUserDefinedRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_vector[work_unique_id], work_consumable, user_defined_routing_key, broadcast, true );
+        };
+
+        //____________________________________________________________________________________________________________
+        // BROADCAST: the consumable is processed once by each worker, after the consumables already routed to it.
+        // With a broadcast channel (TrivialThreadPool broadcast_queue_size > 0) it is written once and each worker
+        // gets its own copy of the shared pointer (as without channel, the pointed consumable is the same for all)
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool broadcastConsumable( const std::string& work_name
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
+        {
+            return __broadcastConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_map[work_name], work_consumable );
+        };
 
-            // Call method: __addConsumable using thred_key calculated from user_defined_routing_key
-            return __addConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_map[work_name], work_consumable, eUserDefinedRouting, thread_key );
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool broadcastConsumable( size_t work_unique_id
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
+        {
+            return __broadcastConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_vector[work_unique_id], work_consumable );
         };
 
         //____________________________________________________________________________________________________________
-        // ADD CONSUMABLE METHOD 4: lookup by work_unique_id (FAST LOOKUP), USER-DEFINED-CONSUMABLE-ROUTING between threads
+        // GET WORK HANDLE: typed handle to add consumables to a running work without any lookup (see WorkHandle)
+        // it is not valid if the work is not running
         template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
-        inline bool addConsumable( size_t work_unique_id
-            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
-            , UInt64 user_defined_routing_key, bool broadcast )
+        WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS> getWorkHandle( const std::string& work_name )
         {
-            std::shared_ptr<WorkDataClass> work_data( works_vector[work_unique_id] );
-            UInt64 thread_key;
+            std::unordered_map<std::string, std::shared_ptr<WorkDataClass> >::iterator it = works_map.find( work_name );
 
-            // the following assert is not needed if no routing key is used
-            assert( work_data->number_of_workers );
+            if ( it == works_map.end() ) return WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>();
 
-            // OLD Map-Based routing policy
+            return WorkHandle<WORK_CONSUMABLE_CLASS, WORK_CLASS>( this, it->second );
+        };
 
-            if (!broadcast)
-            {
-                if ( !work_data->routing_map->count(user_defined_routing_key) )
-                {
-                    // #10650: We reached Maximum number of routing paths.
-                    // An exception is thrown to notify we are having too many routing keys
-                    // for any WORK_CONSUMABLE_CLASS
-                    if( work_data->routing_map->size() > MAX_NUMBER_OF_ROUTING_PATHS )
-                    {
-                        std::ostringstream error_message;
-                        error_message << "WorkManager - Maximum Number Of Routing Path Exceeded - "
-                                      << "Work Name: " << work_data->work_name;
-
-                        throw std::runtime_error( error_message.str().c_str() );
-                    }
-
-                    work_data->routing_map->insert( std::unordered_map< UInt64, UInt64 >::value_type
-                        ( user_defined_routing_key, work_data->routing_map->size() % work_data->number_of_workers ) );
-                }
+        //____________________________________________________________________________________________________________
+        // SPILL DECODER: rebuild a consumable spilled by a work with Spill overload strategy from its QObservable network
+        // header and payload. It must be set before startWork: a Spill work without decoder is refused (startWork throws).
+        // Setting it again for a running work replaces the decoder
+        template <class WORK_CONSUMABLE_CLASS>
+        bool setSpillDecoder( const std::string& work_name, const typename ConsumableSpillFile<WORK_CONSUMABLE_CLASS>::DecoderType& decoder )
+        {
+            if ( !decoder ) return false;
 
-                thread_key = work_data->routing_map->operator[]( user_defined_routing_key );
-            }
-            else
+            // USE LOCK
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+
+            spill_decoders.erase( work_name );
+            spill_decoders.insert( std::make_pair( work_name, std::make_pair( std::type_index( typeid(WORK_CONSUMABLE_CLASS) )
+                , std::shared_ptr<void>( new typename ConsumableSpillFile<WORK_CONSUMABLE_CLASS>::DecoderType( decoder ) ) ) ) );
+
+            std::unordered_map<std::string, std::shared_ptr<WorkDataClass> >::iterator it = works_map.find( work_name );
+
+            if ( it != works_map.end() && it->second->spill )
             {
-                 // A broadcast event is routed by threadId
-                thread_key = user_defined_routing_key;
+                std::lock_guard<std::mutex> spill_lock( it->second->spill_drainer->getMutex() );
+                static_cast< ConsumableSpillFile<WORK_CONSUMABLE_CLASS>* >( it->second->spill.get() )->setDecoder( decoder );
             }
 
-            // NEW routing policy
-            // This policy doesn't guarantee agood lad balangind between threads
-            //UInt64 thread_key = user_defined_routing_key % work_data->number_of_workers;
-
-            // Call method: __addConsumable using thred_key calculated from user_defined_routing_key
-            return __addConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( works_vector[work_unique_id], work_consumable, eUserDefinedRouting, thread_key );
+            return true;
         };
 
         //____________________________________________________________________________________________________________
@@ -361,6 +543,7 @@ namespace QAppNG
         WorkDataClass::work_type_enum getWorkType( const std::string& work_name );
         size_t getWorkUniqueId( const std::string& work_name );
         UInt32 getNumberOfWorkers( const std::string& work_name );
+        UInt32 getNumberOfWorkers( size_t work_unique_id );
         UInt32 getQueueSize( const std::string& work_name );
         UInt64 getNumberOfDropped( const std::string& work_name );
         UInt64 getNumberOfConsumed( const std::string& work_name );
@@ -379,16 +562,51 @@ namespace QAppNG
             }
         };
 
+        //______________________________________________________
+        // TELEMETRY REPORT: machine readable snapshots of all works (Prometheus text format and JSON), each file
+        // is rewritten every status_rate seconds (an empty file name disables it)
+        void startTelemetryReport( const std::string& prometheus_file_name, const std::string& json_file_name, UInt16 status_rate )
+        {
+            if ( !work_manager_telemetry.get() )
+            {
+                work_manager_telemetry.reset( new WorkManagerStatus( "", fastdelegate::FastDelegate0<std::string>() ) );
+
+                if ( !prometheus_file_name.empty() )
+                {
+                    work_manager_telemetry->addSnapshot( prometheus_file_name, fastdelegate::FastDelegate0<std::string>(this, &WorkManager::getTelemetryPrometheus) );
+                }
+
+                if ( !json_file_name.empty() )
+                {
+                    work_manager_telemetry->addSnapshot( json_file_name, fastdelegate::FastDelegate0<std::string>(this, &WorkManager::getTelemetryJson) );
+                }
+
+                work_manager_telemetry->StartTimer( status_rate );
+            }
+        };
+
+        //____________________________________________________________________________________________________________
+        // RESIZE WORK (elastic pools only): number_of_workers is applied by the producer in its next addConsumable.
+        // It can be called from any thread (e.g. a CLI command). False if the work is not elastic or out of range.
+        bool resizeWork( const std::string& work_name, UInt32 number_of_workers );
+
         //______________________________________________________
         std::string getStatus();
 
+        //______________________________________________________
+        // TELEMETRY snapshots: counters, drops by reason, queue wait/service time histograms (usec), queue fill percentiles
+        std::string getTelemetryPrometheus();
+        std::string getTelemetryJson();
+
         //______________________________________________________
         void shutdown();
 
     private:
         //____________________________________________________________________________________________________________
         // LOAD a WORK from xml file and start it (to make WorkManager load work configuration from file, an xml file should be passed to startWork methdod)
-        bool loadWorkSetup( const std::string& xml_config_filename, const std::string& work_name, std::shared_ptr<WorkDataClass> work_setup );
+        // fusion_chain: works loaded so far to check stage fusion (fused_into of fused_into...), to detect fusion cycles
+        bool loadWorkSetup( const std::string& xml_config_filename, const std::string& work_name, std::shared_ptr<WorkDataClass> work_setup
+            , std::vector<std::string> fusion_chain = std::vector<std::string>() );
 
         // CTOR
         WorkManager() : Singleton<WorkManager>(), works_vector(MAX_NUMBER_OF_WORK), work_vector_element_counter(0), disable_get_status(false) { };
@@ -401,12 +619,21 @@ namespace QAppNG
         std::vector< std::shared_ptr<WorkDataClass> > works_vector;
         size_t work_vector_element_counter;
 
+        // spill decoders by work name (ConsumableSpillFile<consumable type>::DecoderType), set before startWork
+        std::unordered_map<std::string, std::pair< std::type_index, std::shared_ptr<void> > > spill_decoders;
+
         // Strategy to route current consumable (used internally by addConsumable & __addConsumable methods
         enum CurrentConsumableRouting { eAutomaticRouting, eUserDefinedRouting };
 
         // Status handler, it provides status output on file
         std::unique_ptr<WorkManagerStatus> work_manager_status;
 
+        // Telemetry snapshots handler
+        std::unique_ptr<WorkManagerStatus> work_manager_telemetry;
+
+        // works with telemetry (pools with telemetry_sample_rate > 0)
+        static bool hasTelemetry( const std::shared_ptr<WorkDataClass>& work_data );
+
         // enable/disable status: it is used to inhibit getStatus during stopWork
         bool disable_get_status;
 
@@ -416,17 +643,164 @@ namespace QAppNG
             , std::shared_ptr<WorkDataClass> work_setup
             , std::shared_ptr<typename WORK_CLASS::ThreadInitClass> work_init_data );
 
+        // ADD CONSUMABLE with AUTOMATIC-CONSUMABLE-ROUTING (used by addConsumable methods and WorkHandle)
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool __addConsumableWithAutomaticRouting( std::shared_ptr<WorkDataClass>& work_data
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+            , bool priority = false );
+
+        // ADD CONSUMABLE with USER-DEFINED-CONSUMABLE-ROUTING (used by addConsumable methods and WorkHandle)
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool __addConsumableWithUserDefinedRouting( std::shared_ptr<WorkDataClass>& work_data
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+            , UInt64 user_defined_routing_key, bool broadcast
+            , bool priority = false );
+
+        // USER DEFINED ROUTING: routing_key -> thread_key (depends on work routing_policy)
+        // it can return ConsistentHashRouter::PARKING_THREAD_KEY: work_consumable is kept by the router
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline UInt64 __getUserDefinedThreadKey( std::shared_ptr<WorkDataClass>& work_data
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+            , UInt64 user_defined_routing_key );
+
+        // add consumables released by the router at the end of a key handover or of a resize
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline void __addReleasedConsumables( std::shared_ptr<WorkDataClass>& work_data
+            , std::vector< ConsistentHashRouter::ParkedConsumable >& released_consumables );
+
+        // ELASTIC POOL: follow resize transition, autoscaling and apply requested_number_of_workers
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        void __updateElasticPool( std::shared_ptr<WorkDataClass>& work_data );
+
+        // STAGE FUSION: run the consumable inline if the calling thread is a worker of the upstream work
+        // (returns false if it is not, work_done is the doWork result)
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool __runFusedStage( std::shared_ptr<WorkDataClass>& work_data
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+            , bool& work_done );
+
+        // BROADCAST to all workers (broadcast channel or one consumable per worker)
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool __broadcastConsumable( std::shared_ptr<WorkDataClass>& work_data
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable );
+
+        // SHED STRATEGY: update the shed fraction and tell if the session of the consumable is shed (it is counted as dropped)
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline bool __shedConsumable( std::shared_ptr<WorkDataClass>& work_data
+            , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+            , bool has_routing_key, UInt64 user_defined_routing_key );
+
+        // SPILL STRATEGY: give spilled consumables back to their workers (up to max_to_drain, stop at the first full queue
+        // unless wait is set)
+        template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+        inline void __drainSpill( WorkDataClass& work_data, UInt64 max_to_drain, bool wait = false );
+
+        // session key of a consumable: QObservable context key (only for consumables derived from QObservable)
+        template <class WORK_CONSUMABLE_CLASS>
+        static bool __getSessionKey( std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable, UInt64& session_key, std::true_type )
+        {
+            if ( !work_consumable->hasQObservableContextKey() ) return false;
+
+            session_key = work_consumable->getQObservableContextKey();
+            return true;
+        };
+
+        template <class WORK_CONSUMABLE_CLASS>
+        static bool __getSessionKey( std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable, UInt64& session_key, std::false_type )
+        {
+            UNUSED( work_consumable );
+            UNUSED( session_key );
+            return false;
+        };
+
         // ADD CONSUMABLE MAIN METHOD
         template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
         inline bool __addConsumable( std::shared_ptr<WorkDataClass>& work_data
             , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
             , CurrentConsumableRouting routing_type
-            , UInt64 thread_key );
+            , UInt64 thread_key
+            , bool priority = false );
 
         // LOCK: used just for start/stop
         boost::mutex m_mutex;
 
         static const size_t MAX_NUMBER_OF_ROUTING_PATHS = 256000L;
+
+        // Spill strategy: spilled consumables given back to the workers by each addConsumable (at most)
+        static const UInt64 MAX_SPILL_DRAIN_BURST = 64;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+    //                                              *** WorkHandle ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief typed handle to a running WORK, returned by WorkManager::startWork (and getWorkHandle).
+    *
+    *         addConsumable through the handle does not look up the work (no hashing of work_name, no works_vector
+    *         access), does not copy shared pointers and does not cast anything at runtime: it goes straight to
+    *         WorkManager internals with the work data it holds. A default built handle (work not started) is not
+    *         valid and it converts to false, so code using startWork as a bool keeps working.
+    *
+    *         Once the work is stopped the handle is still safe to use: addConsumable returns false.
+    */
+    template<class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    class WorkHandle
+    {
+        friend class WorkManager;
+
+    public:
+        WorkHandle() : m_work_manager(NULL) {};
+
+        // implicit on purpose: code written when startWork returned bool keeps compiling
+        operator bool() const          { return isValid(); };
+        bool isValid() const           { return m_work_data.get() != NULL; };
+
+        size_t      getWorkUniqueId() const    { assert( isValid() ); return m_work_data->work_unique_id; };
+        std::string getWorkName() const        { assert( isValid() ); return m_work_data->work_name; };
+        UInt32      getNumberOfWorkers() const { assert( isValid() ); return m_work_data->number_of_workers; };
+
+        //______________________________________________________
+        // AUTOMATIC-CONSUMABLE-ROUTING between threads
+        inline bool addConsumable( std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
+        {
+            return m_work_manager->__addConsumableWithAutomaticRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( m_work_data, work_consumable );
+        };
+
+        //______________________________________________________
+        // USER-DEFINED-CONSUMABLE-ROUTING between threads
+        inline bool addConsumable( std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable, UInt64 user_defined_routing_key, bool broadcast )
+        {
+            return m_work_manager->__addConsumableWithUserDefinedRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( m_work_data, work_consumable, user_defined_routing_key, broadcast );
+        };
+
+        //______________________________________________________
+        // PRIORITY LANE (see WorkManager::addPriorityConsumable)
+        inline bool addPriorityConsumable( std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
+        {
+            return m_work_manager->__addConsumableWithAutomaticRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( m_work_data, work_consumable, true );
+        };
+
+        inline bool addPriorityConsumable( std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable, UInt64 user_defined_routing_key, bool broadcast )
+        {
+            return m_work_manager->__addConsumableWithUserDefinedRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( m_work_data, work_consumable, user_defined_routing_key, broadcast, true );
+        };
+
+        //______________________________________________________
+        // BROADCAST to all workers (see WorkManager::broadcastConsumable)
+        inline bool broadcastConsumable( std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
+        {
+            return m_work_manager->__broadcastConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( m_work_data, work_consumable );
+        };
+
+    private:
+        WorkHandle( WorkManager* work_manager, const std::shared_ptr<WorkDataClass>& work_data )
+            : m_work_manager( work_manager )
+            , m_work_data( work_data )
+        {};
+
+        WorkManager*                     m_work_manager;
+        std::shared_ptr<WorkDataClass>   m_work_data;
     };
 
     // --------------------------------------------------------------------------------------------------------
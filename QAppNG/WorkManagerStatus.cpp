@@ -9,6 +9,7 @@
 //
 //
 #include "WorkManagerStatus.h"
+#include <cstdio>
 
 // --------------------------------------------------------------------------------------------------------
 
@@ -24,6 +25,13 @@ namespace QAppNG
 
     // --------------------------------------------------------------------------------------------------------
 
+    void WorkManagerStatus::addSnapshot( const std::string &snapshot_file_name, fastdelegate::FastDelegate0<std::string> get_snapshot_method )
+    {
+        m_snapshots.push_back( std::make_pair( snapshot_file_name, get_snapshot_method ) );
+    }
+
+    // --------------------------------------------------------------------------------------------------------
+
     void WorkManagerStatus::StartTimer( UInt16 status_rate_seconds )
     {
         if (status_rate_seconds > 0)
@@ -43,6 +51,20 @@ namespace QAppNG
 
     void WorkManagerStatus::Dump()
     {
+        // Snapshots: write a temporary file and rename it
+        for ( size_t i = 0; i < m_snapshots.size(); ++i )
+        {
+            std::string temporary_fname( m_snapshots[i].first + ".tmp" );
+
+            std::ofstream snapshot_fp( temporary_fname.c_str(), std::ios::trunc );
+            snapshot_fp << m_snapshots[i].second();
+            snapshot_fp.close();
+
+            std::rename( temporary_fname.c_str(), m_snapshots[i].first.c_str() );
+        }
+
+        if ( m_workmanager_status_fname.empty() ) return;
+
         // Open file in append mode
         if ( !m_status_fp.is_open() )
         {
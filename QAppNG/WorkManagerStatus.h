@@ -15,6 +15,7 @@
 
 // Include STL & BOOST
 #include <string>
+#include <vector>
 #include <fstream>
 
 // other Includes
@@ -30,6 +31,9 @@ namespace QAppNG
     public:
         WorkManagerStatus( const std::string &status_file_name, fastdelegate::FastDelegate0<std::string> get_status_method );
 
+        // snapshot file: rewritten at each dump (written aside and renamed, so readers never get half a file)
+        void addSnapshot( const std::string &snapshot_file_name, fastdelegate::FastDelegate0<std::string> get_snapshot_method );
+
         void StartTimer( UInt16 status_rate_seconds = 5 );
         void StopTimer();
 
@@ -43,6 +47,9 @@ namespace QAppNG
         std::ofstream m_status_fp;
         std::string   m_workmanager_status_fname;
 
+        // snapshot files and their methods
+        std::vector< std::pair< std::string, fastdelegate::FastDelegate0<std::string> > > m_snapshots;
+
         // timer to control status dump
         SimplePeriodicTimer m_status_timer;
     };
@@ -0,0 +1,226 @@
+/** ===================================================================================================================
+* @file    WorkOverload Cpp FILE
+*
+* @brief   WorkManager overload control: memory mapped spill file, spill drainer thread
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-037   QAppNG Team                                                      Oct-2026      Original Development
+* #user-037   QAppNG Team                                                      Oct-2026      Exclusive spill file, SpillDrainer
+* #user-037   QAppNG Team                                                      Oct-2026      Spill file ring
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include "WorkOverload.h"
+#include <cstring>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    SpillFile::SpillFile()
+        : m_file_descriptor( -1 )
+        , m_data( NULL )
+        , m_size( 0 )
+        , m_read_offset( 0 )
+        , m_write_offset( 0 )
+        , m_end_offset( 0 )
+        , m_wrapped( false )
+        , m_peak_used_bytes( 0 )
+        , m_number_of_appended( 0 )
+        , m_number_of_popped( 0 )
+    {
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SpillFile::~SpillFile()
+    {
+        close();
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool SpillFile::open( const std::string& file_name, UInt64 size_bytes )
+    {
+        close();
+
+        m_file_name = file_name;
+
+#ifndef WIN32
+        // O_EXCL: a file of another work or process is never truncated. The name is removed at once: the file
+        // lives while it is mapped, it is not left on disk and no one else can open it
+        m_file_descriptor = ::open( file_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600 );
+        if ( m_file_descriptor < 0 ) return false;
+
+        ::unlink( file_name.c_str() );
+
+        // sparse file: disk blocks are allocated only when written
+        if ( ::ftruncate( m_file_descriptor, off_t( size_bytes ) ) != 0 )
+        {
+            close();
+            return false;
+        }
+
+        void* data = ::mmap( NULL, size_t( size_bytes ), PROT_READ | PROT_WRITE, MAP_SHARED, m_file_descriptor, 0 );
+        if ( data == MAP_FAILED )
+        {
+            close();
+            return false;
+        }
+
+        m_data = static_cast<UInt8*>( data );
+        m_size = size_bytes;
+#else
+        UNUSED( size_bytes );
+#endif
+
+        return isOpen();
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void SpillFile::close()
+    {
+#ifndef WIN32
+        if ( m_data ) ::munmap( m_data, size_t( m_size ) );
+        if ( m_file_descriptor >= 0 ) ::close( m_file_descriptor );
+#endif
+
+        m_file_descriptor = -1;
+        m_data            = NULL;
+        m_size            = 0;
+        m_read_offset     = 0;
+        m_write_offset    = 0;
+        m_end_offset      = 0;
+        m_wrapped         = false;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    bool SpillFile::append( const SpillRecord& record, const UInt8* header, const UInt8* payload )
+    {
+        UInt64 record_length = ( sizeof(SpillRecord) + UInt64( record.header_length ) + record.payload_length + 7 ) & ~UInt64(7);
+
+        if ( !m_data ) return false;
+
+        if ( m_wrapped )
+        {
+            // behind the reader: the record must end before the oldest record
+            if ( m_write_offset + record_length > m_read_offset ) return false;
+        }
+        else if ( m_write_offset + record_length > m_size )
+        {
+            // no room before the end of the file: go on from its beginning if the read records left room there
+            if ( record_length > m_read_offset ) return false;
+
+            m_end_offset   = m_write_offset;
+            m_write_offset = 0;
+            m_wrapped      = true;
+        }
+
+        UInt8* destination = m_data + m_write_offset;
+
+        std::memcpy( destination, &record, sizeof(SpillRecord) );
+        reinterpret_cast<SpillRecord*>( destination )->record_length = UInt32( record_length );
+        destination += sizeof(SpillRecord);
+
+        if ( record.header_length )  std::memcpy( destination, header, record.header_length );
+        destination += record.header_length;
+
+        if ( record.payload_length ) std::memcpy( destination, payload, record.payload_length );
+
+        m_write_offset = m_write_offset + record_length;
+        m_number_of_appended = m_number_of_appended + 1;
+
+        if ( getUsedBytes() > m_peak_used_bytes ) m_peak_used_bytes = getUsedBytes();
+
+        return true;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void SpillFile::pop()
+    {
+        const SpillRecord* record( front() );
+        if ( !record ) return;
+
+        m_read_offset = m_read_offset + record->record_length;
+        m_number_of_popped = m_number_of_popped + 1;
+
+        // end of the records written before the writer wrapped: go on from the beginning of the file
+        if ( m_wrapped && m_read_offset == m_end_offset )
+        {
+            m_read_offset = 0;
+            m_wrapped     = false;
+        }
+
+        // all records read: rewind (the writer has the whole file before it has to wrap)
+        if ( !m_wrapped && m_read_offset == m_write_offset )
+        {
+            m_read_offset  = 0;
+            m_write_offset = 0;
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SpillDrainer::SpillDrainer( const std::function<void()>& drain, UInt32 drain_interval_msec )
+        : m_drain( drain )
+        , m_drain_interval_msec( drain_interval_msec ? drain_interval_msec : 1 )
+        , m_stop( false )
+    {
+        m_thread = std::thread( &SpillDrainer::run, this );
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    SpillDrainer::~SpillDrainer()
+    {
+        stop();
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void SpillDrainer::stop()
+    {
+        {
+            std::lock_guard<std::mutex> stop_lock( m_stop_mutex );
+            m_stop = true;
+        }
+        m_stop_condition.notify_all();
+
+        if ( m_thread.joinable() ) m_thread.join();
+    }
+
+    // --------------------------------------------------------------------------------------------------------------------
+
+    void SpillDrainer::run()
+    {
+        std::unique_lock<std::mutex> stop_lock( m_stop_mutex );
+
+        while ( !m_stop_condition.wait_for( stop_lock, std::chrono::milliseconds( m_drain_interval_msec ), [this]() { return m_stop; } ) )
+        {
+            stop_lock.unlock();
+
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_drain();
+            }
+
+            stop_lock.lock();
+        }
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,366 @@
+/** ===================================================================================================================
+* @file    WorkOverload HEADER FILE
+*
+* @brief   WorkManager overload control: session preserving load shedding, disk spill of overflow consumables
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-036   QAppNG Team                                                      Oct-2026      Original Development
+* #user-037   QAppNG Team                                                      Oct-2026      Memory mapped spill file
+* #user-037   QAppNG Team                                                      Oct-2026      Exclusive spill file, SpillDrainer
+* #user-037   QAppNG Team                                                      Oct-2026      Spill file ring
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_WORK_OVERLOAD_H
+#define QAPPNG_WORK_OVERLOAD_H
+
+// Include STL
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// other Includes
+#include "core.h"
+#include "QObservable.h"
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    // --------------------------------------------------------------------------------------------------------
+    //                                          *** SessionLoadShedder ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief decides which sessions (subscribers, contexts...) of a WORK are shed under sustained overload.
+    *
+    *         Each session key is hashed in [0, FRACTION_ONE): a session is shed when its hash is below the current
+    *         shed fraction, so the decision is the same for all consumables of the session (no state per key) and
+    *         raising the fraction only adds sessions to the shed ones.
+    *         Every update_interval_msec the fullest worker queue is checked: above high_queue_fill the fraction
+    *         grows by fraction_step, below low_queue_fill it goes back by fraction_step, in between it is kept.
+    *
+    *         Producer thread only.
+    *         POOL_CLASS methods used: getThreadUsedQueue(thread_key)
+    */
+    class SessionLoadShedder
+    {
+    public:
+        // fixed point shed fraction: FRACTION_ONE sheds all sessions
+        static const UInt32 FRACTION_ONE            = 0x10000;
+
+        // the clock is read once every 64 consumables (on average the update costs a counter increment)
+        static const UInt32 UPDATE_CHECK_MASK       = 0x3F;
+
+        SessionLoadShedder( float high_queue_fill = 0.8f, float low_queue_fill = 0.5f
+                          , float fraction_step = 0.05f, UInt32 update_interval_msec = 100 )
+            : m_high_queue_fill( high_queue_fill )
+            , m_low_queue_fill( low_queue_fill < high_queue_fill ? low_queue_fill : high_queue_fill )
+            , m_fraction_step( toFraction( fraction_step ) ? toFraction( fraction_step ) : 1 )
+            , m_update_interval_usec( UInt64( update_interval_msec ) * 1000 )
+            , m_fraction( 0 )
+            , m_last_queue_fill( 0 )
+            , m_number_of_updates( 0 )
+            , m_counter( 0 )
+            , m_last_update( std::chrono::steady_clock::now() )
+        {}
+
+        // true if the consumables of session_key have to be shed now
+        inline bool isShed( UInt64 session_key ) const
+        {
+            return m_fraction && UInt32( mixSessionKey( session_key ) >> 48 ) < m_fraction;
+        }
+
+        // called for each consumable: the shed fraction follows the fullest worker queue
+        template <class POOL_CLASS>
+        inline void update( POOL_CLASS& pool, UInt64 number_of_workers, UInt64 max_queue_size )
+        {
+            if ( ( ++m_counter & UPDATE_CHECK_MASK ) != 0 ) return;
+
+            std::chrono::steady_clock::time_point now( std::chrono::steady_clock::now() );
+            if ( UInt64( std::chrono::duration_cast<std::chrono::microseconds>( now - m_last_update ).count() ) < m_update_interval_usec ) return;
+
+            m_last_update = now;
+
+            UInt64 max_used_queue = 0;
+            for ( UInt64 thread_key = 0; thread_key < number_of_workers; ++thread_key )
+            {
+                UInt64 used_queue( pool.getThreadUsedQueue( thread_key ) );
+                if ( used_queue > max_used_queue ) max_used_queue = used_queue;
+            }
+
+            m_last_queue_fill = max_queue_size ? float( max_used_queue ) / float( max_queue_size ) : 0.0f;
+
+            if ( m_last_queue_fill > m_high_queue_fill )
+            {
+                m_fraction = ( m_fraction + m_fraction_step < FRACTION_ONE ) ? m_fraction + m_fraction_step : FRACTION_ONE;
+            }
+            else if ( m_last_queue_fill < m_low_queue_fill )
+            {
+                m_fraction = ( m_fraction > m_fraction_step ) ? m_fraction - m_fraction_step : 0;
+            }
+
+            ++m_number_of_updates;
+        }
+
+        // current shed fraction in [0, 1] and queue fill seen by the last update (status)
+        float  getShedFraction() const      { return float( m_fraction ) / float( FRACTION_ONE ); }
+        float  getLastQueueFill() const     { return m_last_queue_fill; }
+        UInt64 getNumberOfUpdates() const   { return m_number_of_updates; }
+
+    private:
+        // session keys are often small consecutive numbers: spread them (a different mix than the routing one,
+        // so the shed sessions are not the ones of a single worker)
+        static UInt64 mixSessionKey( UInt64 key )
+        {
+            key ^= key >> 33;
+            key *= 0x64DD81482CBD31D7ULL;
+            key ^= key >> 33;
+            key *= 0xE36AA5C613612997ULL;
+            key ^= key >> 33;
+            return key;
+        }
+
+        static UInt32 toFraction( float fraction )
+        {
+            if ( fraction <= 0.0f ) return 0;
+            if ( fraction >= 1.0f ) return FRACTION_ONE;
+            return UInt32( fraction * FRACTION_ONE );
+        }
+
+        float   m_high_queue_fill;
+        float   m_low_queue_fill;
+        UInt32  m_fraction_step;
+        UInt64  m_update_interval_usec;
+
+        // written by the producer, read by status (single word)
+        volatile UInt32 m_fraction;
+        volatile float  m_last_queue_fill;
+        UInt64          m_number_of_updates;
+
+        UInt64                                  m_counter;
+        std::chrono::steady_clock::time_point   m_last_update;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+    //                                              *** SpillFile ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief fixed part of a spill file record, followed by header_length header bytes and payload_length
+    *         payload bytes (QObservable network header and payload). The whole record is 8 bytes aligned.
+    */
+    struct SpillRecord
+    {
+        enum flags_enum { HAS_TIMESTAMP = 0x01, HAS_ROUTING_KEY = 0x02, HAS_CONTEXT_KEY = 0x04 };
+
+        UInt32  record_length;
+        UInt32  header_length;
+        UInt32  payload_length;
+        UInt32  observable_type;
+        UInt64  thread_key;
+        UInt64  timestamp;
+        UInt64  routing_key;
+        UInt64  context_key;
+        UInt32  flags;
+        UInt32  padding;
+    };
+
+    /**
+    *  @brief FIFO of records in a memory mapped file (the OS writes it back at disk bandwidth, memory holds only
+    *         the pages in use). Records are read in the order they were appended. The file is a ring: a record that
+    *         does not fit before the end of the file is written at its beginning, in the space already read, so a
+    *         file drained while it is written never fills up with read records.
+    *
+    *         Not thread safe: WorkManager uses it under the mutex of the SpillDrainer of the work.
+    */
+    class SpillFile
+    {
+    public:
+        SpillFile();
+        virtual ~SpillFile();
+
+        // create file_name with size_bytes and map it: false if it already exists (it is never shared by two works
+        // or processes) or if the OS refused. The name is removed at once, the file is released by close
+        bool open( const std::string& file_name, UInt64 size_bytes );
+        void close();
+        bool isOpen() const { return m_data != NULL; }
+
+        // false if the file has no room for the record (the read records count as room)
+        bool append( const SpillRecord& record, const UInt8* header, const UInt8* payload );
+
+        // oldest record, NULL if empty
+        const SpillRecord* front() const
+        {
+            return !empty() ? reinterpret_cast<const SpillRecord*>( m_data + m_read_offset ) : NULL;
+        }
+
+        static const UInt8* getHeader( const SpillRecord* record )  { return reinterpret_cast<const UInt8*>( record + 1 ); }
+        static const UInt8* getPayload( const SpillRecord* record ) { return getHeader( record ) + record->header_length; }
+
+        void pop();
+        bool empty() const { return !m_wrapped && m_read_offset == m_write_offset; }
+
+        // status
+        const std::string& getFileName() const  { return m_file_name; }
+        UInt64 getSizeBytes() const             { return m_size; }
+        UInt64 getUsedBytes() const             { return m_wrapped ? m_end_offset - m_read_offset + m_write_offset : m_write_offset - m_read_offset; }
+        UInt64 getPeakUsedBytes() const         { return m_peak_used_bytes; }
+        UInt64 getNumberOfAppended() const      { return m_number_of_appended; }
+        UInt64 getNumberOfPopped() const        { return m_number_of_popped; }
+
+    private:
+        SpillFile( const SpillFile& );
+        SpillFile& operator=( const SpillFile& );
+
+        std::string     m_file_name;
+        int             m_file_descriptor;
+        UInt8*          m_data;
+        UInt64          m_size;
+
+        // written by the producer, read by status. m_wrapped: the records are in [m_read_offset, m_end_offset)
+        // and then in [0, m_write_offset), otherwise they are in [m_read_offset, m_write_offset)
+        volatile UInt64 m_read_offset;
+        volatile UInt64 m_write_offset;
+        volatile UInt64 m_end_offset;
+        volatile bool   m_wrapped;
+        UInt64          m_peak_used_bytes;
+        volatile UInt64 m_number_of_appended;
+        volatile UInt64 m_number_of_popped;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+    //                                         *** ConsumableSpillFile ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief SpillFile of QObservable consumables. A consumable is written with getNetworkHeader and
+    *         getNetworkPayloadPtr/Length and rebuilt by the decoder given by the application (the QObservable
+    *         timestamp, routing key and context key are kept by the record and set back after decoding).
+    *         Consumables not derived from QObservable cannot be spilled (see the specialization below).
+    */
+    template <class CONSUMABLE_CLASS, bool IS_QOBSERVABLE = std::is_base_of<QObservable, CONSUMABLE_CLASS>::value>
+    class ConsumableSpillFile : public SpillFile
+    {
+    public:
+        // the network header of a consumable cannot be longer
+        static const size_t MAX_HEADER_LENGTH = 4096;
+
+        typedef std::function< std::shared_ptr<CONSUMABLE_CLASS>( const UInt8* header, size_t header_length
+                                                                , const UInt8* payload, size_t payload_length ) > DecoderType;
+
+        ConsumableSpillFile() : m_header_buffer( MAX_HEADER_LENGTH ) {}
+
+        void setDecoder( const DecoderType& decoder ) { m_decoder = decoder; }
+        bool hasDecoder() const { return bool( m_decoder ); }
+
+        // false if the consumable cannot be spilled (no decoder, file full)
+        bool push( std::shared_ptr<CONSUMABLE_CLASS>& consumable, UInt64 thread_key )
+        {
+            if ( !m_decoder ) return false;
+
+            SpillRecord record;
+            record.header_length   = UInt32( consumable->getNetworkHeader( &m_header_buffer[0], m_header_buffer.size() ) );
+            record.payload_length  = UInt32( consumable->getNetworkPayloadLength() );
+            record.observable_type = UInt32( consumable->GetType() );
+            record.thread_key      = thread_key;
+            record.timestamp       = consumable->getQObservableTimestamp();
+            record.routing_key     = consumable->getQObservableRoutingKey();
+            record.context_key     = consumable->getQObservableContextKey();
+            record.flags           = ( consumable->hasQObservableTimestamp()  ? SpillRecord::HAS_TIMESTAMP   : 0 )
+                                   | ( consumable->hasQObservableRoutingKey() ? SpillRecord::HAS_ROUTING_KEY : 0 )
+                                   | ( consumable->hasQObservableContextKey() ? SpillRecord::HAS_CONTEXT_KEY : 0 );
+
+            const UInt8* payload( record.payload_length ? consumable->getNetworkPayloadPtr() : NULL );
+            if ( !payload ) record.payload_length = 0;
+
+            return append( record, &m_header_buffer[0], payload );
+        }
+
+        // rebuild the oldest consumable (empty pointer if the decoder failed), the record stays in the file
+        std::shared_ptr<CONSUMABLE_CLASS> decodeFront()
+        {
+            const SpillRecord* record( front() );
+            if ( !record ) return std::shared_ptr<CONSUMABLE_CLASS>();
+
+            std::shared_ptr<CONSUMABLE_CLASS> consumable( m_decoder( getHeader( record ), record->header_length, getPayload( record ), record->payload_length ) );
+
+            if ( consumable )
+            {
+                if ( record->flags & SpillRecord::HAS_TIMESTAMP )   consumable->setQObservableTimestamp( record->timestamp );
+                if ( record->flags & SpillRecord::HAS_ROUTING_KEY ) consumable->setQObservableRoutingKey( record->routing_key );
+                if ( record->flags & SpillRecord::HAS_CONTEXT_KEY ) consumable->setQObservableContextKey( record->context_key );
+            }
+
+            return consumable;
+        }
+
+    private:
+        std::vector<UInt8>  m_header_buffer;
+        DecoderType         m_decoder;
+    };
+
+    // consumables not derived from QObservable: nothing can be spilled (WorkManager refuses the Spill strategy)
+    template <class CONSUMABLE_CLASS>
+    class ConsumableSpillFile<CONSUMABLE_CLASS, false> : public SpillFile
+    {
+    public:
+        typedef std::function< std::shared_ptr<CONSUMABLE_CLASS>( const UInt8* header, size_t header_length
+                                                                , const UInt8* payload, size_t payload_length ) > DecoderType;
+
+        void setDecoder( const DecoderType& ) {}
+        bool hasDecoder() const { return false; }
+
+        bool push( std::shared_ptr<CONSUMABLE_CLASS>&, UInt64 ) { return false; }
+        std::shared_ptr<CONSUMABLE_CLASS> decodeFront() { return std::shared_ptr<CONSUMABLE_CLASS>(); }
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+    //                                             *** SpillDrainer ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief thread giving the spilled consumables back to the workers also when the producer is idle: it runs
+    *         drain every drain_interval_msec holding getMutex, which the producer holds on the spill path too
+    *         (so the spill file and the worker queues keep a single writer at a time)
+    */
+    class SpillDrainer
+    {
+    public:
+        SpillDrainer( const std::function<void()>& drain, UInt32 drain_interval_msec );
+        virtual ~SpillDrainer();
+
+        // no drain after it returns
+        void stop();
+
+        std::mutex& getMutex() { return m_mutex; }
+
+    private:
+        SpillDrainer( const SpillDrainer& );
+        SpillDrainer& operator=( const SpillDrainer& );
+
+        void run();
+
+        std::function<void()>   m_drain;
+        UInt32                  m_drain_interval_msec;
+        std::mutex              m_mutex;
+
+        std::mutex              m_stop_mutex;
+        std::condition_variable m_stop_condition;
+        bool                    m_stop;
+        std::thread             m_thread;
+    };
+}
+
+// --------------------------------------------------------------------------------------------------------
+#endif
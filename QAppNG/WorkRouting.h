@@ -0,0 +1,612 @@
+/** ===================================================================================================================
+* @file    WorkRouting HEADER FILE
+*
+* @brief   WorkManager user-defined routing: bounded consistent hashing with hot-key rebalancing
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-027   QAppNG Team                                                      Oct-2026      Original Development
+* #user-028   QAppNG Team                                                      Oct-2026      Resize transition for elastic pools
+* #user-027   QAppNG Team                                                      Oct-2026      Idle overrides go home, overrides kept across resize
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_WORK_ROUTING_H
+#define QAPPNG_WORK_ROUTING_H
+
+// Include STL
+#include <vector>
+#include <memory>
+#include <cassert>
+#include <unordered_map>
+
+// other Includes
+#include "core.h"
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    // --------------------------------------------------------------------------------------------------------
+    //                                         *** ConsistentHashRouter ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief maps a user defined routing key to a worker without learning routes.
+    *
+    *         Base mapping is Jump Consistent Hash (Lamping, Veach): no memory per key, uniform, stable.
+    *         When hot key rebalancing is enabled a small sampled heavy-hitters table finds the keys that
+    *         overload a worker; at the end of each window the hottest movable key of the most loaded worker
+    *         is handed over to the least loaded one:
+    *         1- from the handover start, new consumables of the key are PARKED (not routed)
+    *         2- when the old worker has consumed everything assigned to it before the handover (SAFE POINT,
+    *            queues are FIFO) the key is moved to the override table and parked consumables are released
+    *            to the new worker, so per-key ordering is preserved
+    *         3- if too many consumables get parked the handover is aborted and they go back to the old worker
+    *         Moved keys live in an override table bounded by MAX_NUMBER_OF_ROUTING_OVERRIDES. A moved key not
+    *         seen hot for OVERRIDE_IDLE_WINDOWS windows (or the longest idle one when the table is full) is
+    *         handed back to its Jump Consistent Hash worker with the same handover, and its override is removed.
+    *
+    *         Elastic pools change number_of_workers with resize(): Jump Consistent Hash moves only the keys
+    *         whose bucket changes; each moved key is PARKED until its previous worker has consumed everything
+    *         assigned to it before the resize, then it goes to its new worker (same SAFE POINT rule as above).
+    *         Overrides are carried across the resize: a moved key stays on its worker if it is kept, otherwise
+    *         it follows the new Jump Consistent Hash.
+    *         If the resize parking fills up the consumable is dropped with the Drop overload strategy, the producer
+    *         waits for the next SAFE POINT with the other ones.
+    *
+    *         NB: a worker keeping per-key state (e.g. user contexts) sees a migrated key arriving on
+    *         another worker, this is why rebalancing is disabled by default.
+    *
+    *         POOL_CLASS methods used: getThreadAssigned(thread_key), getThreadConsumed(thread_key)
+    */
+    class ConsistentHashRouter
+    {
+    public:
+        static const size_t MAX_NUMBER_OF_ROUTING_OVERRIDES = 4096;
+        static const UInt64 OVERRIDE_IDLE_WINDOWS           = 16;   // rebalancing windows: then a moved key goes home
+        static const size_t MAX_NUMBER_OF_TRACKED_HOT_KEYS  = 64;
+        static const size_t MAX_NUMBER_OF_PARKED_CONSUMABLES = 4096;
+        static const UInt32 HOT_KEY_SAMPLING_MASK           = 0x0F; // track 1 keyed consumable out of 16 (on average)
+
+        // returned by getThreadKey when the consumable has to be parked (see park())
+        static const UInt64 PARKING_THREAD_KEY              = 0xFFFFFFFFFFFFFFFF;
+
+        // never a worker: the resize parking is full and the consumable is dropped (Drop overload strategy)
+        static const UInt64 DROPPED_THREAD_KEY              = 0xFFFFFFFFFFFFFFFE;
+
+        // parked consumable: key is the routing key while parked, the thread key once released
+        struct ParkedConsumable
+        {
+            UInt64                  key;
+            std::shared_ptr<void>   consumable;
+        };
+
+        ConsistentHashRouter( UInt32 number_of_workers = 1, bool hot_key_rebalancing = false
+                            , UInt64 rebalancing_window = 100000, float rebalancing_imbalance = 0.2f )
+            : m_number_of_workers( number_of_workers ? number_of_workers : 1 )
+            , m_hot_key_rebalancing( hot_key_rebalancing && number_of_workers > 1 )
+            , m_rebalancing_window( rebalancing_window ? rebalancing_window : 1 )
+            , m_rebalancing_imbalance( rebalancing_imbalance )
+            , m_routed_in_window( 0 )
+            , m_sampling_state( 0x9E3779B97F4A7C15ULL )
+            , m_handover_in_progress( false )
+            , m_candidate_key( 0 )
+            , m_candidate_source( 0 )
+            , m_candidate_destination( 0 )
+            , m_candidate_source_last_assigned( 0 )
+            , m_number_of_migrations( 0 )
+            , m_number_of_aborted_migrations( 0 )
+            , m_candidate_homing( false )
+            , m_window_number( 0 )
+            , m_number_of_expired_overrides( 0 )
+            , m_window_start_assigned( m_number_of_workers, 0 )
+            , m_resizing( false )
+            , m_previous_number_of_workers( m_number_of_workers )
+            , m_number_of_resize_parked( 0 )
+            , m_number_of_pending_drains( 0 )
+        {
+            m_hot_keys.reserve( MAX_NUMBER_OF_TRACKED_HOT_KEYS );
+            m_parked_consumables.reserve( MAX_NUMBER_OF_PARKED_CONSUMABLES );
+        }
+
+        //______________________________________________________
+        // Jump Consistent Hash: maps key to [0, number_of_buckets) moving only 1/n keys when n changes
+        static UInt32 jumpConsistentHash( UInt64 key, UInt32 number_of_buckets )
+        {
+            Int64 bucket = -1;
+            Int64 jump   = 0;
+
+            while ( jump < static_cast<Int64>( number_of_buckets ) )
+            {
+                bucket = jump;
+                key = key * 2862933555777941757ULL + 1;
+                jump = static_cast<Int64>( ( bucket + 1 ) * ( double( 1LL << 31 ) / double( ( key >> 33 ) + 1 ) ) );
+            }
+
+            return static_cast<UInt32>( bucket );
+        }
+
+        //______________________________________________________
+        // routing keys are often small consecutive numbers (cell ids, thread ids...): mix them first
+        static UInt64 mixRoutingKey( UInt64 key )
+        {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdULL;
+            key ^= key >> 33;
+            key *= 0xc4ceb9fe1a85ec53ULL;
+            key ^= key >> 33;
+            return key;
+        }
+
+        //______________________________________________________
+        // routing without rebalancing nor resize in progress (no pool needed, see needsPool())
+        inline UInt64 getThreadKey( UInt64 routing_key ) const
+        {
+            if ( !m_overrides.empty() )
+            {
+                std::unordered_map<UInt64, RoutingOverride>::const_iterator it = m_overrides.find( routing_key );
+                if ( it != m_overrides.end() ) return it->second.thread_key;
+            }
+
+            return jumpConsistentHash( mixRoutingKey( routing_key ), m_number_of_workers );
+        }
+
+        //______________________________________________________
+        // routing with hot key rebalancing: it must be called by the (single) producer of the work, AFTER
+        // releasing parked consumables (see releaseParked). PARKING_THREAD_KEY means: call park()
+        template< class POOL_CLASS >
+        inline UInt64 getThreadKey( UInt64 routing_key, POOL_CLASS& pool )
+        {
+            if ( m_resizing ) return getResizingThreadKey( routing_key );
+
+            if ( !m_hot_key_rebalancing ) return getThreadKey( routing_key );
+
+            if ( m_handover_in_progress && routing_key == m_candidate_key ) return PARKING_THREAD_KEY;
+
+            UInt64 thread_key( getThreadKey( routing_key ) );
+
+            // sampled hot keys tracking: xorshift, a fixed stride would alias with periodic traffic patterns
+            m_sampling_state ^= m_sampling_state << 13;
+            m_sampling_state ^= m_sampling_state >> 7;
+            m_sampling_state ^= m_sampling_state << 17;
+
+            if ( ( m_sampling_state & HOT_KEY_SAMPLING_MASK ) == 0 )
+            {
+                trackHotKey( routing_key, thread_key );
+            }
+
+            // end of window: look for a key to move
+            if ( ++m_routed_in_window >= m_rebalancing_window )
+            {
+                chooseMigrationCandidate( pool );
+            }
+
+            return thread_key;
+        }
+
+        //______________________________________________________
+        // store a consumable that got PARKING_THREAD_KEY: false if the parking is full
+        // (hot key handover: abort it, resize: drop with the Drop overload strategy, else wait for a drain)
+        bool park( UInt64 routing_key, const std::shared_ptr<void>& consumable )
+        {
+            ParkedConsumable parked = { routing_key, consumable };
+
+            if ( m_resizing )
+            {
+                if ( m_number_of_resize_parked >= MAX_NUMBER_OF_PARKED_CONSUMABLES ) return false;
+
+                m_resize_parked[ getPreviousThreadKey( routing_key ) ].push_back( parked );
+                ++m_number_of_resize_parked;
+                return true;
+            }
+
+            if ( m_parked_consumables.size() >= MAX_NUMBER_OF_PARKED_CONSUMABLES ) return false;
+
+            m_parked_consumables.push_back( parked );
+            return true;
+        }
+
+        //______________________________________________________
+        // check SAFE POINTs: parked consumables whose previous worker is drained are appended (in order) to
+        // released with the thread key they must go to. Returns false if nothing to release.
+        template< class POOL_CLASS >
+        inline bool releaseParked( POOL_CLASS& pool, std::vector< ParkedConsumable >& released )
+        {
+            if ( m_resizing ) return releaseResizeParked( pool, released );
+
+            if ( !m_handover_in_progress ) return false;
+
+            if ( pool.getThreadConsumed( m_candidate_source ) < m_candidate_source_last_assigned ) return false;
+
+            if ( m_candidate_homing )
+            {
+                // idle moved key back to its Jump Consistent Hash worker
+                m_overrides.erase( m_candidate_key );
+                ++m_number_of_expired_overrides;
+            }
+            else
+            {
+                RoutingOverride routing_override = { m_candidate_destination, m_window_number };
+                m_overrides[m_candidate_key] = routing_override;
+                ++m_number_of_migrations;
+            }
+
+            return endHandover( released, m_candidate_destination );
+        }
+
+        //______________________________________________________
+        // abort the hot key handover: parked consumables go back to the old worker
+        bool abortHandover( std::vector< ParkedConsumable >& released )
+        {
+            if ( !m_handover_in_progress ) return false;
+
+            ++m_number_of_aborted_migrations;
+
+            return endHandover( released, m_candidate_source );
+        }
+
+        //______________________________________________________
+        // work stopping: every parked consumable goes back (in order) to the worker that had its key
+        bool abortParking( std::vector< ParkedConsumable >& released )
+        {
+            abortHandover( released );
+
+            if ( m_resizing )
+            {
+                for ( size_t previous = 0; previous < m_resize_parked.size(); ++previous )
+                {
+                    for ( size_t i = 0; i < m_resize_parked[previous].size(); ++i )
+                    {
+                        m_resize_parked[previous][i].key = previous;
+                        released.push_back( m_resize_parked[previous][i] );
+                    }
+
+                    m_resize_parked[previous].clear();
+                }
+
+                endResize();
+            }
+
+            return !released.empty();
+        }
+
+        //______________________________________________________
+        // change the number of workers: when growing new workers must be already running, when shrinking
+        // removed workers must run until isResizing() is false. The hot key handover must be aborted before.
+        template< class POOL_CLASS >
+        void resize( UInt32 number_of_workers, POOL_CLASS& pool )
+        {
+            assert( !m_resizing && !m_handover_in_progress );
+
+            if ( !number_of_workers || number_of_workers == m_number_of_workers ) return;
+
+            // keys are routed with previous mapping until the SAFE POINT of their previous worker
+            m_previous_number_of_workers = m_number_of_workers;
+            m_previous_overrides = m_overrides;
+
+            // moved keys stay on their worker if it is kept, else they follow the new Jump Consistent Hash
+            for ( std::unordered_map<UInt64, RoutingOverride>::iterator it = m_overrides.begin(); it != m_overrides.end(); )
+            {
+                if ( it->second.thread_key >= number_of_workers
+                    || it->second.thread_key == jumpConsistentHash( mixRoutingKey( it->first ), number_of_workers ) )
+                {
+                    it = m_overrides.erase( it );
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            m_drain_targets.assign( m_previous_number_of_workers, 0 );
+            m_drained.assign( m_previous_number_of_workers, false );
+            m_resize_parked.resize( m_previous_number_of_workers );
+
+            for ( size_t previous = 0; previous < m_previous_number_of_workers; ++previous )
+            {
+                m_drain_targets[previous] = pool.getThreadAssigned( previous );
+            }
+
+            m_number_of_pending_drains = m_previous_number_of_workers;
+            m_number_of_workers        = number_of_workers;
+            m_resizing                 = true;
+
+            // hot keys statistics restart with the new pool
+            m_hot_keys.clear();
+            m_routed_in_window = 0;
+            m_window_start_assigned.assign( m_number_of_workers, 0 );
+
+            for ( size_t i = 0; i < m_number_of_workers; ++i )
+            {
+                m_window_start_assigned[i] = pool.getThreadAssigned( i );
+            }
+        }
+
+        //______________________________________________________
+        // false: getThreadKey( routing_key ) is enough
+        bool   needsPool() const                  { return m_hot_key_rebalancing || m_resizing; }
+        bool   isResizing() const                 { return m_resizing; }
+        UInt32 getNumberOfWorkers() const         { return m_number_of_workers; }
+        size_t getNumberOfParked() const          { return m_parked_consumables.size() + m_number_of_resize_parked; }
+        bool   isHotKeyRebalancingEnabled() const { return m_hot_key_rebalancing; }
+        size_t getNumberOfOverrides() const       { return m_overrides.size(); }
+        UInt64 getNumberOfMigrations() const      { return m_number_of_migrations; }
+        UInt64 getNumberOfAbortedMigrations() const { return m_number_of_aborted_migrations; }
+        UInt64 getNumberOfExpiredOverrides() const  { return m_number_of_expired_overrides; }
+
+    private:
+        // moved key: its worker and the last window it was seen hot in
+        struct RoutingOverride
+        {
+            UInt64 thread_key;
+            UInt64 last_hot_window;
+        };
+
+        struct HotKeyEntry
+        {
+            UInt64 routing_key;
+            UInt64 thread_key;
+            UInt64 counter;
+        };
+
+        //______________________________________________________
+        bool endHandover( std::vector< ParkedConsumable >& released, UInt64 thread_key )
+        {
+            m_handover_in_progress = false;
+            m_candidate_homing     = false;
+
+            for ( size_t i = 0; i < m_parked_consumables.size(); ++i )
+            {
+                m_parked_consumables[i].key = thread_key;
+                released.push_back( m_parked_consumables[i] );
+            }
+
+            m_parked_consumables.clear();
+
+            return !released.empty();
+        }
+
+        //______________________________________________________
+        // mapping in force before the last resize
+        inline UInt64 getPreviousThreadKey( UInt64 routing_key ) const
+        {
+            if ( !m_previous_overrides.empty() )
+            {
+                std::unordered_map<UInt64, RoutingOverride>::const_iterator it = m_previous_overrides.find( routing_key );
+                if ( it != m_previous_overrides.end() ) return it->second.thread_key;
+            }
+
+            return jumpConsistentHash( mixRoutingKey( routing_key ), m_previous_number_of_workers );
+        }
+
+        //______________________________________________________
+        inline UInt64 getResizingThreadKey( UInt64 routing_key ) const
+        {
+            UInt64 thread_key( getThreadKey( routing_key ) );
+            UInt64 previous_thread_key( getPreviousThreadKey( routing_key ) );
+
+            // not moved, or previous worker already at its SAFE POINT
+            if ( previous_thread_key == thread_key || m_drained[previous_thread_key] ) return thread_key;
+
+            return PARKING_THREAD_KEY;
+        }
+
+        //______________________________________________________
+        template< class POOL_CLASS >
+        bool releaseResizeParked( POOL_CLASS& pool, std::vector< ParkedConsumable >& released )
+        {
+            for ( size_t previous = 0; previous < m_previous_number_of_workers; ++previous )
+            {
+                if ( m_drained[previous] || pool.getThreadConsumed( previous ) < m_drain_targets[previous] ) continue;
+
+                m_drained[previous] = true;
+                --m_number_of_pending_drains;
+
+                for ( size_t i = 0; i < m_resize_parked[previous].size(); ++i )
+                {
+                    ParkedConsumable& parked = m_resize_parked[previous][i];
+                    parked.key = getThreadKey( parked.key );
+                    released.push_back( parked );
+                }
+
+                m_number_of_resize_parked -= m_resize_parked[previous].size();
+                m_resize_parked[previous].clear();
+            }
+
+            if ( !m_number_of_pending_drains ) endResize();
+
+            return !released.empty();
+        }
+
+        //______________________________________________________
+        void endResize()
+        {
+            m_resizing = false;
+            m_previous_overrides.clear();
+            m_number_of_resize_parked = 0;
+        }
+
+        //______________________________________________________
+        // Space-Saving heavy hitters: bounded to MAX_NUMBER_OF_TRACKED_HOT_KEYS
+        void trackHotKey( UInt64 routing_key, UInt64 thread_key )
+        {
+            size_t minimum_index = 0;
+
+            for ( size_t i = 0; i < m_hot_keys.size(); ++i )
+            {
+                if ( m_hot_keys[i].routing_key == routing_key )
+                {
+                    ++m_hot_keys[i].counter;
+                    m_hot_keys[i].thread_key = thread_key;
+                    return;
+                }
+
+                if ( m_hot_keys[i].counter < m_hot_keys[minimum_index].counter ) minimum_index = i;
+            }
+
+            if ( m_hot_keys.size() < MAX_NUMBER_OF_TRACKED_HOT_KEYS )
+            {
+                HotKeyEntry entry = { routing_key, thread_key, 1 };
+                m_hot_keys.push_back( entry );
+            }
+            else
+            {
+                // replace the coldest key inheriting its counter (Space-Saving over-estimation)
+                m_hot_keys[minimum_index].routing_key = routing_key;
+                m_hot_keys[minimum_index].thread_key  = thread_key;
+                ++m_hot_keys[minimum_index].counter;
+            }
+        }
+
+        //______________________________________________________
+        template< class POOL_CLASS >
+        void chooseMigrationCandidate( POOL_CLASS& pool )
+        {
+            // per worker load in the window (all traffic, not only keyed one)
+            std::vector<UInt64> window_load( m_number_of_workers, 0 );
+            UInt64 total_load = 0;
+            size_t source = 0, destination = 0;
+
+            for ( size_t i = 0; i < m_number_of_workers; ++i )
+            {
+                UInt64 assigned = pool.getThreadAssigned( i );
+                window_load[i] = assigned - m_window_start_assigned[i];
+                m_window_start_assigned[i] = assigned;
+                total_load += window_load[i];
+
+                if ( window_load[i] > window_load[source] )      source = i;
+                if ( window_load[i] < window_load[destination] ) destination = i;
+            }
+
+            float average_load = float( total_load ) / float( m_number_of_workers );
+
+            // moved keys still hot are not idle
+            ++m_window_number;
+
+            for ( size_t i = 0; i < m_hot_keys.size() && !m_overrides.empty(); ++i )
+            {
+                std::unordered_map<UInt64, RoutingOverride>::iterator it = m_overrides.find( m_hot_keys[i].routing_key );
+                if ( it != m_overrides.end() ) it->second.last_hot_window = m_window_number;
+            }
+
+            if ( !m_handover_in_progress && !m_resizing
+                && m_overrides.size() < MAX_NUMBER_OF_ROUTING_OVERRIDES
+                && source != destination
+                && float( window_load[source] ) > average_load * ( 1.0f + m_rebalancing_imbalance ) )
+            {
+                // hottest key on source whose move does not simply overload destination
+                UInt64 max_movable = ( window_load[source] - window_load[destination] ) / 2;
+                UInt64 best_counter = 0;
+
+                for ( size_t i = 0; i < m_hot_keys.size(); ++i )
+                {
+                    // counters are sampled: scale them back
+                    UInt64 estimated_load = m_hot_keys[i].counter * ( HOT_KEY_SAMPLING_MASK + 1 );
+
+                    if ( m_hot_keys[i].thread_key == source && estimated_load <= max_movable && m_hot_keys[i].counter > best_counter )
+                    {
+                        best_counter    = m_hot_keys[i].counter;
+                        m_candidate_key = m_hot_keys[i].routing_key;
+                    }
+                }
+
+                if ( best_counter > 0 )
+                {
+                    // START HANDOVER: everything assigned to source up to now must be consumed before the move
+                    m_handover_in_progress           = true;
+                    m_candidate_source               = source;
+                    m_candidate_destination          = destination;
+                    m_candidate_source_last_assigned = pool.getThreadAssigned( source );
+                }
+            }
+
+            // no migration started: an idle moved key can go home
+            if ( !m_handover_in_progress && !m_resizing && !m_overrides.empty() ) chooseIdleOverride( pool );
+
+            m_hot_keys.clear();
+            m_routed_in_window = 0;
+        }
+
+        //______________________________________________________
+        // the longest idle override goes back to its Jump Consistent Hash worker if it is idle for
+        // OVERRIDE_IDLE_WINDOWS, or at once if the table is full (migrations go on)
+        template< class POOL_CLASS >
+        void chooseIdleOverride( POOL_CLASS& pool )
+        {
+            std::unordered_map<UInt64, RoutingOverride>::iterator idle = m_overrides.begin();
+
+            for ( std::unordered_map<UInt64, RoutingOverride>::iterator it = m_overrides.begin(); it != m_overrides.end(); ++it )
+            {
+                if ( it->second.last_hot_window < idle->second.last_hot_window ) idle = it;
+            }
+
+            if ( m_overrides.size() < MAX_NUMBER_OF_ROUTING_OVERRIDES
+                && m_window_number - idle->second.last_hot_window < OVERRIDE_IDLE_WINDOWS ) return;
+
+            UInt64 home = jumpConsistentHash( mixRoutingKey( idle->first ), m_number_of_workers );
+
+            if ( home == idle->second.thread_key )
+            {
+                m_overrides.erase( idle );
+                ++m_number_of_expired_overrides;
+                return;
+            }
+
+            // START HANDOVER back home
+            m_handover_in_progress           = true;
+            m_candidate_homing               = true;
+            m_candidate_key                  = idle->first;
+            m_candidate_source               = idle->second.thread_key;
+            m_candidate_destination          = home;
+            m_candidate_source_last_assigned = pool.getThreadAssigned( m_candidate_source );
+        }
+
+        UInt32                              m_number_of_workers;
+        bool                                m_hot_key_rebalancing;
+        UInt64                              m_rebalancing_window;
+        float                               m_rebalancing_imbalance;
+
+        // window and sampling
+        UInt64                              m_routed_in_window;
+        UInt64                              m_sampling_state;
+        std::vector<HotKeyEntry>            m_hot_keys;
+
+        // key under handover
+        bool                                m_handover_in_progress;
+        UInt64                              m_candidate_key;
+        UInt64                              m_candidate_source;
+        UInt64                              m_candidate_destination;
+        UInt64                              m_candidate_source_last_assigned;
+        std::vector< ParkedConsumable >     m_parked_consumables;
+        UInt64                              m_number_of_migrations;
+        UInt64                              m_number_of_aborted_migrations;
+        bool                                m_candidate_homing;             // idle moved key going home
+
+        // moved keys (bounded)
+        std::unordered_map<UInt64, RoutingOverride> m_overrides;
+        UInt64                              m_window_number;
+        UInt64                              m_number_of_expired_overrides;
+
+        // assigned per worker at window start
+        std::vector<UInt64>                 m_window_start_assigned;
+
+        // resize transition (indexed by previous thread key)
+        bool                                m_resizing;
+        UInt32                              m_previous_number_of_workers;
+        std::unordered_map<UInt64, RoutingOverride> m_previous_overrides;
+        std::vector<UInt64>                 m_drain_targets;
+        std::vector<bool>                   m_drained;
+        std::vector< std::vector< ParkedConsumable > > m_resize_parked;
+        size_t                              m_number_of_resize_parked;
+        size_t                              m_number_of_pending_drains;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+}
+
+// --------------------------------------------------------------------------------------------------------
+#endif // QAPPNG_WORK_ROUTING_H
@@ -0,0 +1,245 @@
+/** ===================================================================================================================
+* @file    WorkTelemetry HEADER FILE
+*
+* @brief   WorkManager telemetry: sampled queue wait and service time distributions, queue fill percentiles
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-034   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+#ifndef QAPPNG_WORK_TELEMETRY_H
+#define QAPPNG_WORK_TELEMETRY_H
+
+// Include STL
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+// other Includes
+#include "core.h"
+
+// --------------------------------------------------------------------------------------------------------
+
+namespace QAppNG
+{
+    // --------------------------------------------------------------------------------------------------------
+    //                                           *** LatencyHistogram ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief log2 histogram of durations in usec: bucket 0 is < 1 usec, bucket i is [2^(i-1), 2^i) usec,
+    *         the last bucket takes everything above. Percentiles are given as the upper bound of their bucket.
+    *
+    *         It has a single writer (the worker owning it), readers (status, exports) get a consistent enough
+    *         snapshot since counters only grow.
+    */
+    class LatencyHistogram
+    {
+    public:
+        static const size_t NUMBER_OF_BUCKETS = 28;
+
+        LatencyHistogram() : m_count(0), m_sum_usec(0)
+        {
+            for ( size_t i = 0; i < NUMBER_OF_BUCKETS; ++i ) m_buckets[i] = 0;
+        }
+
+        inline void add( UInt64 usec )
+        {
+            size_t bucket = 0;
+            while ( bucket < NUMBER_OF_BUCKETS - 1 && ( usec >> bucket ) ) ++bucket;
+
+            ++m_buckets[bucket];
+            m_sum_usec += usec;
+            ++m_count;
+        }
+
+        void merge( const LatencyHistogram& other )
+        {
+            for ( size_t i = 0; i < NUMBER_OF_BUCKETS; ++i ) m_buckets[i] += other.m_buckets[i];
+            m_sum_usec += other.m_sum_usec;
+            m_count    += other.m_count;
+        }
+
+        UInt64 getCount() const                     { return m_count; }
+        UInt64 getSumUsec() const                   { return m_sum_usec; }
+        UInt64 getBucketCount( size_t bucket ) const { return m_buckets[bucket]; }
+
+        // "le" bound of the bucket (the last one has no bound)
+        static UInt64 getBucketUpperBoundUsec( size_t bucket ) { return UInt64(1) << bucket; }
+
+        // percentile in [0, 1], 0 if the histogram is empty
+        UInt64 getPercentileUsec( double percentile ) const
+        {
+            UInt64 count( m_count );
+            if ( !count ) return 0;
+
+            UInt64 rank = UInt64( percentile * count + 0.5 );
+            if ( rank < 1 )     rank = 1;
+            if ( rank > count ) rank = count;
+
+            UInt64 cumulated = 0;
+            for ( size_t i = 0; i < NUMBER_OF_BUCKETS; ++i )
+            {
+                cumulated += m_buckets[i];
+                if ( cumulated >= rank ) return getBucketUpperBoundUsec( i );
+            }
+
+            return getBucketUpperBoundUsec( NUMBER_OF_BUCKETS - 1 );
+        }
+
+    private:
+        UInt64 m_buckets[NUMBER_OF_BUCKETS];
+        UInt64 m_count;
+        UInt64 m_sum_usec;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+    //                                          *** QueueFillHistogram ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief distribution of queue fill samples, one bucket per percent (single writer)
+    */
+    class QueueFillHistogram
+    {
+    public:
+        static const size_t NUMBER_OF_BUCKETS = 101;
+
+        QueueFillHistogram() : m_count(0)
+        {
+            for ( size_t i = 0; i < NUMBER_OF_BUCKETS; ++i ) m_buckets[i] = 0;
+        }
+
+        inline void add( UInt64 used, UInt64 size )
+        {
+            size_t percent = size ? size_t( used * 100 / size ) : 0;
+            if ( percent >= NUMBER_OF_BUCKETS ) percent = NUMBER_OF_BUCKETS - 1;
+
+            ++m_buckets[percent];
+            ++m_count;
+        }
+
+        UInt64 getCount() const { return m_count; }
+
+        // percentile in [0, 1] of the fill percentage, 0 if no sample
+        UInt32 getPercentile( double percentile ) const
+        {
+            UInt64 count( m_count );
+            if ( !count ) return 0;
+
+            UInt64 rank = UInt64( percentile * count + 0.5 );
+            if ( rank < 1 )     rank = 1;
+            if ( rank > count ) rank = count;
+
+            UInt64 cumulated = 0;
+            for ( size_t i = 0; i < NUMBER_OF_BUCKETS; ++i )
+            {
+                cumulated += m_buckets[i];
+                if ( cumulated >= rank ) return UInt32( i );
+            }
+
+            return UInt32( NUMBER_OF_BUCKETS - 1 );
+        }
+
+    private:
+        UInt64 m_buckets[NUMBER_OF_BUCKETS];
+        UInt64 m_count;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+    //                                            *** WorkTelemetry ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief telemetry of a WORK, written by its TrivialThreadPool and read by WorkManager exports.
+    *
+    *         Queue wait is the time from addConsumable to the moment the worker picks the batch holding the
+    *         consumable, service time is the batch processing time divided by the batch size. Both are measured
+    *         on one consumable out of telemetry_sample_rate (no timestamp is stored in the consumables).
+    *         Queue fill is sampled for all running workers by worker 0 each time it updates the pool statistics.
+    */
+    class WorkTelemetry
+    {
+    public:
+        struct WorkerTelemetry
+        {
+            LatencyHistogram    queue_wait;
+            LatencyHistogram    service_time;
+
+            // each slot is written by a different worker
+            UInt8               padding[64];
+        };
+
+        explicit WorkTelemetry( size_t max_number_of_workers = 0 ) : per_worker( max_number_of_workers ) {}
+
+        std::vector<WorkerTelemetry>    per_worker;
+        QueueFillHistogram              queue_fill;
+    };
+
+    // --------------------------------------------------------------------------------------------------------
+    //                                         *** TelemetrySampleRing ***
+    // --------------------------------------------------------------------------------------------------------
+
+    /**
+    *  @brief consumables sampled by the producer of a worker queue and not consumed yet (one producer, one worker).
+    *         A sample is the position of the consumable in the worker queue (its thread_num_assigned) and its
+    *         enqueue time; when the ring is full the producer just skips the sample.
+    */
+    class TelemetrySampleRing
+    {
+    public:
+        static const size_t SIZE = 32;
+
+        struct Sample
+        {
+            UInt64                                  position;
+            std::chrono::steady_clock::time_point   enqueue_time;
+        };
+
+        TelemetrySampleRing() : m_write_index(0), m_read_index(0) {}
+
+        // PRODUCER
+        inline bool push( UInt64 position, const std::chrono::steady_clock::time_point& enqueue_time )
+        {
+            UInt64 write_index( m_write_index );
+            if ( write_index - m_read_index >= SIZE ) return false;
+
+            m_samples[ write_index % SIZE ].position     = position;
+            m_samples[ write_index % SIZE ].enqueue_time = enqueue_time;
+
+            std::atomic_thread_fence( std::memory_order_release );
+            m_write_index = write_index + 1;
+
+            return true;
+        }
+
+        // WORKER: oldest sample, NULL if none
+        inline const Sample* front()
+        {
+            if ( m_read_index == m_write_index ) return NULL;
+
+            std::atomic_thread_fence( std::memory_order_acquire );
+            return &m_samples[ m_read_index % SIZE ];
+        }
+
+        inline void pop()
+        {
+            std::atomic_thread_fence( std::memory_order_release );
+            m_read_index = m_read_index + 1;
+        }
+
+    private:
+        Sample              m_samples[SIZE];
+        volatile UInt64     m_write_index;
+        UInt8               m_padding[64];
+        volatile UInt64     m_read_index;
+    };
+}
+
+// --------------------------------------------------------------------------------------------------------
+#endif
@@ -18,12 +18,27 @@
 *                                                                                             , time storage, new methods etc )
 * #5848       R. Buti                                                          Mar 2011      Added masetrSize and slaveSize methods
 * #5975       A. Della Villa                                                   Apr-2011      added SET/DEL/UPD delegates
+* #user-043   QAppNG Team                                                      Oct-2026      incremental SYNCH from per SharedMap change logs
+* #user-044   QAppNG Team                                                      Oct-2026      lock-free reads of master map from published snapshots
+* #user-045   QAppNG Team                                                      Oct-2026      binary memory mapped dump/load (dumpToBinaryFile/loadFromBinaryFile)
+* #user-046   QAppNG Team                                                      Oct-2026      incremental PURGE from an expiry queue, in batches
+* #user-047   QAppNG Team                                                      Oct-2026      optional negative lookup filter (setNegativeLookupFilter)
+* #user-049   QAppNG Team                                                      Oct-2026      traversals on pinned snapshots, parallelIterateAndRunFunctionOnElements
+* #user-044   QAppNG Team                                                      Oct-2026      master map snapshot publish interval (setSnapshotPublishInterval)
+* #user-044   QAppNG Team                                                      Oct-2026      master map snapshot built out of MasterMap lock (changed shards only)
+* #user-043   QAppNG Team                                                      Oct-2026      change logs with one record per key, SYNCH when full (setChangeLogMaxSize)
 *
 * @endhistory
 * ===================================================================================================================
 */
 
 #include <QAppNG/ThreadCounter.h>
+#include <QAppNG/SharedMapChangeLog.h>
+#include <QAppNG/MasterMapSnapshot.h>
+#include <QAppNG/SharedMapBinaryDump.h>
+#include <QAppNG/SharedMapExpiryQueue.h>
+#include <thread>
+#include <atomic>
 
 namespace QAppNG
 {
@@ -35,6 +50,7 @@ namespace QAppNG
     template<class KEY_CLASS, class VALUE_CLASS>
     SharedMap<KEY_CLASS, VALUE_CLASS>::SharedMap( std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map_back_ptr, fastdelegate::FastDelegate0<UInt64> virtual_timer_function )
         : m_master_map_back_ptr(master_map_back_ptr)
+        , m_master_map_snapshot(master_map_back_ptr->m_master_map_snapshot)
         , m_virtual_timer_function(virtual_timer_function)
     {
     }
@@ -44,26 +60,33 @@ namespace QAppNG
     template<class KEY_CLASS, class VALUE_CLASS>
     bool SharedMap<KEY_CLASS, VALUE_CLASS>::get( const KEY_CLASS& key, VALUE_CLASS& value )
     {
-        // acquire back pointer to master
-        std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
+        {
+            // get a shared READ LOCK to SharedMap mutex
+            boost::shared_lock<boost::shared_mutex> shared_map_read_lock( m_shared_map_mutex );
 
-        // get a shared READ LOCK to SharedMap mutex
-        boost::shared_lock<boost::shared_mutex> shared_map_read_lock( m_shared_map_mutex );
+            typename MapType::const_iterator element = m_data_map.find(key);
+            if ( element != m_data_map.end() )
+            {
+                value = element->second.second;
+                return true;
+            }
 
-        if ( m_data_map.count(key) )
-        {
-            value = m_data_map[key].second;
-            return true;
+            // changes taken by a SYNCH in progress (not yet in the published master map)
+            element = m_synching_data_map.find(key);
+            if ( element != m_synching_data_map.end() )
+            {
+                value = element->second.second;
+                return true;
+            }
         }
 
-        shared_map_read_lock.unlock();
-    
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock( master_map->m_master_map_mutex );
-    
-        if ( master_map.get() && master_map->m_data_map.count(key) )
+        // last published MasterMap snapshot (no lock on MasterMap mutex, unknown keys mostly stop at its filter)
+        typename MasterMapSnapshot<MapType>::ReadGuard master_map_snapshot( *m_master_map_snapshot );
+
+        const std::pair<UInt64, VALUE_CLASS>* master_map_entry = master_map_snapshot.find(key);
+        if ( master_map_entry )
         {
-            value = master_map->m_data_map[key].second;
+            value = master_map_entry->second;
             return true;
         }
 
@@ -75,28 +98,36 @@ namespace QAppNG
     template<class KEY_CLASS, class VALUE_CLASS>
     bool SharedMap<KEY_CLASS, VALUE_CLASS>::getTime( const KEY_CLASS& key, UInt64& value )
     {
-        // acquire back pointer to master
-        std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
+        {
+            // get a shared READ LOCK to SharedMap mutex
+            boost::shared_lock<boost::shared_mutex> shared_map_read_lock( m_shared_map_mutex );
 
-        // get a shared READ LOCK to SharedMap mutex
-        boost::shared_lock<boost::shared_mutex> shared_map_read_lock( m_shared_map_mutex );
+            typename MapType::const_iterator element = m_data_map.find(key);
+            if ( element != m_data_map.end() )
+            {
+                // we return the TIME of the entry
+                value = element->second.first;
+                return true;
+            }
 
-        if ( m_data_map.count(key) )
-        {
-            // we return the TIME of the entry
-            value = m_data_map[key].first;
-            return true;
+            // changes taken by a SYNCH in progress (not yet in the published master map)
+            element = m_synching_data_map.find(key);
+            if ( element != m_synching_data_map.end() )
+            {
+                // we return the TIME of the entry
+                value = element->second.first;
+                return true;
+            }
         }
-    
-        shared_map_read_lock.unlock();
 
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock( master_map->m_master_map_mutex );
-    
-        if ( master_map.get() && master_map->m_data_map.count(key) )
+        // last published MasterMap snapshot (no lock on MasterMap mutex, unknown keys mostly stop at its filter)
+        typename MasterMapSnapshot<MapType>::ReadGuard master_map_snapshot( *m_master_map_snapshot );
+
+        const std::pair<UInt64, VALUE_CLASS>* master_map_entry = master_map_snapshot.find(key);
+        if ( master_map_entry )
         {
             // we return the TIME of the entry
-            value = master_map->m_data_map[key].first;
+            value = master_map_entry->first;
             return true;
         }
 
@@ -108,32 +139,14 @@ namespace QAppNG
     template<class KEY_CLASS, class VALUE_CLASS>
     bool SharedMap<KEY_CLASS, VALUE_CLASS>::getAge( const KEY_CLASS& key, UInt64& value )
     {
-        // acquire back pointer to master
-        std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
-
-        // get a shared READ LOCK to SharedMap mutex
-        boost::shared_lock<boost::shared_mutex> shared_map_read_lock( m_shared_map_mutex );
-
-        if ( m_data_map.count(key) && m_virtual_timer_function )
-        {
-            // we calculate the AGE of the entry
-            value = m_virtual_timer_function() - m_data_map[key].first;
-            return true;
-        }
-
-        shared_map_read_lock.unlock();
+        if ( !m_virtual_timer_function ) return false;
 
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock( master_map->m_master_map_mutex );
+        UInt64 entry_time;
+        if ( !getTime( key, entry_time ) ) return false;
 
-        if ( master_map.get() && master_map->m_data_map.count(key) && m_virtual_timer_function )
-        {
-            // we calculate the AGE of the entry
-            value = m_virtual_timer_function() - master_map->m_data_map[key].first;
-            return true;
-        }
-
-        return false;
+        // we calculate the AGE of the entry
+        value = m_virtual_timer_function() - entry_time;
+        return true;
     }
 
     // --------------------------------------------------------------------------------------------------
@@ -163,6 +176,11 @@ namespace QAppNG
         // disable delete status if it was set in the delete map
         if ( m_deleted_data_map.count(key) ) m_deleted_data_map[key] = false;
 
+        // change to be applied to master map at next SYNCH
+        m_change_log.appendSet( key, value, value_with_time.first );
+
+        synchFullChangeLog( shared_map_write_lock );
+
         return rv.second;
     }
 
@@ -192,6 +210,11 @@ namespace QAppNG
         // disable delete status if it was set in the delete map
         if ( m_deleted_data_map.count(key) ) m_deleted_data_map[key] = false;
 
+        // change to be applied to master map at next SYNCH
+        m_change_log.appendSet( key, value, entry_time );
+
+        synchFullChangeLog( shared_map_write_lock );
+
         return rv.second;
     }
 
@@ -213,50 +236,80 @@ namespace QAppNG
             m_deleted_data_map.insert( std::make_pair(key, true) );
         }
 
-        // local delete
+        // local delete (also of the changes synched but not yet published)
         if ( m_data_map.count(key) )
         {
             m_data_map.erase(key);
         }
+        m_synching_data_map.erase(key);
+
+        // change to be applied to master map at next SYNCH
+        m_change_log.appendDel( key );
+
+        synchFullChangeLog( shared_map_write_lock );
 
         return true;
     }
 
     // --------------------------------------------------------------------------------------------------
 
+    // the change log is full (set and del only): SYNCH now, out of the SharedMap lock (SYNCH takes it after the MasterMap one)
     template<class KEY_CLASS, class VALUE_CLASS>
-    bool SharedMap<KEY_CLASS, VALUE_CLASS>::touch( const KEY_CLASS& key )
+    void SharedMap<KEY_CLASS, VALUE_CLASS>::synchFullChangeLog( boost::unique_lock<boost::shared_mutex>& shared_map_write_lock )
     {
-        if ( !m_virtual_timer_function ) return false;
+        if ( !m_change_log.full() ) return;
+
+        shared_map_write_lock.unlock();
 
         // acquire back pointer to master
         std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
 
-        // get a shared READ LOCK to SharedMap mutex
-        boost::shared_lock<boost::shared_mutex> shared_map_read_lock( m_shared_map_mutex );
+        if ( master_map ) master_map->synchMapset();
+    }
 
-        // search entry in SharedMap
-        if ( m_data_map.count(key) )
+    // --------------------------------------------------------------------------------------------------
+
+    template<class KEY_CLASS, class VALUE_CLASS>
+    bool SharedMap<KEY_CLASS, VALUE_CLASS>::touch( const KEY_CLASS& key )
+    {
+        if ( !m_virtual_timer_function ) return false;
+
+        UInt64 now_time = m_virtual_timer_function();
+
+        // get a unique WRITE LOCK to SharedMap mutex
+        boost::unique_lock<boost::shared_mutex> shared_map_write_lock( m_shared_map_mutex );
+
+        // search entry in SharedMap (also in the changes taken by a SYNCH in progress)
+        typename MapType::iterator element = m_data_map.find(key);
+        if ( element != m_data_map.end() )
         {
-            // we COUNT on the fact that the following operation is atomic so READ LOCK it is enough
-            m_data_map[key]->first = m_virtual_timer_function();
+            element->second.first = now_time;
+            m_change_log.appendTouch( key, now_time );
             return true;
         }
 
-        shared_map_read_lock.unlock();
-
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock( master_map->m_master_map_mutex );
+        // a deleted entry is not touched
+        if ( m_deleted_data_map.count(key) && m_deleted_data_map[key] ) return false;
 
-        // search entry in MasterMap
-        if ( master_map.get() && master_map->m_data_map.count(key) )
+        element = m_synching_data_map.find(key);
+        if ( element != m_synching_data_map.end() )
         {
-            // we COUNT on the fact that the following operation is atomic so READ LOCK it is enough
-            master_map->m_data_map[key]->first = m_virtual_timer_function();
+            element->second.first = now_time;
+            m_change_log.appendTouch( key, now_time );
             return true;
         }
 
-        return false;
+        if ( m_synching_deleted_data_map.count(key) && m_synching_deleted_data_map[key] ) return false;
+
+        // search entry in the last published MasterMap snapshot (no lock on MasterMap mutex)
+        typename MasterMapSnapshot<MapType>::ReadGuard master_map_snapshot( *m_master_map_snapshot );
+
+        if ( !master_map_snapshot.find(key) ) return false;
+
+        // the new time is applied to master map at next SYNCH
+        m_change_log.appendTouch( key, now_time );
+
+        return true;
     }
 
     // --------------------------------------------------------------------------------------------------
@@ -264,38 +317,35 @@ namespace QAppNG
     template<class KEY_CLASS, class VALUE_CLASS>
     size_t SharedMap<KEY_CLASS, VALUE_CLASS>::count( const KEY_CLASS& key )
     {
-        // acquire back pointer to master
-        std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
-
-        // get a shared READ LOCK to SharedMap mutex
-        boost::shared_lock<boost::shared_mutex> shared_map_read_lock( m_shared_map_mutex );
-
-
-        if ( m_deleted_data_map.count(key) )
-        {
-            // Case A: entry has been logically deleted
-            return 0;
-        }
-    
-        if ( m_data_map.count(key) )
         {
-            // Case B: we found it in SharedMap
-            return m_data_map.count(key);
-        }
+            // get a shared READ LOCK to SharedMap mutex
+            boost::shared_lock<boost::shared_mutex> shared_map_read_lock( m_shared_map_mutex );
 
-        shared_map_read_lock.unlock();
+            if ( m_data_map.count(key) )
+            {
+                // Case A: we found it in SharedMap
+                return 1;
+            }
 
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock( master_map->m_master_map_mutex );
+            typename std::unordered_map<KEY_CLASS, bool>::const_iterator deleted = m_deleted_data_map.find(key);
+            if ( deleted != m_deleted_data_map.end() && deleted->second )
+            {
+                // Case B: entry has been logically deleted
+                return 0;
+            }
 
-        if ( master_map.get() && master_map->m_data_map.count(key) )
-        {
-            // Case C: we found it in MasterMap
-            return master_map->m_data_map.count(key);
+            // same cases on the changes taken by a SYNCH in progress (not yet in the published master map)
+            if ( m_synching_data_map.count(key) ) return 1;
+
+            deleted = m_synching_deleted_data_map.find(key);
+            if ( deleted != m_synching_deleted_data_map.end() && deleted->second ) return 0;
         }
-    
+
+        // Case C: we found it in the last published MasterMap snapshot (no lock on MasterMap mutex)
         // Case D: we didn't find it
-        return 0;
+        typename MasterMapSnapshot<MapType>::ReadGuard master_map_snapshot( *m_master_map_snapshot );
+
+        return master_map_snapshot.find(key) ? 1 : 0;
     }
 
     // --------------------------------------------------------------------------------------------------
@@ -313,20 +363,74 @@ namespace QAppNG
 
     template<class KEY_CLASS, class VALUE_CLASS>
     size_t SharedMap<KEY_CLASS, VALUE_CLASS>::masterSize()
+    {
+        // size of the last published MasterMap snapshot
+        typename MasterMapSnapshot<MapType>::ReadGuard master_map_snapshot( *m_master_map_snapshot );
+
+        return master_map_snapshot.size();
+    }
+
+    // --------------------------------------------------------------------------------------------------
+
+    template<class KEY_CLASS, class VALUE_CLASS>
+    void SharedMap<KEY_CLASS, VALUE_CLASS>::setNegativeLookupFilter( UInt32 bits_per_key )
     {
         // acquire back pointer to master
         std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
 
-        return master_map->m_data_map.size();
+        if (!master_map)
+        {
+            return;
+        }
+
+        // get a unique WRITE LOCK to MasterMap mutex
+        boost::unique_lock<boost::shared_mutex> master_map_write_lock( master_map->m_master_map_mutex );
 
+        // ATTENTION: it is for the whole MapSet (filter of MasterMap snapshots, 0 disables it),
+        // the snapshot is published again to get the filter now (all its shards are copied)
+        m_master_map_snapshot->setFilterBitsPerKey( bits_per_key );
+        master_map->publishSnapshot( master_map_write_lock );
     }
+
     // --------------------------------------------------------------------------------------------------
 
     template<class KEY_CLASS, class VALUE_CLASS>
-    void SharedMap<KEY_CLASS, VALUE_CLASS>::getKeys( std::vector<KEY_CLASS>& key_vector )
+    void SharedMap<KEY_CLASS, VALUE_CLASS>::setSnapshotPublishInterval( UInt32 publish_interval_msec )
+    {
+        // acquire back pointer to master
+        std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
+
+        if (!master_map)
+        {
+            return;
+        }
+
+        // get a unique WRITE LOCK to MasterMap mutex
+        boost::unique_lock<boost::shared_mutex> master_map_write_lock( master_map->m_master_map_mutex );
+
+        // ATTENTION: it is for the whole MapSet. Each publication copies the snapshot shards of the changed keys:
+        // SYNCH publishes at most once per interval, meanwhile the synched changes are seen only by the SharedMap
+        // that did them (traversals, dumps and PURGE always publish)
+        m_master_map_snapshot->setPublishIntervalMsec( publish_interval_msec );
+    }
+
+    // --------------------------------------------------------------------------------------------------
+
+    template<class KEY_CLASS, class VALUE_CLASS>
+    void SharedMap<KEY_CLASS, VALUE_CLASS>::setChangeLogMaxSize( size_t max_number_of_keys )
     {
+        // get a unique WRITE LOCK to SharedMap mutex
+        boost::unique_lock<boost::shared_mutex> shared_map_write_lock( m_shared_map_mutex );
 
+        // ATTENTION: it is for this SharedMap only (0: the change log is never full, SYNCH only from SharedMapManager)
+        m_change_log.setMaxNumberOfRecords( max_number_of_keys );
+    }
+
+    // --------------------------------------------------------------------------------------------------
 
+    template<class KEY_CLASS, class VALUE_CLASS>
+    void SharedMap<KEY_CLASS, VALUE_CLASS>::getKeys( std::vector<KEY_CLASS>& key_vector )
+    {
         // acquire back pointer to master
         std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
 
@@ -336,18 +440,24 @@ namespace QAppNG
         }
 
         // ATTENTION: since the keys are collected only from MASTER MAP before to get them we do SYNCH
-        master_map->synchMapset();
+        master_map->synchMapset( true );
 
         // clear output vector
         key_vector.clear();
 
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock( master_map->m_master_map_mutex );
+        // we collect the keys from a pinned MasterMap snapshot (no lock on MasterMap mutex)
+        typename MasterMapSnapshot<MapType>::VersionPtr master_map_version( m_master_map_snapshot->pin() );
 
-        // we try to collect the keys from MasterMap
-        for (typename MapType::iterator it = master_map->m_data_map.begin(); it != master_map->m_data_map.end(); ++it)
+        key_vector.reserve( master_map_version->number_of_elements );
+
+        for ( size_t shard = 0; shard < master_map_version->shards.size(); ++shard )
         {
-            key_vector.push_back( it->first );
+            const MapType& data_map = master_map_version->shards[shard]->data_map;
+
+            for (typename MapType::const_iterator it = data_map.begin(); it != data_map.end(); ++it)
+            {
+                key_vector.push_back( it->first );
+            }
         }
     }
 
@@ -359,36 +469,110 @@ namespace QAppNG
         // acquire back pointer to master
         std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
 
+        if (!master_map)
+        {
+            return;
+        }
+
+        // ATTENTION: a SYCH is executed before iteration
+        master_map->synchMapset( true );
+
+        // iterate a pinned MasterMap snapshot: SYNCH and PURGE go on while the function runs
+        typename MasterMapSnapshot<MapType>::VersionPtr master_map_version( m_master_map_snapshot->pin() );
+
+        for ( size_t shard = 0; shard < master_map_version->shards.size(); ++shard )
+        {
+            const MapType& data_map = master_map_version->shards[shard]->data_map;
+
+            for ( typename MapType::const_iterator element = data_map.begin(); element != data_map.end(); ++element )
+            {
+                function_to_execute_on_element_key( element->first );
+            }
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------
+
+    template<class KEY_CLASS, class VALUE_CLASS>
+    void SharedMap<KEY_CLASS, VALUE_CLASS>::iterateAndRunFunctionOnValues( fastdelegate::FastDelegate1< const VALUE_CLASS&, void> function_to_execute_on_element_value )
+    {
+        // acquire back pointer to master
+        std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
+
+        if (!master_map)
+        {
+            return;
+        }
+
         // ATTENTION: a SYCH is executed before iteration
-        master_map->synchMapset();
+        master_map->synchMapset( true );
 
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock( master_map->m_master_map_mutex );
+        // iterate a pinned MasterMap snapshot: SYNCH and PURGE go on while the function runs
+        typename MasterMapSnapshot<MapType>::VersionPtr master_map_version( m_master_map_snapshot->pin() );
 
-        for ( typename MapType::iterator element = master_map->m_data_map.begin(); element != master_map->m_data_map.end(); ++element )
+        for ( size_t shard = 0; shard < master_map_version->shards.size(); ++shard )
         {
-            function_to_execute_on_element_key( element->first );
+            const MapType& data_map = master_map_version->shards[shard]->data_map;
+
+            for ( typename MapType::const_iterator element = data_map.begin(); element != data_map.end(); ++element )
+            {
+                // the published copy is shared and immutable: values are read only (use set to change them)
+                function_to_execute_on_element_value( element->second.second );
+            }
         }
     }
 
     // --------------------------------------------------------------------------------------------------
 
     template<class KEY_CLASS, class VALUE_CLASS>
-    void SharedMap<KEY_CLASS, VALUE_CLASS>::iterateAndRunFunctionOnValues( fastdelegate::FastDelegate1< VALUE_CLASS&, void> function_to_execute_on_element_value )
+    void SharedMap<KEY_CLASS, VALUE_CLASS>::parallelIterateAndRunFunctionOnElements( fastdelegate::FastDelegate2< const KEY_CLASS&, const VALUE_CLASS&, void> function_to_execute_on_element, size_t number_of_threads )
     {
+        // elements visited by each thread at least
+        const size_t MIN_ELEMENTS_PER_THREAD = 4096;
+
         // acquire back pointer to master
         std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
 
+        if (!master_map)
+        {
+            return;
+        }
+
         // ATTENTION: a SYCH is executed before iteration
-        master_map->synchMapset();
+        master_map->synchMapset( true );
 
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock( master_map->m_master_map_mutex );
+        // iterate a pinned MasterMap snapshot: SYNCH and PURGE go on while the function runs
+        typename MasterMapSnapshot<MapType>::VersionPtr master_map_version( m_master_map_snapshot->pin() );
+        const typename MasterMapSnapshot<MapType>::Version& version = *master_map_version;
 
-        for ( typename MapType::iterator element = master_map->m_data_map.begin(); element != master_map->m_data_map.end(); ++element )
+        if ( !number_of_threads ) number_of_threads = std::thread::hardware_concurrency();
+        if ( number_of_threads > version.number_of_elements / MIN_ELEMENTS_PER_THREAD ) number_of_threads = version.number_of_elements / MIN_ELEMENTS_PER_THREAD;
+        if ( !number_of_threads ) number_of_threads = 1;
+
+        // snapshot shards split among threads (ATTENTION: the function is called by all of them at the same time)
+        size_t number_of_shards = version.shards.size();
+        std::vector<std::thread> threads;
+
+        for ( size_t i = 0; i < number_of_threads; ++i )
         {
-            function_to_execute_on_element_value( element->second.second );
+            size_t begin = number_of_shards * i / number_of_threads;
+            size_t end   = number_of_shards * ( i + 1 ) / number_of_threads;
+
+            threads.push_back( std::thread( [&version, function_to_execute_on_element, begin, end]()
+            {
+                for ( size_t shard = begin; shard < end; ++shard )
+                {
+                    const MapType& data_map = version.shards[shard]->data_map;
+
+                    for ( typename MapType::const_iterator element = data_map.begin(); element != data_map.end(); ++element )
+                    {
+                        function_to_execute_on_element( element->first, element->second.second );
+                    }
+                }
+            } ) );
         }
+
+        for ( size_t i = 0; i < threads.size(); ++i ) threads[i].join();
     }
 
     // --------------------------------------------------------------------------------------------------
@@ -399,11 +583,16 @@ namespace QAppNG
         // acquire back pointer to master
         std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map(m_master_map_back_ptr.lock());
 
+        if (!master_map)
+        {
+            return;
+        }
+
         // ATTENTION: a SYCH is executed before iteration
-        master_map->synchMapset();
+        master_map->synchMapset( true );
 
-        // get a shared READ LOCK to MasterMap mutex
-        boost::shared_lock<boost::shared_mutex> master_map_read_lock(master_map->m_master_map_mutex);
+        // dump a pinned MasterMap snapshot (no lock on MasterMap mutex while writing the file)
+        typename MasterMapSnapshot<MapType>::VersionPtr master_map_version(m_master_map_snapshot->pin());
 
         //Open file              
         std::ofstream  file_stream;
@@ -412,11 +601,19 @@ namespace QAppNG
         if (file_stream.is_open())
         {
             //loop over map and dump each element to file
-            for (typename MapType::iterator element = master_map->m_data_map.begin(); element != master_map->m_data_map.end(); ++element)
+            bool dump_ok = true;
+
+            for ( size_t shard = 0; dump_ok && shard < master_map_version->shards.size(); ++shard )
             {
-                if (dumpKeyValue<KEY_CLASS, VALUE_CLASS>(element->first, element->second.second, file_stream) == false)
+                const MapType& data_map = master_map_version->shards[shard]->data_map;
+
+                for (typename MapType::const_iterator element = data_map.begin(); element != data_map.end(); ++element)
                 {
-                    break;
+                    if (dumpKeyValue<KEY_CLASS, VALUE_CLASS>(element->first, element->second.second, file_stream) == false)
+                    {
+                        dump_ok = false;
+                        break;
+                    }
                 }
             }
         }
@@ -451,13 +648,228 @@ namespace QAppNG
             }
 
             // ATTENTION: a SYCH is executed after iteration
-            master_map->synchMapset();
+            master_map->synchMapset( true );
         }
 
         //Close file
         file_stream.close();
     }
 
+    // --------------------------------------------------------------------------------------------------
+
+    template<class KEY_CLASS, class VALUE_CLASS>
+    bool SharedMap<KEY_CLASS, VALUE_CLASS>::dumpToBinaryFile( const std::string& map_dump_filename )
+    {
+        // acquire back pointer to master
+        std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
+
+        if (!master_map)
+        {
+            return false;
+        }
+
+        // ATTENTION: a SYCH is executed before dump
+        master_map->synchMapset( true );
+
+        // dump a pinned MasterMap snapshot (no lock on MasterMap mutex, SYNCH and PURGE go on)
+        typename MasterMapSnapshot<MapType>::VersionPtr master_map_version( m_master_map_snapshot->pin() );
+
+        MultiKeyMap::SnapshotWriter writer;
+        if ( !writer.open( map_dump_filename ) || !writer.append( sizeof(SharedMapDumpHeader) ) ) return false;
+
+        std::vector<UInt64> offsets;
+        offsets.reserve( master_map_version->number_of_elements );
+
+        std::vector<UInt8> buffer;
+
+        for ( size_t shard = 0; shard < master_map_version->shards.size(); ++shard )
+        {
+            const MapType& data_map = master_map_version->shards[shard]->data_map;
+
+            for ( typename MapType::const_iterator element = data_map.begin(); element != data_map.end(); ++element )
+            {
+                // encoded key followed by encoded value
+                buffer.clear();
+                if ( !encodeDumpField( element->first, buffer ) ) continue;
+
+                size_t key_length = buffer.size();
+                if ( !encodeDumpField( element->second.second, buffer ) ) continue;
+
+                size_t record_length = ( sizeof(SharedMapDumpRecord) + buffer.size() + 7 ) & ~size_t(7);
+
+                offsets.push_back( writer.getLength() );
+
+                UInt8* data = writer.append( record_length );
+                if ( !data ) return false;
+
+                SharedMapDumpRecord* record = reinterpret_cast<SharedMapDumpRecord*>( data );
+                record->record_length   = UInt32( record_length );
+                record->key_length      = UInt32( key_length );
+                record->value_length    = UInt32( buffer.size() - key_length );
+                record->reserved        = 0;
+                record->entry_time      = element->second.first;
+
+                if ( !buffer.empty() ) std::memcpy( data + sizeof(SharedMapDumpRecord), &buffer[0], buffer.size() );
+            }
+        }
+
+        UInt64 offsets_offset = writer.getLength();
+
+        UInt8* data = writer.append( offsets.size() * sizeof(UInt64) );
+        if ( !data ) return false;
+        if ( !offsets.empty() ) std::memcpy( data, &offsets[0], offsets.size() * sizeof(UInt64) );
+
+        // header last: a dump with a valid header is complete
+        SharedMapDumpHeader* header = reinterpret_cast<SharedMapDumpHeader*>( writer.at( 0 ) );
+        std::memset( header, 0, sizeof(SharedMapDumpHeader) );
+
+        header->magic               = SharedMapDumpHeader::MAGIC;
+        header->version             = SharedMapDumpHeader::VERSION;
+        header->number_of_elements  = offsets.size();
+        header->offsets_offset      = offsets_offset;
+        header->file_size           = writer.getLength();
+
+        return writer.commit();
+    }
+
+    // --------------------------------------------------------------------------------------------------
+
+    template<class KEY_CLASS, class VALUE_CLASS>
+    bool SharedMap<KEY_CLASS, VALUE_CLASS>::loadFromBinaryFile( const std::string& map_dump_filename, size_t number_of_threads )
+    {
+        // records decoded by each thread at least
+        const size_t MIN_ELEMENTS_PER_THREAD = 4096;
+
+        // acquire back pointer to master
+        std::shared_ptr< MasterMap< KEY_CLASS, VALUE_CLASS > > master_map( m_master_map_back_ptr.lock() );
+
+        if (!master_map)
+        {
+            return false;
+        }
+
+        MultiKeyMap::SnapshotReader reader;
+        if ( !reader.open( map_dump_filename ) || reader.getSize() < sizeof(SharedMapDumpHeader) ) return false;
+
+        const SharedMapDumpHeader& header = *reinterpret_cast<const SharedMapDumpHeader*>( reader.getData() );
+
+        if (  header.magic != SharedMapDumpHeader::MAGIC
+           || header.version != SharedMapDumpHeader::VERSION
+           || header.file_size != reader.getSize()
+           || header.offsets_offset < sizeof(SharedMapDumpHeader)
+           || header.offsets_offset > header.file_size
+           || header.number_of_elements > ( header.file_size - header.offsets_offset ) / sizeof(UInt64) )
+        {
+            return false;
+        }
+
+        // DECODE entries (records split among threads, no lock)
+        size_t number_of_elements = size_t( header.number_of_elements );
+
+        std::vector< std::pair< KEY_CLASS, std::pair<UInt64, VALUE_CLASS> > > elements( number_of_elements );
+        std::vector<UInt8> decoded( number_of_elements, 0 );
+
+        if ( !number_of_threads ) number_of_threads = std::thread::hardware_concurrency();
+        if ( number_of_threads > number_of_elements / MIN_ELEMENTS_PER_THREAD ) number_of_threads = number_of_elements / MIN_ELEMENTS_PER_THREAD;
+        if ( !number_of_threads ) number_of_threads = 1;
+
+        std::atomic<bool> valid( true );
+        std::vector<std::thread> threads;
+
+        for ( size_t i = 0; i < number_of_threads; ++i )
+        {
+            size_t begin = number_of_elements * i / number_of_threads;
+            size_t end   = number_of_elements * ( i + 1 ) / number_of_threads;
+
+            threads.push_back( std::thread( [&reader, &header, &elements, &decoded, &valid, begin, end]()
+            {
+                const UInt64* offsets = reinterpret_cast<const UInt64*>( reader.getData() + header.offsets_offset );
+
+                for ( size_t element = begin; element < end; ++element )
+                {
+                    UInt64 offset = offsets[element];
+                    // offsets are read from the file: bounds are checked by subtraction, a sum could wrap
+                    if (  offset < sizeof(SharedMapDumpHeader) || ( offset & 7 )
+                       || header.offsets_offset < sizeof(SharedMapDumpRecord)
+                       || offset > header.offsets_offset - sizeof(SharedMapDumpRecord) )
+                    {
+                        valid = false;
+                        return;
+                    }
+
+                    const UInt8* data = reader.getData() + offset;
+                    const SharedMapDumpRecord& record = *reinterpret_cast<const SharedMapDumpRecord*>( data );
+
+                    if (  record.record_length > header.offsets_offset - offset
+                       || sizeof(SharedMapDumpRecord) + UInt64( record.key_length ) + record.value_length > record.record_length )
+                    {
+                        valid = false;
+                        return;
+                    }
+
+                    // entries that can not be decoded are skipped
+                    data += sizeof(SharedMapDumpRecord);
+
+                    if (  decodeDumpField( data, record.key_length, elements[element].first )
+                       && decodeDumpField( data + record.key_length, record.value_length, elements[element].second.second ) )
+                    {
+                        elements[element].second.first = record.entry_time;
+                        decoded[element] = 1;
+                    }
+                }
+            } ) );
+        }
+
+        for ( size_t i = 0; i < threads.size(); ++i ) threads[i].join();
+
+        if ( !valid ) return false;
+
+        // get a unique WRITE LOCK to MasterMap mutex ONCE for all the entries (no SharedMap and no SYNCH involved)
+        boost::unique_lock<boost::shared_mutex> master_map_write_lock( master_map->m_master_map_mutex );
+
+        master_map->m_data_map.reserve( master_map->m_data_map.size() + number_of_elements );
+
+        for ( size_t i = 0; i < number_of_elements; ++i )
+        {
+            if ( !decoded[i] ) continue;
+
+            // first try to insert as new element
+            std::pair<typename MapType::iterator, bool> rv = master_map->m_data_map.insert( elements[i] );
+            if (rv.second)
+            {
+                // it was a NEW ELEMENT
+                ++master_map->m_total_entries;
+                master_map->m_expiry_queue.push( rv.first->second.first, rv.first->first );
+                m_master_map_snapshot->setChanged( rv.first->first );
+
+                // if MapSet has a defined SET_EVENT delegate, run it
+                if (master_map->m_set_event_delegate != NULL)
+                {
+                    master_map->m_set_event_delegate( rv.first->first, rv.first->second.second );
+                }
+            }
+            else if ( elements[i].second.first > rv.first->second.first )
+            {
+                // UPDATE ELEMENT - update an existing element ONLY if the dumped one is newer
+                rv.first->second = elements[i].second;
+                master_map->m_expiry_queue.push( rv.first->second.first, rv.first->first );
+                m_master_map_snapshot->setChanged( rv.first->first );
+
+                // if MapSet has a defined UPDATE_EVENT delegate, run it
+                if (master_map->m_upd_event_delegate != NULL)
+                {
+                    master_map->m_upd_event_delegate( rv.first->first, rv.first->second.second );
+                }
+            }
+        }
+
+        // readers entering from now on find the loaded entries
+        m_master_map_snapshot->setPublishPending();
+        master_map->publishSnapshot( master_map_write_lock );
+
+        return true;
+    }
+
     // --------------------------------------------------------------------------------------------------
     //                                       *** MasterMap ***
     // --------------------------------------------------------------------------------------------------
@@ -477,13 +889,16 @@ namespace QAppNG
             // clear shared_map
             it->second->m_data_map.clear();
             it->second->m_deleted_data_map.clear();
+            it->second->m_synching_data_map.clear();
+            it->second->m_synching_deleted_data_map.clear();
 
             // decrease counter
             --m_total_shared_maps;
         }
 
-        // clear master data_map
+        // clear master data_map (shared maps still alive see it empty)
         m_data_map.clear();
+        if ( m_master_map_snapshot ) m_master_map_snapshot->clear();
 
         // clear map of shared maps
         m_per_thread_shared_maps.clear();
@@ -499,6 +914,9 @@ namespace QAppNG
 
         if ( !m_per_thread_shared_maps.count(thread_id) )
         {
+            // the MasterMap snapshot read by shared maps is created with the first one
+            if ( !m_master_map_snapshot ) m_master_map_snapshot.reset( new MasterMapSnapshot<MapType>() );
+
             // create new shared map
             SharedMapTypePtr per_thread_shared_map( new SharedMapType( this->shared_from_this(), m_virtual_timer_function ) );
 
@@ -514,76 +932,143 @@ namespace QAppNG
 
     // --------------------------------------------------------------------------------------------------
 
-    // called by SharedMapManager to sync master from shared maps
+    // called by SharedMapManager to sync master from shared maps (publish: do not wait for the publish interval)
     template<class KEY_CLASS, class VALUE_CLASS>
-    void MasterMap<KEY_CLASS, VALUE_CLASS>::synchMapset()
+    void MasterMap<KEY_CLASS, VALUE_CLASS>::synchMapset( bool publish )
     {
         // get a unique WRITE LOCK to MasterMap mutex
         boost::unique_lock<boost::shared_mutex> write_lock( m_master_map_mutex );
 
+        typedef typename SharedMapChangeLog<KEY_CLASS, VALUE_CLASS>::RecordVector RecordVector;
+
+        RecordVector records;
+        bool master_map_changed = false;
+
+        // SET records older than the last PURGE were purged from their SharedMap: they do not go to master map
+        UInt64 purged_time = 0;
+        UInt64 last_purge_max_age( static_cast<UInt64>(m_last_purge_max_age_seconds) << 32 );
+        if ( m_last_purge_max_age_seconds && m_last_purge_timestamp > last_purge_max_age ) purged_time = m_last_purge_timestamp - last_purge_max_age;
+
         // *iterate on shared_maps
         for ( typename std::unordered_map<UInt64, SharedMapTypePtr>::iterator it = m_per_thread_shared_maps.begin(); it != m_per_thread_shared_maps.end(); ++it )
         {
-            // first we must FREEZE the shared map before copy and delete
-            // get a unique WRITE LOCK to SharedMap mutex
-            boost::unique_lock<boost::shared_mutex> write_lock( it->second->m_shared_map_mutex );
-
-            // *iterate on elements to APPLY Insert and Update
-            for ( typename MapType::iterator element = it->second->m_data_map.begin(); element != it->second->m_data_map.end(); ++element )
             {
-                // first try to insert as new element
-                std::pair<typename MapType::iterator, bool> rv = m_data_map.insert( *element );
-                if (rv.second)
-                {
-                    // it was a NEW ELEMENT
-                    ++m_total_entries;
+                // get a unique WRITE LOCK to SharedMap mutex ONLY to take the changes done since last SYNCH (swaps):
+                // writers go on with an empty log while the changes are applied, readers find the local
+                // entries in the synching maps until the new MasterMap snapshot is published
+                boost::unique_lock<boost::shared_mutex> write_lock( it->second->m_shared_map_mutex );
 
-                    // if MapSet has a defined SET_EVENT delegate, run it
-                    if (m_set_event_delegate != NULL)
-                    {
-                        m_set_event_delegate( element->first, element->second.second );
-                    }
+                it->second->m_change_log.takeRecords( records );
+
+                if ( it->second->m_synching_data_map.empty() && it->second->m_synching_deleted_data_map.empty() )
+                {
+                    it->second->m_data_map.swap( it->second->m_synching_data_map );
+                    it->second->m_deleted_data_map.swap( it->second->m_synching_deleted_data_map );
                 }
                 else
                 {
-                    // UPDATE ELEMENT - update an existing element ONLY if the element in the shared is newer
-                    UInt64 shared_map_entry_time = element->second.first;
-                    UInt64 master_map_entry_time = m_data_map[element->first].first;
-
-                    if ( shared_map_entry_time > master_map_entry_time )
+                    // the changes of the previous SYNCHs are not published yet (publish interval): add these ones
+                    for ( typename MapType::const_iterator element = it->second->m_data_map.begin(); element != it->second->m_data_map.end(); ++element )
                     {
-                        m_data_map[element->first] = element->second;
+                        it->second->m_synching_data_map[ element->first ] = element->second;
+                    }
 
-                        // if MapSet has a defined UPDATE_EVENT delegate, run it
-                        if (m_upd_event_delegate != NULL)
-                        {
-                            m_upd_event_delegate( element->first, element->second.second );
-                        }
+                    for ( typename std::unordered_map<KEY_CLASS, bool>::const_iterator element = it->second->m_deleted_data_map.begin(); element != it->second->m_deleted_data_map.end(); ++element )
+                    {
+                        it->second->m_synching_deleted_data_map[ element->first ] = element->second;
+                        if ( element->second ) it->second->m_synching_data_map.erase( element->first );
                     }
+
+                    it->second->m_data_map.clear();
+                    it->second->m_deleted_data_map.clear();
                 }
             }
 
-            // APPLY Delete (iterate on m_deleted_data_map to apply logical delete to m_data_map)
-            for ( typename std::unordered_map<KEY_CLASS, bool>::iterator element = it->second->m_deleted_data_map.begin(); element != it->second->m_deleted_data_map.end(); ++element )
+            if ( !records.empty() ) master_map_changed = true;
+
+            // *iterate on records to APPLY Insert, Update, Delete and Touch (one record per key changed in the SharedMap)
+            for ( typename RecordVector::const_iterator record = records.begin(); record != records.end(); ++record )
             {
-                if ( element->second )
+                switch ( record->type )
                 {
-                    // if MapSet has a defined DELETE_EVENT delegate, run it (we run event before deleting element)
-                    if (m_del_event_delegate != NULL)
+                    case SharedMapChangeLog<KEY_CLASS, VALUE_CLASS>::SET_RECORD:
                     {
-                        m_del_event_delegate( element->first, m_data_map[element->first].second );
+                        if ( record->time < purged_time ) break;
+
+                        // first try to insert as new element
+                        std::pair<typename MapType::iterator, bool> rv = m_data_map.insert( std::make_pair( record->key, std::make_pair( record->time, record->value ) ) );
+                        if (rv.second)
+                        {
+                            // it was a NEW ELEMENT
+                            ++m_total_entries;
+                            m_expiry_queue.push( record->time, record->key );
+                            m_master_map_snapshot->setChanged( record->key );
+
+                            // if MapSet has a defined SET_EVENT delegate, run it
+                            if (m_set_event_delegate != NULL)
+                            {
+                                m_set_event_delegate( rv.first->first, rv.first->second.second );
+                            }
+                        }
+                        else if ( record->time >= rv.first->second.first )
+                        {
+                            // UPDATE ELEMENT - update an existing element ONLY if the element in the shared is not older:
+                            // with the same time the last SYNCHed SET wins (a SET done in the same clock tick after a
+                            // SYNCH, or with no virtual timer at all, was dropped when only newer elements were applied)
+                            if ( record->time != rv.first->second.first ) m_expiry_queue.push( record->time, record->key );
+                            rv.first->second = std::make_pair( record->time, record->value );
+                            m_master_map_snapshot->setChanged( record->key );
+
+                            // if MapSet has a defined UPDATE_EVENT delegate, run it
+                            if (m_upd_event_delegate != NULL)
+                            {
+                                m_upd_event_delegate( rv.first->first, rv.first->second.second );
+                            }
+                        }
+                        break;
                     }
 
-                    m_data_map.erase( element->first );
-                    --m_total_entries;
+                    case SharedMapChangeLog<KEY_CLASS, VALUE_CLASS>::DEL_RECORD:
+                    {
+                        typename MapType::iterator element = m_data_map.find( record->key );
+                        if ( element != m_data_map.end() )
+                        {
+                            // if MapSet has a defined DELETE_EVENT delegate, run it (we run event before deleting element)
+                            if (m_del_event_delegate != NULL)
+                            {
+                                m_del_event_delegate( element->first, element->second.second );
+                            }
+
+                            m_data_map.erase( element );
+                            --m_total_entries;
+                            m_master_map_snapshot->setChanged( record->key );
+                        }
+                        break;
+                    }
+
+                    case SharedMapChangeLog<KEY_CLASS, VALUE_CLASS>::TOUCH_RECORD:
+                    {
+                        typename MapType::iterator element = m_data_map.find( record->key );
+                        if ( element != m_data_map.end() && record->time > element->second.first )
+                        {
+                            element->second.first = record->time;
+                            m_expiry_queue.push( record->time, record->key );
+                            m_master_map_snapshot->setChanged( record->key );
+                        }
+                        break;
+                    }
                 }
             }
-
-            // clear the shared map (because we ported any add/delete/modify to master)
-            it->second->m_data_map.clear();
-            it->second->m_deleted_data_map.clear();
         }
 
+        // drop the stale entries of expiry queue (if they are too many)
+        m_expiry_queue.compact( m_data_map );
+
+        // readers entering from now on find the synched changes in the MasterMap snapshot (at most once per
+        // publish interval: until then each SharedMap keeps its own changes in the synching maps)
+        if ( master_map_changed ) m_master_map_snapshot->setPublishPending();
+        if ( m_master_map_snapshot && m_master_map_snapshot->isPublishPending() && ( publish || m_master_map_snapshot->isPublishDue() ) ) publishSnapshot( write_lock );
+
         // register last SYNCH timestamp
         m_last_synch_timestamp = m_virtual_timer_function();
 
@@ -593,49 +1078,113 @@ namespace QAppNG
 
     // --------------------------------------------------------------------------------------------------
 
+    // MasterMap write lock held: the changed keys are taken for a new snapshot, built with the lock released (only
+    // its shards with changed keys are copied), then the synching maps it covers are released. Locked again on return
+    template<class KEY_CLASS, class VALUE_CLASS>
+    void MasterMap<KEY_CLASS, VALUE_CLASS>::publishSnapshot( boost::unique_lock<boost::shared_mutex>& master_map_write_lock )
+    {
+        if ( !m_master_map_snapshot ) return;
+
+        typename MasterMapSnapshot<MapType>::PublishBatch publish_batch;
+        m_master_map_snapshot->prepare( m_data_map, publish_batch );
+
+        // readers entering from now on find the synched changes in the MasterMap snapshot. Meanwhile SharedMap
+        // readers go on with the previous snapshot and the synching maps, SYNCH and PURGE with the MasterMap
+        master_map_write_lock.unlock();
+        m_master_map_snapshot->publish( publish_batch );
+        master_map_write_lock.lock();
+
+        // the synching maps have changes of a SYNCH done meanwhile: they are released by its publication
+        if ( m_master_map_snapshot->getGeneration() != publish_batch.getGeneration() ) return;
+
+        // so the synching maps are not needed anymore
+        for ( typename std::unordered_map<UInt64, SharedMapTypePtr>::iterator it = m_per_thread_shared_maps.begin(); it != m_per_thread_shared_maps.end(); ++it )
+        {
+            MapType                                 synched_data_map;
+            std::unordered_map<KEY_CLASS, bool>     synched_deleted_data_map;
+
+            {
+                // get a unique WRITE LOCK to SharedMap mutex
+                boost::unique_lock<boost::shared_mutex> write_lock( it->second->m_shared_map_mutex );
+
+                it->second->m_synching_data_map.swap( synched_data_map );
+                it->second->m_synching_deleted_data_map.swap( synched_deleted_data_map );
+            }
+
+            // synched_data_map and synched_deleted_data_map are released here, out of SharedMap lock
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------
+
     template<class KEY_CLASS, class VALUE_CLASS>
     void MasterMap<KEY_CLASS, VALUE_CLASS>::purgeMapset( UInt64 now_time, UInt32 max_age_seconds )
     {
+        // entries popped from the expiry queue with a MasterMap lock (the lock is released between batches)
+        const size_t PURGE_BATCH_SIZE = 1024;
+
         // max age cannot be 0
         if (max_age_seconds == 0) return;
 
         // get max_age in UInt64 format
         UInt64 max_age( static_cast<UInt64>(max_age_seconds) << 32 );
 
-        // get a unique WRITE LOCK to MasterMap mutex
-        boost::unique_lock<boost::shared_mutex> master_map_write_lock( m_master_map_mutex );
+        bool master_map_changed = false;
+        bool purge_done = false;
 
-        // PURGE elements from MasterMap
-        for ( typename MapType::iterator element = m_data_map.begin(); element != m_data_map.end(); )
+        // PURGE elements from MasterMap: only the expired ones, oldest first
+        while ( !purge_done )
         {
-            // NB: element->second.first = age of the stored entry
-            UInt64 element_time( element->second.first );
+            // get a unique WRITE LOCK to MasterMap mutex
+            boost::unique_lock<boost::shared_mutex> master_map_write_lock( m_master_map_mutex );
 
-            // DEBUG
-            //UInt32 now_time_seconds = static_cast<UInt32>( now_time >> 32 );
-            //UInt32 element_time_seconds = static_cast<UInt32>( element_time >> 32 );
-            //UInt32 element_age_seconds = now_time_seconds - element_time_seconds;
-            // END DEBUG
-        
-            if ( now_time - element_time > max_age )
+            for ( size_t popped = 0; popped < PURGE_BATCH_SIZE; ++popped )
             {
-                // if MapSet has a defined DELETE_EVENT delegate, run it (we run event before deleting element)
-                if (m_del_event_delegate != NULL)
+                // NB: first = entry time of the queued key
+                if ( m_expiry_queue.empty() || now_time <= m_expiry_queue.top().first || now_time - m_expiry_queue.top().first <= max_age )
                 {
-                    m_del_event_delegate( element->first, m_data_map[element->first].second );
+                    purge_done = true;
+                    break;
                 }
 
-                m_data_map.erase( element++ );
-                --m_total_entries;
-                ++m_total_purged_elements;
+                typename MapType::iterator element = m_data_map.find( m_expiry_queue.top().second );
+
+                // stale entry: key updated, touched or deleted after it was queued
+                if ( element != m_data_map.end() && element->second.first == m_expiry_queue.top().first )
+                {
+                    // if MapSet has a defined DELETE_EVENT delegate, run it (we run event before deleting element)
+                    if (m_del_event_delegate != NULL)
+                    {
+                        m_del_event_delegate( element->first, element->second.second );
+                    }
+
+                    m_master_map_snapshot->setChanged( element->first );
+                    m_data_map.erase( element );
+                    --m_total_entries;
+                    ++m_total_purged_elements;
+
+                    master_map_changed = true;
+                }
+
+                m_expiry_queue.pop();
             }
-            else
+
+            if ( !purge_done )
             {
-                element++;
+                // let readers and SYNCH in before next batch
+                master_map_write_lock.unlock();
+                std::this_thread::yield();
             }
         }
 
-        // PURGE elements from all SharedMaps
+        // get a unique WRITE LOCK to MasterMap mutex
+        boost::unique_lock<boost::shared_mutex> master_map_write_lock( m_master_map_mutex );
+
+        // readers entering from now on do not find the purged elements (PURGE does not wait for the publish interval)
+        if ( master_map_changed ) m_master_map_snapshot->setPublishPending();
+        if ( m_master_map_snapshot && m_master_map_snapshot->isPublishPending() ) publishSnapshot( master_map_write_lock );
+
+        // PURGE elements from all SharedMaps (NB: only the changes done since last SYNCH are there)
         for ( typename std::unordered_map<UInt64, SharedMapTypePtr>::iterator it = m_per_thread_shared_maps.begin(); it != m_per_thread_shared_maps.end(); ++it )
         {
             // get a unique WRITE LOCK to SharedMap mutex
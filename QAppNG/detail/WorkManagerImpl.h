@@ -10,6 +10,15 @@
 * #????       A. Della Villa                                                   Oct-2008      Original development
 * #4331       A. Della Villa                                                   Nov-2009      WorkManager version 2.0
 * #5536       A. Della Villa                                                   Dec-2010      New user-defined routing policy
+* #user-028   QAppNG Team                                                      Oct-2026      Elastic pools
+* #user-029   QAppNG Team                                                      Oct-2026      Lookup free add consumable for WorkHandle
+* #user-031   QAppNG Team                                                      Oct-2026      Pipeline stage fusion
+* #user-032   QAppNG Team                                                      Oct-2026      Priority lane
+* #user-033   QAppNG Team                                                      Oct-2026      Broadcast channel
+* #user-034   QAppNG Team                                                      Oct-2026      Telemetry and drop reasons
+* #user-035   QAppNG Team                                                      Oct-2026      Power of two choices automatic routing
+* #user-036   QAppNG Team                                                      Oct-2026      Session preserving load shedding
+* #user-037   QAppNG Team                                                      Oct-2026      Disk spill of overflow consumables
 *
 * @endhistory
 * ===================================================================================================================
@@ -55,6 +64,88 @@ namespace QAppNG
         // set work_name
         work_data->work_name = work_name;
 
+        // elastic pool: only TrivialThreadPool with ConsistentHash routing can be resized (RoutingMap routes are learned,
+        // spilled consumables keep the worker they were routed to)
+        if ( work_data->work_type != WorkDataClass::TrivialThreadPool || work_data->routing_policy != WorkDataClass::ConsistentHash
+            || work_data->overload_strategy == WorkDataClass::Spill )
+        {
+            work_data->min_number_of_workers = work_data->number_of_workers;
+            work_data->max_number_of_workers = work_data->number_of_workers;
+        }
+
+        if ( !work_data->min_number_of_workers || work_data->min_number_of_workers > work_data->number_of_workers )
+            work_data->min_number_of_workers = work_data->number_of_workers;
+
+        if ( work_data->max_number_of_workers < work_data->number_of_workers )
+            work_data->max_number_of_workers = work_data->number_of_workers;
+
+        work_data->elastic                                  = work_data->max_number_of_workers > work_data->min_number_of_workers;
+        work_data->requested_number_of_workers.store( work_data->number_of_workers, std::memory_order_release );
+        work_data->thread_data_setup.max_number_of_workers  = work_data->max_number_of_workers;
+        work_data->autoscaling_last_check                   = std::chrono::steady_clock::now();
+
+        // stage fusion: fused workers are set up like pool workers, so only not elastic TrivialThreadPool works can be fused
+        work_data->fused = !work_data->fused_into.empty() && work_data->work_type == WorkDataClass::TrivialThreadPool && !work_data->elastic;
+
+        if ( work_data->fused )
+        {
+            work_data->fused_stage_slots.assign( ThreadCounter::MAX_NUMBER_OF_THREADS, WorkDataClass::FusedStageSlot() );
+        }
+        else
+        {
+            work_data->fused_into.clear();
+        }
+
+        // create user defined routing structures (the router depends on the corrected number_of_workers)
+        work_data->routing_map.reset( new std::unordered_map<UInt64, UInt64>() );
+        work_data->routing_router.reset( new ConsistentHashRouter( work_data->number_of_workers
+            , work_data->hot_key_rebalancing && work_data->work_type == WorkDataClass::TrivialThreadPool && work_data->overload_strategy != WorkDataClass::Spill
+            , work_data->rebalancing_window ) );
+
+        // Shed overload strategy: shed fraction controller (TrivialThreadPool only, there is no queue otherwise)
+        work_data->load_shedder.reset();
+        if ( work_data->overload_strategy == WorkDataClass::Shed && work_data->work_type == WorkDataClass::TrivialThreadPool )
+        {
+            work_data->load_shedder.reset( new SessionLoadShedder( work_data->shed_high_queue_fill, work_data->shed_low_queue_fill
+                , work_data->shed_fraction_step, work_data->shed_interval_msec ) );
+        }
+
+        // Spill overload strategy: spill file (TrivialThreadPool only, there is no queue otherwise)
+        work_data->spill.reset();
+        work_data->spill_flusher = std::function<void()>();
+        if ( work_data->overload_strategy == WorkDataClass::Spill && work_data->work_type == WorkDataClass::TrivialThreadPool )
+        {
+            if ( !std::is_base_of<QObservable, WORK_CONSUMABLE_CLASS>::value )
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Spill overload strategy in work:"<<work_name<<" needs consumables derived from QObservable";
+                throw std::runtime_error(errorStr.str());
+            }
+
+            // without decoder nothing could be given back from the file: Spill would silently be Drop
+            std::unordered_map<std::string, std::pair< std::type_index, std::shared_ptr<void> > >::iterator decoder = spill_decoders.find( work_name );
+            if ( decoder == spill_decoders.end() || decoder->second.first != std::type_index( typeid(WORK_CONSUMABLE_CLASS) ) )
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Spill overload strategy in work:"<<work_name<<" needs a spill decoder of its consumables (setSpillDecoder before startWork)";
+                throw std::runtime_error(errorStr.str());
+            }
+
+            std::string spill_file_name( work_data->spill_file.empty() ? work_name + ".spill" : work_data->spill_file );
+
+            ConsumableSpillFile<WORK_CONSUMABLE_CLASS>* spill( new ConsumableSpillFile<WORK_CONSUMABLE_CLASS>() );
+            work_data->spill.reset( spill );
+            spill->setDecoder( *static_cast< const typename ConsumableSpillFile<WORK_CONSUMABLE_CLASS>::DecoderType* >( decoder->second.second.get() ) );
+
+            if ( !spill->open( spill_file_name, UInt64( work_data->spill_file_size_mb ) << 20 ) )
+            {
+                std::ostringstream errorStr;
+                errorStr<<"Cannot create spill file:"<<spill_file_name<<" ("<<work_data->spill_file_size_mb<<" MB) of work:"<<work_name
+                        <<". It must not exist (set spill_file to a path used only by this work)";
+                throw std::runtime_error(errorStr.str());
+            }
+        }
+
         // STORE a copy of shared pointer to work in works_map (SLOW LOOKUP) and works_vector (FAST LOOKUP)
         works_map.insert( std::make_pair( work_name, work_data ) );
         assert( work_vector_element_counter < MAX_NUMBER_OF_WORK );
@@ -65,21 +156,26 @@ namespace QAppNG
         // SET WORK UNIQUE ID (used for fast work lookup)
         //work_data->work_unique_id = works_vector.size() - 1;
 
-        // INIT per_thread_data
+        // INIT per_thread_data (one slot for each worker the pool may have)
         work_data->per_thread_assigned.reset(        new std::vector<UInt64>() );
         work_data->per_thread_consumed.reset(        new std::vector<UInt64>() );
         work_data->per_thread_number_of_calls.reset( new std::vector<UInt64>() );
         work_data->per_thread_last_sleep_msec.reset( new std::vector<UInt64>() );
         work_data->consumer_TIDs.reset(              new std::vector<UInt64>() );
-        for ( size_t i = 0; i < work_data->number_of_workers; i++ )
+        work_data->consumer_cpu_affinity.reset(      new std::vector<std::string>() );
+        for ( size_t i = 0; i < work_data->max_number_of_workers; i++ )
         {
             work_data->per_thread_assigned->push_back(0);
             work_data->per_thread_consumed->push_back(0);
             work_data->per_thread_number_of_calls->push_back(0);
             work_data->per_thread_last_sleep_msec->push_back(0);
             work_data->consumer_TIDs->push_back(0);
+            work_data->consumer_cpu_affinity->push_back("-");
         }
 
+        // TELEMETRY (written by the pool, see WorkTelemetry)
+        work_data->telemetry.reset( new WorkTelemetry( work_data->max_number_of_workers ) );
+
         switch ( work_data->work_type )
         {
 
@@ -111,6 +207,8 @@ namespace QAppNG
                 write_back_data->per_thread_number_of_calls = work_data->per_thread_number_of_calls;
                 write_back_data->per_thread_last_sleep_msec = work_data->per_thread_last_sleep_msec;
                 write_back_data->consumer_TIDs              = work_data->consumer_TIDs;
+                write_back_data->consumer_cpu_affinity      = work_data->consumer_cpu_affinity;
+                write_back_data->telemetry                  = work_data->telemetry;
 
                 // Create & Start TrivialThreadPool
                 std::shared_ptr< TrivialThreadPool< std::shared_ptr< WORK_CONSUMABLE_CLASS >, WORK_CLASS> > TRIVIAL_THREAD_POOL
@@ -122,6 +220,49 @@ namespace QAppNG
 
                 // Store TrivialThreadPool Destroyer Method pointer
                 work_data->thread_pool_destroyer = fastdelegate::MakeDelegate(TRIVIAL_THREAD_POOL.get(), &TrivialThreadPool< std::shared_ptr< WORK_CONSUMABLE_CLASS >, WORK_CLASS>::stopThreadPool);
+
+                // Store Routing Handover Flusher (weak: work_data owns it)
+                if ( work_data->routing_router->isHotKeyRebalancingEnabled() || work_data->elastic )
+                {
+                    std::weak_ptr<WorkDataClass> weak_work_data( work_data );
+
+                    work_data->routing_handover_flusher = [this, weak_work_data]()
+                    {
+                        std::shared_ptr<WorkDataClass> locked_work_data( weak_work_data.lock() );
+                        if ( !locked_work_data ) return;
+
+                        std::vector< ConsistentHashRouter::ParkedConsumable > released_consumables;
+
+                        if ( locked_work_data->routing_router->abortParking( released_consumables ) )
+                        {
+                            __addReleasedConsumables<WORK_CONSUMABLE_CLASS, WORK_CLASS>( locked_work_data, released_consumables );
+                        }
+                    };
+                }
+
+                // Store Spill Flusher: spilled consumables are given to the workers (waiting for place) before stopping
+                if ( work_data->spill )
+                {
+                    std::weak_ptr<WorkDataClass> weak_work_data( work_data );
+
+                    // Spill Drainer: gives spilled consumables back also while the producer is idle. The work owns it
+                    // and deletes it before thread_pool and spill, so the plain pointer is valid while it runs
+                    WorkDataClass* drained_work_data( work_data.get() );
+
+                    work_data->spill_drainer.reset( new SpillDrainer( [this, drained_work_data]()
+                    {
+                        __drainSpill<WORK_CONSUMABLE_CLASS, WORK_CLASS>( *drained_work_data, ~UInt64(0) );
+                    }, work_data->spill_drain_interval_msec ) );
+
+                    work_data->spill_flusher = [this, weak_work_data]()
+                    {
+                        std::shared_ptr<WorkDataClass> locked_work_data( weak_work_data.lock() );
+                        if ( !locked_work_data ) return;
+
+                        locked_work_data->spill_drainer->stop();
+                        __drainSpill<WORK_CONSUMABLE_CLASS, WORK_CLASS>( *locked_work_data, ~UInt64(0), true );
+                    };
+                }
                 break;
             }
 
@@ -133,17 +274,462 @@ namespace QAppNG
 
         } // end switch
 
+        // STAGE FUSION: link fused works to their upstream work once both are started (producers do not use works_map)
+        if ( work_data->fused )
+        {
+            std::unordered_map<std::string, std::shared_ptr<WorkDataClass> >::iterator upstream = works_map.find( work_data->fused_into );
+            if ( upstream != works_map.end() ) std::atomic_store( &work_data->fused_upstream, upstream->second );
+        }
+
+        for ( std::unordered_map<std::string, std::shared_ptr<WorkDataClass> >::iterator it = works_map.begin(); it != works_map.end(); ++it )
+        {
+            if ( it->second->fused && it->second->fused_into == work_name ) std::atomic_store( &it->second->fused_upstream, work_data );
+        }
+
         return true;
     }; // END of __startWork(...)
 
 
+    //____________________________________________________________________________________________________________
+    // AUTOMATIC ROUTING IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    bool WorkManager::__addConsumableWithAutomaticRouting( std::shared_ptr<WorkDataClass>& work_data
+        , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+        , bool priority )
+    {
+        // stage fusion: called by a worker of the upstream work, run it here (before touching producer side data)
+        bool work_done;
+        if ( work_data->fused && __runFusedStage<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, work_done ) ) return work_done;
+
+        // elastic pool: apply pending resize (producer thread only)
+        if ( work_data->elastic ) __updateElasticPool<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data );
+
+        // Shed strategy: priority consumables are never shed
+        if ( !priority && work_data->load_shedder && __shedConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, false, 0 ) ) return false;
+
+        // only a TrivialThreadPool work has a pool to route on (No_MultiThread holds a FicticiousWorker,
+        // Disabled has no pool and no workers): the other work types ignore the thread key
+        UInt64 automatic_routing_thread_key(0);
+
+        if ( work_data->work_type == WorkDataClass::TrivialThreadPool )
+        {
+            // the pool type is known at compile time: no shared pointer copy
+            TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* thread_pool
+                = static_cast< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* >( work_data->thread_pool.get() );
+
+            // priority consumables are not counted by the pool total assigned: they cycle workers on their own counter.
+            // Normal ones follow the pool automatic routing (round robin or power of two choices)
+            automatic_routing_thread_key = priority ? work_data->priority_produced % work_data->number_of_workers : thread_pool->getAutomaticThreadKey();
+        }
+
+        // Call method: __addConsumable specifying Automatic Consumable Routing
+        return __addConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, eAutomaticRouting, automatic_routing_thread_key, priority );
+    }; // END of __addConsumableWithAutomaticRouting(...)
+
+    //____________________________________________________________________________________________________________
+    // USER DEFINED ROUTING IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    bool WorkManager::__addConsumableWithUserDefinedRouting( std::shared_ptr<WorkDataClass>& work_data
+        , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+        , UInt64 user_defined_routing_key, bool broadcast
+        , bool priority )
+    {
+        UInt64 thread_key;
+
+        // the following assert is not needed if no routing key is used
+        assert( work_data->number_of_workers );
+
+        // stage fusion: called by a worker of the upstream work, run it here (the upstream routed the same key)
+        // broadcasts go through the pool: they must reach all workers
+        bool work_done;
+        if ( work_data->fused && !broadcast && __runFusedStage<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, work_done ) ) return work_done;
+
+        // elastic pool: apply pending resize (producer thread only)
+        if ( work_data->elastic ) __updateElasticPool<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data );
+
+        // Shed strategy: shed before routing, so a shed session does not count for hot keys nor learns a route
+        if ( !broadcast && !priority && work_data->load_shedder
+            && __shedConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, true, user_defined_routing_key ) ) return false;
+
+        if ( !broadcast && priority && work_data->routing_policy == WorkDataClass::ConsistentHash )
+        {
+            // priority consumables overtake normal ones anyway: they follow the current route and are never parked
+            thread_key = work_data->routing_router->getThreadKey( user_defined_routing_key );
+        }
+        else if (!broadcast)
+        {
+            thread_key = __getUserDefinedThreadKey<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, user_defined_routing_key );
+
+            // consumable parked by hot key rebalancing: it will be added when its key handover ends
+            if ( thread_key == ConsistentHashRouter::PARKING_THREAD_KEY ) return true;
+
+            // resize parking full (Drop overload strategy)
+            if ( thread_key == ConsistentHashRouter::DROPPED_THREAD_KEY )
+            {
+                ++work_data->dropped_parking_full;
+                ++work_data->dropped;
+                return false;
+            }
+        }
+        else
+        {
+            // A broadcast event is routed by threadId
+            thread_key = user_defined_routing_key;
+
+            // elastic pool: the worker may have been removed meanwhile
+            if ( thread_key >= work_data->number_of_workers )
+            {
+                ++work_data->dropped_removed_worker;
+                ++work_data->dropped;
+                return false;
+            }
+        }
+
+        // Call method: __addConsumable using thred_key calculated from user_defined_routing_key
+        return __addConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, eUserDefinedRouting, thread_key, priority );
+    }; // END of __addConsumableWithUserDefinedRouting(...)
+
+    //____________________________________________________________________________________________________________
+    // USER DEFINED ROUTING KEY IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    UInt64 WorkManager::__getUserDefinedThreadKey( std::shared_ptr<WorkDataClass>& work_data
+        , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+        , UInt64 user_defined_routing_key )
+    {
+        if ( work_data->routing_policy == WorkDataClass::ConsistentHash )
+        {
+            ConsistentHashRouter& router = *work_data->routing_router;
+
+            if ( !router.needsPool() )
+            {
+                return router.getThreadKey( user_defined_routing_key );
+            }
+
+            // rebalancing and resize need per worker counters from the pool
+            TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >& thread_pool
+                = *static_cast< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* >( work_data->thread_pool.get() );
+
+            std::vector< ConsistentHashRouter::ParkedConsumable > released_consumables;
+
+            // SAFE POINTs reached: parked consumables go first, to the new worker of their key
+            if ( router.releaseParked( thread_pool, released_consumables ) )
+            {
+                __addReleasedConsumables<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, released_consumables );
+            }
+
+            UInt64 thread_key = router.getThreadKey( user_defined_routing_key, thread_pool );
+
+            if ( thread_key == ConsistentHashRouter::PARKING_THREAD_KEY && !router.park( user_defined_routing_key, work_consumable ) )
+            {
+                if ( router.isResizing() )
+                {
+                    // resize parking full: Drop drops at once, the other strategies never drop and wait (as on a full
+                    // queue) for the next previous worker at its SAFE POINT
+                    if ( work_data->overload_strategy == WorkDataClass::Drop ) return ConsistentHashRouter::DROPPED_THREAD_KEY;
+
+                    do
+                    {
+                        std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+
+                        if ( router.releaseParked( thread_pool, released_consumables ) )
+                        {
+                            __addReleasedConsumables<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, released_consumables );
+                        }
+
+                        thread_key = router.getThreadKey( user_defined_routing_key, thread_pool );
+                    }
+                    while ( thread_key == ConsistentHashRouter::PARKING_THREAD_KEY && !router.park( user_defined_routing_key, work_consumable ) );
+                }
+                else
+                {
+                    // hot key parking full: abort handover, parked consumables go back (in order) to the old worker
+                    if ( router.abortHandover( released_consumables ) )
+                    {
+                        __addReleasedConsumables<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, released_consumables );
+                    }
+
+                    thread_key = router.getThreadKey( user_defined_routing_key, thread_pool );
+                }
+            }
+
+            return thread_key;
+        }
+
+        // OLD Map-Based routing policy
+        if ( !work_data->routing_map->count(user_defined_routing_key) )
+        {
+            // #10650: We reached Maximum number of routing paths.
+            // An exception is thrown to notify we are having too many routing keys
+            // for any WORK_CONSUMABLE_CLASS
+            if( work_data->routing_map->size() > MAX_NUMBER_OF_ROUTING_PATHS )
+            {
+                std::ostringstream error_message;
+                error_message << "WorkManager - Maximum Number Of Routing Path Exceeded - "
+                              << "Work Name: " << work_data->work_name;
+
+                throw std::runtime_error( error_message.str().c_str() );
+            }
+
+            work_data->routing_map->insert( std::unordered_map< UInt64, UInt64 >::value_type
+                ( user_defined_routing_key, work_data->routing_map->size() % work_data->number_of_workers ) );
+        }
+
+        return work_data->routing_map->operator[]( user_defined_routing_key );
+    }; // END of __getUserDefinedThreadKey(...)
+
+    //____________________________________________________________________________________________________________
+    // RELEASED CONSUMABLES IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    void WorkManager::__addReleasedConsumables( std::shared_ptr<WorkDataClass>& work_data
+        , std::vector< ConsistentHashRouter::ParkedConsumable >& released_consumables )
+    {
+        for ( size_t i = 0; i < released_consumables.size(); ++i )
+        {
+            std::shared_ptr<WORK_CONSUMABLE_CLASS> work_consumable( std::static_pointer_cast<WORK_CONSUMABLE_CLASS>( released_consumables[i].consumable ) );
+
+            // overload strategy applies as for any other consumable
+            __addConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, eUserDefinedRouting, released_consumables[i].key );
+        }
+
+        released_consumables.clear();
+    }; // END of __addReleasedConsumables(...)
+
+    //____________________________________________________________________________________________________________
+    // ELASTIC POOL IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    void WorkManager::__updateElasticPool( std::shared_ptr<WorkDataClass>& work_data )
+    {
+        if ( work_data->current_work_state != WorkDataClass::eWorkRunning ) return;
+
+        TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >& thread_pool
+            = *static_cast< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* >( work_data->thread_pool.get() );
+
+        ConsistentHashRouter& router = *work_data->routing_router;
+
+        std::vector< ConsistentHashRouter::ParkedConsumable > released_consumables;
+
+        // 1- resize in progress: release keys whose previous worker is at its SAFE POINT (also when no keyed traffic)
+        if ( router.isResizing() )
+        {
+            if ( router.releaseParked( thread_pool, released_consumables ) )
+            {
+                __addReleasedConsumables<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, released_consumables );
+            }
+
+            if ( router.isResizing() ) return;
+        }
+
+        // 2- shrink completed: removed workers are drained and nothing is routed to them anymore
+        while ( thread_pool.getNumberOfWorkers() > work_data->number_of_workers )
+        {
+            thread_pool.removeLastWorker();
+        }
+
+        // 3- autoscaling: checked every 1024 consumables, evaluated every scaling_interval_msec
+        if ( work_data->autoscaling && ( ++work_data->autoscaling_counter & 0x3FF ) == 0 )
+        {
+            std::chrono::steady_clock::time_point now( std::chrono::steady_clock::now() );
+            UInt64 elapsed_usec = std::chrono::duration_cast<std::chrono::microseconds>( now - work_data->autoscaling_last_check ).count();
+
+            if ( elapsed_usec >= UInt64( work_data->scaling_interval_msec ) * 1000 )
+            {
+                // per worker counters: pool_total_consumed is refreshed only when worker 0 consumes
+                UInt64 cpu_usec = 0;
+                UInt64 used_queue = 0;
+                for ( UInt64 i = 0; i < work_data->number_of_workers; ++i )
+                {
+                    cpu_usec   += thread_pool.getThreadCpuTimeUsec( i );
+                    used_queue += thread_pool.getThreadAssigned( i ) - thread_pool.getThreadConsumed( i );
+                }
+
+                float queue_fill = float( used_queue ) / float( work_data->number_of_workers ) / float( work_data->thread_data_setup.max_queue_size );
+                float cpu_load   = float( cpu_usec - work_data->autoscaling_last_cpu_usec )
+                    / float( work_data->number_of_workers ) / float( elapsed_usec );
+
+                if ( ( queue_fill > work_data->scale_up_queue_fill || cpu_load > work_data->scale_up_cpu_load )
+                    && work_data->number_of_workers < work_data->max_number_of_workers )
+                {
+                    work_data->requested_number_of_workers.store( work_data->number_of_workers + 1, std::memory_order_release );
+                }
+                else if ( queue_fill < work_data->scale_down_queue_fill && cpu_load < work_data->scale_down_cpu_load
+                    && work_data->number_of_workers > work_data->min_number_of_workers )
+                {
+                    work_data->requested_number_of_workers.store( work_data->number_of_workers - 1, std::memory_order_release );
+                }
+
+                work_data->autoscaling_last_check    = now;
+                work_data->autoscaling_last_cpu_usec = cpu_usec;
+            }
+        }
+
+        // 4- apply requested number of workers
+        UInt32 number_of_workers( UInt32( work_data->requested_number_of_workers.load( std::memory_order_acquire ) ) );
+
+        if ( number_of_workers == work_data->number_of_workers ) return;
+
+        // hot key handover in progress: parked consumables go back to the old worker (still running)
+        if ( router.abortHandover( released_consumables ) )
+        {
+            __addReleasedConsumables<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, released_consumables );
+        }
+
+        // growing: new workers must run before they are routed
+        while ( thread_pool.getNumberOfWorkers() < number_of_workers && thread_pool.addWorker() );
+
+        if ( number_of_workers > thread_pool.getNumberOfWorkers() )
+        {
+            number_of_workers = UInt32( thread_pool.getNumberOfWorkers() );
+            work_data->requested_number_of_workers.store( number_of_workers, std::memory_order_release );
+        }
+
+        router.resize( number_of_workers, thread_pool );
+
+        // from now automatic routing and broadcast use the new number of workers
+        work_data->number_of_workers = number_of_workers;
+        ++work_data->number_of_resizes;
+
+        // CPU load baseline for the new set of workers
+        work_data->autoscaling_last_cpu_usec = 0;
+        for ( UInt64 i = 0; i < work_data->number_of_workers; ++i ) work_data->autoscaling_last_cpu_usec += thread_pool.getThreadCpuTimeUsec( i );
+        work_data->autoscaling_last_check = std::chrono::steady_clock::now();
+    }; // END of __updateElasticPool(...)
+
+    //____________________________________________________________________________________________________________
+    // STAGE FUSION IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    bool WorkManager::__runFusedStage( std::shared_ptr<WorkDataClass>& work_data
+        , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+        , bool& work_done )
+    {
+        size_t TID( QAppNG::ThreadCounter::Instance().getThreadId() );
+
+        if ( TID >= work_data->fused_stage_slots.size() ) return false;
+
+        WorkDataClass::FusedStageSlot& slot = work_data->fused_stage_slots[TID];
+
+        if ( slot.state == WorkDataClass::FusedStageSlot::eNotUpstreamWorker ) return false;
+
+        // first consumable added by this thread: check if it is an upstream worker (done once per thread)
+        if ( slot.state == WorkDataClass::FusedStageSlot::eUnknownThread )
+        {
+            std::shared_ptr<WorkDataClass> upstream( std::atomic_load( &work_data->fused_upstream ) );
+
+            // upstream work not started yet: try again next time
+            if ( !upstream ) return false;
+
+            WorkDataClass& upstream_data = *upstream;
+
+            slot.state = WorkDataClass::FusedStageSlot::eNotUpstreamWorker;
+
+            for ( size_t thread_key = 0; thread_key < upstream_data.number_of_workers; ++thread_key )
+            {
+                if ( upstream_data.consumer_TIDs->operator[](thread_key) == TID )
+                {
+                    // this thread gets its own worker, set up as the pool worker with the same thread key
+                    std::shared_ptr< WORK_CLASS > fused_worker( new WORK_CLASS() );
+
+                    fused_worker->m_thread_data.reset( new ThreadDataClass( work_data->thread_data_setup ) );
+                    fused_worker->m_thread_data->thread_key = thread_key;
+                    fused_worker->m_thread_data->thread_id  = std::this_thread::get_id();
+                    fused_worker->m_thread_data->is_running = true;
+
+                    slot.worker     = fused_worker;
+                    slot.thread_key = thread_key;
+                    slot.state      = WorkDataClass::FusedStageSlot::eUpstreamWorker;
+                    break;
+                }
+            }
+
+            if ( slot.state == WorkDataClass::FusedStageSlot::eNotUpstreamWorker ) return false;
+        }
+
+        // work stopped: the consumable is refused as it would be by the pool
+        if ( work_data->current_work_state != WorkDataClass::eWorkRunning )
+        {
+            work_done = false;
+            return true;
+        }
+
+        // do the work on the upstream worker thread
+        work_done = static_cast< WORK_CLASS* >( slot.worker.get() )->doWork( work_consumable, slot.thread_key );
+
+        ++slot.consumed;
+
+        return true;
+    }; // END of __runFusedStage(...)
+
+    //____________________________________________________________________________________________________________
+    // SHED STRATEGY IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    bool WorkManager::__shedConsumable( std::shared_ptr<WorkDataClass>& work_data
+        , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
+        , bool has_routing_key, UInt64 user_defined_routing_key )
+    {
+        if ( work_data->current_work_state != WorkDataClass::eWorkRunning ) return false;
+
+        TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >& thread_pool
+            = *static_cast< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* >( work_data->thread_pool.get() );
+
+        SessionLoadShedder& load_shedder = *work_data->load_shedder;
+
+        // the shed fraction is updated for all consumables, also the ones without session key
+        load_shedder.update( thread_pool, work_data->number_of_workers, work_data->thread_data_setup.max_queue_size );
+
+        // the context key is the session itself, the routing key may group several sessions (e.g. a cell)
+        UInt64 session_key( user_defined_routing_key );
+        if ( !__getSessionKey( work_consumable, session_key, std::is_base_of<QObservable, WORK_CONSUMABLE_CLASS>() ) && !has_routing_key ) return false;
+
+        if ( !load_shedder.isShed( session_key ) ) return false;
+
+        ++work_data->produced;
+        ++work_data->dropped_shed;
+        ++work_data->dropped;
+
+        return true;
+    }; // END of __shedConsumable(...)
+
+    //____________________________________________________________________________________________________________
+    // SPILL DRAIN IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    void WorkManager::__drainSpill( WorkDataClass& work_data, UInt64 max_to_drain, bool wait )
+    {
+        TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >& thread_pool
+            = *static_cast< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* >( work_data.thread_pool.get() );
+
+        ConsumableSpillFile<WORK_CONSUMABLE_CLASS>& spill = *static_cast< ConsumableSpillFile<WORK_CONSUMABLE_CLASS>* >( work_data.spill.get() );
+
+        for ( UInt64 drained = 0; drained < max_to_drain; ++drained )
+        {
+            const SpillRecord* record( spill.front() );
+            if ( !record ) break;
+
+            // FIFO: the oldest record waits for its worker, the next ones wait for it
+            UInt64 thread_key( record->thread_key );
+            if ( !wait && !thread_pool.hasPlaceInQueue( thread_key ) ) break;
+
+            std::shared_ptr<WORK_CONSUMABLE_CLASS> work_consumable( spill.decodeFront() );
+            spill.pop();
+
+            if ( work_consumable )
+            {
+                thread_pool.addConsumable( work_consumable, thread_key );
+            }
+            else
+            {
+                ++work_data.dropped_spill;
+                ++work_data.dropped;
+            }
+        }
+    }; // END of __drainSpill(...)
+
     //____________________________________________________________________________________________________________
     // ADD CONSUMABLE IMPLEMENTATION
     template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
     bool WorkManager::__addConsumable( std::shared_ptr<WorkDataClass>& work_data
         , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable
         , CurrentConsumableRouting routing_type
-        , UInt64 thread_key )
+        , UInt64 thread_key
+        , bool priority )
     {
         // DO NOT USE LOCK!!!
         // if the work is not in the running state we cannot add consumables
@@ -168,8 +754,8 @@ namespace QAppNG
             }
 
             // cast work_data->thread_pool pointer to FicticiousWorker< WORK_CLASS >
-            std::shared_ptr< FicticiousWorker< WORK_CLASS > > NO_MULTITHREAD_WORKER
-                = std::static_pointer_cast< FicticiousWorker< WORK_CLASS > >( work_data->thread_pool );
+            FicticiousWorker< WORK_CLASS >* NO_MULTITHREAD_WORKER
+                = static_cast< FicticiousWorker< WORK_CLASS >* >( work_data->thread_pool.get() );
 
             // do the work
             bool work_done = NO_MULTITHREAD_WORKER->doWork( work_consumable, 0 );
@@ -182,9 +768,9 @@ namespace QAppNG
 
         else if ( work_data->work_type == WorkDataClass::TrivialThreadPool )
         {//
-            // cast the pointer to get access to the pool
-            std::shared_ptr< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS > > thread_pool
-                = std::static_pointer_cast< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS > >(work_data->thread_pool);
+            // cast the pointer to get access to the pool (no shared pointer copy)
+            TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* thread_pool
+                = static_cast< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* >(work_data->thread_pool.get());
 
             // if there is place, enqueue the consumable. If there is no place and the overload_strategy
             // is Drop, drop the consumable (it is enough to not enter in the IF statement)
@@ -201,11 +787,61 @@ namespace QAppNG
             //}
 
             // ThreadPool Queues are default-BLOCKING, so we eneque a consumable it either Wait Policy is enabled or thread_pool.queue[thread_key] has place.
-            if ( work_data->overload_strategy == WorkDataClass::Wait || thread_pool->hasPlaceInQueue( thread_key ) )
+            // Shed Policy waits as Wait: consumables of shed sessions never get here
+            if ( priority )
+            {
+                // without a priority queue (priority_queue_size=0) the consumable goes in the normal queue, that the
+                // spill drainer thread writes too
+                std::unique_lock<std::mutex> spill_lock;
+                if ( work_data->spill ) spill_lock = std::unique_lock<std::mutex>( work_data->spill_drainer->getMutex() );
+
+                // PRIORITY LANE: same overload strategy, applied to the (small) priority queue
+                if ( work_data->overload_strategy != WorkDataClass::Drop || thread_pool->hasPlaceInPriorityQueue( thread_key ) )
+                {
+                    ++work_data->priority_produced;
+                    return thread_pool->addPriorityConsumable( work_consumable, thread_key );
+                }
+
+                ++work_data->dropped_priority_queue_full;
+            }
+            else if ( work_data->spill )
+            {
+                // the spill drainer thread writes the same queues and spill file
+                std::lock_guard<std::mutex> spill_lock( work_data->spill_drainer->getMutex() );
+
+                // SPILL: spilled consumables go first (drained by the next addConsumable calls when queues have place),
+                // this one is queued only if nothing is left in the spill file, otherwise it follows them in the file
+                if ( !work_data->spill->empty() ) __drainSpill<WORK_CONSUMABLE_CLASS, WORK_CLASS>( *work_data, MAX_SPILL_DRAIN_BURST );
+
+                if ( work_data->spill->empty() && thread_pool->hasPlaceInQueue( thread_key ) )
+                {
+                    return thread_pool->addConsumable( work_consumable, thread_key );
+                }
+
+                if ( static_cast< ConsumableSpillFile<WORK_CONSUMABLE_CLASS>* >( work_data->spill.get() )->push( work_consumable, thread_key ) )
+                {
+                    return true;
+                }
+
+                // the drainer counts its drops with the same lock
+                ++work_data->dropped_spill;
+                ++work_data->dropped;
+
+                return false;
+            }
+            else if ( work_data->overload_strategy != WorkDataClass::Drop || thread_pool->hasPlaceInQueue( thread_key ) )
             {
                 return thread_pool->addConsumable( work_consumable, thread_key );
             }
+            else
+            {
+                ++work_data->dropped_queue_full;
+            }
         }//
+        else
+        {
+            ++work_data->dropped_disabled;
+        }
 
         // no worker defined on consumable or DROP Policy enabled and no place in queue, we drop it
         ++work_data->dropped;
@@ -213,6 +849,61 @@ namespace QAppNG
         return false;
     }; // END of __addConsumable(...)
 
+    //____________________________________________________________________________________________________________
+    // BROADCAST IMPLEMENTATION
+    template <class WORK_CONSUMABLE_CLASS, class WORK_CLASS>
+    bool WorkManager::__broadcastConsumable( std::shared_ptr<WorkDataClass>& work_data
+        , std::shared_ptr<WORK_CONSUMABLE_CLASS>& work_consumable )
+    {
+        if ( work_data->current_work_state != WorkDataClass::eWorkRunning ) return false;
+
+        // no channel (or no pool): one consumable per worker, as routed consumables
+        if ( work_data->work_type != WorkDataClass::TrivialThreadPool || work_data->thread_data_setup.broadcast_queue_size == 0 )
+        {
+            if ( work_data->work_type == WorkDataClass::No_MultiThread )
+            {
+                return __addConsumable<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, eUserDefinedRouting, 0 );
+            }
+
+            bool all_added( true );
+            for ( UInt64 thread_key = 0; thread_key < work_data->number_of_workers; ++thread_key )
+            {
+                all_added &= __addConsumableWithUserDefinedRouting<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data, work_consumable, thread_key, true );
+            }
+
+            return all_added;
+        }
+
+        // elastic pool: apply pending resize (producer thread only)
+        if ( work_data->elastic ) __updateElasticPool<WORK_CONSUMABLE_CLASS, WORK_CLASS>( work_data );
+
+        if ( !work_data->producer_TID )
+        {
+            work_data->producer_TID = QAppNG::ThreadCounter::Instance().getThreadId();
+        }
+
+        TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* thread_pool
+            = static_cast< TrivialThreadPool< std::shared_ptr < WORK_CONSUMABLE_CLASS >, WORK_CLASS >* >( work_data->thread_pool.get() );
+
+        // counters as if one consumable per worker was added
+        UInt64 number_of_workers( thread_pool->getNumberOfWorkers() );
+
+        work_data->produced += number_of_workers;
+
+        // BROADCAST CHANNEL: one write, whatever the number of workers
+        if ( work_data->overload_strategy != WorkDataClass::Drop || thread_pool->hasPlaceInBroadcastChannel() )
+        {
+            ++work_data->broadcast_produced;
+            return thread_pool->addBroadcastConsumable( work_consumable );
+        }
+
+        // DROP Policy enabled and the slowest worker is broadcast_queue_size broadcasts behind
+        work_data->dropped_broadcast_full += number_of_workers;
+        work_data->dropped                += number_of_workers;
+
+        return false;
+    }; // END of __broadcastConsumable(...)
+
     // --------------------------------------------------------------------------------------------------------
 }
 
@@ -0,0 +1,154 @@
+/** ===================================================================================================================
+* @file    MultiKeyMapAllocBench Cpp FILE
+*
+* @brief   allocations and time per inserted context: MultiKeyMap, MultiKeyMapEvo, MultiKeyMapEvo with SlabPool (and
+*          reserve). Every context is a value with two keys (UInt32, UInt64). Standalone program, not part of the
+*          project build; from the repository root:
+*
+*              g++ -std=c++11 -O2 -I./ bench/MultiKeyMapAllocBench.cpp -o MultiKeyMapAllocBench
+*              ./MultiKeyMapAllocBench [number_of_contexts]
+*
+*          Allocations are operator new calls made while inserting. SlabPool slabs are counted apart (slab
+*          allocations), they do not go through operator new. The last column is the number of slabs before and
+*          after purging half of the contexts.
+*
+* @copyright
+*
+* @history
+* REF#        Who                                                              When          What
+* #user-041   QAppNG Team                                                      Oct-2026      Original Development
+*
+* @endhistory
+* ===================================================================================================================
+*/
+
+#include <QAppNG/MultiKeyMap.h>
+#include <QAppNG/MultiKeyMapEvo.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using namespace QAppNG;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static size_t g_number_of_news = 0;
+
+void* operator new( size_t size )
+{
+    ++g_number_of_news;
+    void* ptr = std::malloc( size ? size : 1 );
+    if ( !ptr ) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete( void* ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+    struct OldValue : public MultiKeyMap::Value
+    {
+        UInt64 data[4];
+    };
+
+    struct EvoValue : public MultiKeyMap::ValueEvo<UInt32, UInt64>
+    {
+        UInt64 data[4];
+    };
+
+    typedef MultiKeyMap::MultiKeyMap< 2, std::shared_ptr<OldValue> > OldMap;
+    typedef MultiKeyMap::MultiKeyMapEvo< EvoValue, UInt32, UInt64 >  EvoMap;
+
+    // contexts are inserted over 100 seconds, purging at 150 with 100 seconds of inactivity erases the first half
+    const UInt32 INSERT_PERIOD_SEC = 100;
+
+    inline UInt32 insertTimeSec( UInt32 i, UInt32 number_of_contexts )
+    {
+        return 1 + UInt32( UInt64( i ) * INSERT_PERIOD_SEC / number_of_contexts );
+    }
+
+    inline double elapsedMsec( const std::chrono::steady_clock::time_point& start )
+    {
+        return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    //______________________________________________________________________________________________________
+    void benchMultiKeyMap( UInt32 number_of_contexts )
+    {
+        OldMap map;
+
+        size_t number_of_news = g_number_of_news;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for ( UInt32 i = 0; i < number_of_contexts; ++i )
+        {
+            std::shared_ptr<OldValue> value = std::make_shared<OldValue>();
+            map.insertElementByKey<0, UInt32>( i, value, insertTimeSec( i, number_of_contexts ) );
+            map.setKey<1, UInt64>( UInt64( i ) << 8, value );
+        }
+
+        double msec = elapsedMsec( start );
+
+        std::printf( "%-34s %10.4f %8.0f\n", "MultiKeyMap", double( g_number_of_news - number_of_news ) / number_of_contexts, msec );
+    }
+
+    //______________________________________________________________________________________________________
+    void benchMultiKeyMapEvo( UInt32 number_of_contexts, bool use_slab_pool, bool use_reserve )
+    {
+        EvoMap map( use_slab_pool );
+        if ( use_reserve ) map.reserve( number_of_contexts );
+
+        size_t number_of_news = g_number_of_news;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for ( UInt32 i = 0; i < number_of_contexts; ++i )
+        {
+            std::shared_ptr<EvoValue> value = map.createElement();
+            map.insertElementByKey<0>( i, value, insertTimeSec( i, number_of_contexts ) );
+            map.setKey<1>( UInt64( i ) << 8, value );
+        }
+
+        double msec = elapsedMsec( start );
+
+        const char* name = !use_slab_pool ? "MultiKeyMapEvo" : !use_reserve ? "MultiKeyMapEvo + SlabPool" : "MultiKeyMapEvo + SlabPool + reserve";
+        std::printf( "%-34s %10.4f %8.0f", name, double( g_number_of_news - number_of_news ) / number_of_contexts, msec );
+
+        if ( map.getSlabPool() )
+        {
+            const SlabPool& slab_pool = *map.getSlabPool();
+            size_t number_of_slabs = slab_pool.getNumberOfSlabs();
+            size_t number_of_slab_allocations = slab_pool.getNumberOfSlabAllocations();
+
+            map.purge( INSERT_PERIOD_SEC + INSERT_PERIOD_SEC / 2, INSERT_PERIOD_SEC );
+
+            std::printf( " %10.4f %8zu -> %zu", double( number_of_slab_allocations ) / number_of_contexts, number_of_slabs, slab_pool.getNumberOfSlabs() );
+        }
+
+        std::printf( "\n" );
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main( int argc, char* argv[] )
+{
+    UInt32 number_of_contexts = argc > 1 ? UInt32( std::strtoul( argv[1], NULL, 10 ) ) : 1000000;
+    if ( !number_of_contexts ) number_of_contexts = 1;
+
+    std::printf( "%u contexts, two keys each\n", number_of_contexts );
+    std::printf( "%-34s %10s %8s %10s %s\n", "", "allocs/ctx", "msec", "slabs/ctx", "slabs (purge half)" );
+
+    benchMultiKeyMap( number_of_contexts );
+    benchMultiKeyMapEvo( number_of_contexts, false, false );
+    benchMultiKeyMapEvo( number_of_contexts, true, false );
+    benchMultiKeyMapEvo( number_of_contexts, true, true );
+
+    return 0;
+}
@@ -38,17 +38,21 @@ OBJECTFILES= \
 	${OBJECTDIR}/QAppNG/CCassClient.o \
 	${OBJECTDIR}/QAppNG/Imsi.o \
 	${OBJECTDIR}/QAppNG/LightWeightSequencerEvo.o \
+	${OBJECTDIR}/QAppNG/MultiKeyMapSnapshot.o \
 	${OBJECTDIR}/QAppNG/PeriodicTimer.o \
 	${OBJECTDIR}/QAppNG/PipedProcess.o \
 	${OBJECTDIR}/QAppNG/QStatusManager.o \
 	${OBJECTDIR}/QAppNG/QVirtualClock.o \
+	${OBJECTDIR}/QAppNG/SharedMemorySegment.o \
 	${OBJECTDIR}/QAppNG/TablesHandler.o \
 	${OBJECTDIR}/QAppNG/TablesRenderer.o \
+	${OBJECTDIR}/QAppNG/ThreadAffinity.o \
 	${OBJECTDIR}/QAppNG/ThreadCounter.o \
 	${OBJECTDIR}/QAppNG/TicketsCommonMethods.o \
 	${OBJECTDIR}/QAppNG/TrivialCircularLockFreeQueueEvo.o \
 	${OBJECTDIR}/QAppNG/WorkManager.o \
 	${OBJECTDIR}/QAppNG/WorkManagerStatus.o \
+	${OBJECTDIR}/QAppNG/WorkOverload.o \
 	${OBJECTDIR}/QAppNG/nl_clockable_time.o \
 	${OBJECTDIR}/QAppNG/nl_osal.o \
 	${OBJECTDIR}/main.o \
@@ -94,6 +98,11 @@ ${OBJECTDIR}/QAppNG/LightWeightSequencerEvo.o: QAppNG/LightWeightSequencerEvo.cp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/QAppNG/LightWeightSequencerEvo.o QAppNG/LightWeightSequencerEvo.cpp
 
+${OBJECTDIR}/QAppNG/MultiKeyMapSnapshot.o: QAppNG/MultiKeyMapSnapshot.cpp 
+	${MKDIR} -p ${OBJECTDIR}/QAppNG
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/QAppNG/MultiKeyMapSnapshot.o QAppNG/MultiKeyMapSnapshot.cpp
+
 ${OBJECTDIR}/QAppNG/PeriodicTimer.o: QAppNG/PeriodicTimer.cpp 
 	${MKDIR} -p ${OBJECTDIR}/QAppNG
 	${RM} "$@.d"
@@ -114,6 +123,11 @@ ${OBJECTDIR}/QAppNG/QVirtualClock.o: QAppNG/QVirtualClock.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/QAppNG/QVirtualClock.o QAppNG/QVirtualClock.cpp
 
+${OBJECTDIR}/QAppNG/SharedMemorySegment.o: QAppNG/SharedMemorySegment.cpp 
+	${MKDIR} -p ${OBJECTDIR}/QAppNG
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/QAppNG/SharedMemorySegment.o QAppNG/SharedMemorySegment.cpp
+
 ${OBJECTDIR}/QAppNG/TablesHandler.o: QAppNG/TablesHandler.cpp 
 	${MKDIR} -p ${OBJECTDIR}/QAppNG
 	${RM} "$@.d"
@@ -124,6 +138,11 @@ ${OBJECTDIR}/QAppNG/TablesRenderer.o: QAppNG/TablesRenderer.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/QAppNG/TablesRenderer.o QAppNG/TablesRenderer.cpp
 
+${OBJECTDIR}/QAppNG/ThreadAffinity.o: QAppNG/ThreadAffinity.cpp 
+	${MKDIR} -p ${OBJECTDIR}/QAppNG
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/QAppNG/ThreadAffinity.o QAppNG/ThreadAffinity.cpp
+
 ${OBJECTDIR}/QAppNG/ThreadCounter.o: QAppNG/ThreadCounter.cpp 
 	${MKDIR} -p ${OBJECTDIR}/QAppNG
 	${RM} "$@.d"
@@ -149,6 +168,11 @@ ${OBJECTDIR}/QAppNG/WorkManagerStatus.o: QAppNG/WorkManagerStatus.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/QAppNG/WorkManagerStatus.o QAppNG/WorkManagerStatus.cpp
 
+${OBJECTDIR}/QAppNG/WorkOverload.o: QAppNG/WorkOverload.cpp 
+	${MKDIR} -p ${OBJECTDIR}/QAppNG
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/QAppNG/WorkOverload.o QAppNG/WorkOverload.cpp
+
 ${OBJECTDIR}/QAppNG/nl_clockable_time.o: QAppNG/nl_clockable_time.cpp 
 	${MKDIR} -p ${OBJECTDIR}/QAppNG
 	${RM} "$@.d"